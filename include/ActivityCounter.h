@@ -0,0 +1,49 @@
+// ActivityCounter.h
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <boost/json.hpp>
+
+// Per-tick record of how many activity-gated components actually ran, out of how
+// many could have, and how many were skipped because their energy was deferred.
+// Written once per tick by the stage that owns the components and read by the
+// StatsRegistry provider.
+class ActivityCounter {
+public:
+    void record(std::uint64_t active, std::uint64_t total, std::uint64_t deferred = 0)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ticks++;
+        lastActive = active;
+        lastTotal = total;
+        lastDeferred = deferred;
+        activeSum += active;
+        totalSum += total;
+        deferredSum += deferred;
+    }
+
+    boost::json::object toJson() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        boost::json::object entry;
+        entry["ticks"] = ticks;
+        entry["last_active"] = lastActive;
+        entry["last_total"] = lastTotal;
+        entry["last_active_fraction"] = lastTotal ? static_cast<double>(lastActive) / static_cast<double>(lastTotal) : 0.0;
+        entry["mean_active_fraction"] = totalSum ? static_cast<double>(activeSum) / static_cast<double>(totalSum) : 0.0;
+        entry["last_deferred"] = lastDeferred;
+        entry["mean_deferred_fraction"] = totalSum ? static_cast<double>(deferredSum) / static_cast<double>(totalSum) : 0.0;
+        return entry;
+    }
+
+private:
+    mutable std::mutex mutex;
+    std::uint64_t ticks = 0;
+    std::uint64_t lastActive = 0;
+    std::uint64_t lastTotal = 0;
+    std::uint64_t lastDeferred = 0;
+    std::uint64_t activeSum = 0;
+    std::uint64_t totalSum = 0;
+    std::uint64_t deferredSum = 0;
+};
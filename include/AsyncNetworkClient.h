@@ -2,39 +2,98 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <thread>
-#include <mutex>
 #include <functional>
 #include <string>
+#include <vector>
+#include "InstrumentedMutex.h"
 
+struct ClientWriteStatistics {
+    std::uint64_t framesQueued = 0;   // Accepted by send()
+    std::uint64_t framesSent = 0;     // Completely written to the socket
+    std::uint64_t bytesSent = 0;      // Including the length prefixes
+    std::uint64_t writes = 0;         // Gather-writes issued; framesSent / writes is the batching factor
+    std::uint64_t framesDropped = 0;  // Refused because the queue was full or the connection failed
+    std::uint64_t queuedBytesHighWater = 0;
+};
+
+// Client for length-prefixed messages (4-byte length in network byte order, then the
+// body). send() takes ownership of the message and queues it; one write at a time is
+// in flight, and everything queued while it runs goes out in the next one as a single
+// gather-write, so a burst of small frames costs one system call rather than one each.
+// Frames sent before the connection is up are held until it is.
+//
+// The queue, including the batch being written, is bounded by maxQueuedBytes: a
+// send() that would exceed it drops the frame and returns false, so a producer
+// outrunning the network sheds frames instead of growing without limit.
+//
+// Once the connection fails (connect error, write error or the server closing it)
+// every send() is dropped until connect() is called again, which starts over with an
+// empty queue. The statistics are cumulative across connections.
 class AsyncNetworkClient {
 public:
-    AsyncNetworkClient(const std::string& host, unsigned short port);
+    static constexpr std::size_t DEFAULT_MAX_QUEUED_BYTES = 16u * 1024u * 1024u;
+
+    AsyncNetworkClient(const std::string& host, unsigned short port,
+                       std::size_t maxQueuedBytes = DEFAULT_MAX_QUEUED_BYTES);
     ~AsyncNetworkClient();
 
+    // Starts connecting in the background; false only if that could not be started.
+    // Reconnects if called again.
     bool connect();
     void disconnect();
-    void send(const std::string& message);
+    bool isConnected() const { return connected.load(std::memory_order_acquire) && !hasFailed(); }
+    // The connection could not be made or was lost; connect() again to retry
+    bool hasFailed() const { return connectionFailed.load(std::memory_order_acquire); }
+    // Callable from any thread. Returns false if the frame was dropped.
+    bool send(std::string message);
     void setOnMessage(std::function<void(const std::string&)> callback);
 
+    ClientWriteStatistics getWriteStatistics() const;
+
 private:
     void doConnect();
     void doReadHeader();
     void doReadBody(std::size_t length);
-    void doWrite(const std::string& message);
+    void startWrite();
+    void doWrite();
+    void failConnection(const char* where, const boost::system::error_code& ec);
 
     std::string host;
     unsigned short port;
+    std::size_t maxQueuedBytes;
 
     boost::asio::io_context ioContext;
     std::unique_ptr<boost::asio::ip::tcp::socket> socket;
     std::unique_ptr<boost::asio::ip::tcp::resolver> resolver;
     std::thread ioThread;
 
-    std::mutex writeMutex;
+    // Frames waiting for the next write. The in-flight batch is only touched on the io
+    // thread; the two vectors are swapped rather than reallocated.
+    InstrumentedMutex writeMutex{"AsyncNetworkClient::writeMutex"};
+    std::vector<std::string> pendingFrames;
+    std::vector<std::uint32_t> pendingHeaders;
+    std::size_t pendingBytes = 0;
+    std::size_t inFlightBytes = 0;  // Still counted against maxQueuedBytes
+    // Written under writeMutex; atomic so the health getters need no lock
+    std::atomic<bool> connected{false};
+    std::atomic<bool> connectionFailed{false};
+    bool writeInFlight = false;
+    std::vector<std::string> writingFrames;
+    std::vector<std::uint32_t> writingHeaders;
+    std::vector<boost::asio::const_buffer> writeBuffers;
+
+    std::atomic<std::uint64_t> framesQueued{0};
+    std::atomic<std::uint64_t> framesSent{0};
+    std::atomic<std::uint64_t> bytesSent{0};
+    std::atomic<std::uint64_t> writes{0};
+    std::atomic<std::uint64_t> framesDropped{0};
+    std::atomic<std::uint64_t> queuedBytesHighWater{0};
+
     std::function<void(const std::string&)> onMessage;
 
     std::vector<char> readBuffer;
 };
-
@@ -2,46 +2,75 @@
 #pragma once
 
 #include <boost/asio.hpp>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 #include <mutex>
 #include <functional>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "InstrumentedMutex.h"
 
+// Server for length-prefixed messages (4-byte length in network byte order, then the
+// body). Connections are handed round-robin to a pool of io_contexts, each run by one
+// thread, so all of a session's reads, writes and callbacks happen on one thread and
+// the read path takes no lock. Each session reads into a buffer that only grows.
 class AsyncNetworkServer {
 public:
-    explicit AsyncNetworkServer(int port);
+    // Messages longer than this close the connection
+    static constexpr std::uint32_t MAX_MESSAGE_SIZE = 64u * 1024u * 1024u;
+
+    // threadCount 0 runs one io thread per hardware core
+    explicit AsyncNetworkServer(int port, std::size_t threadCount = 0);
     ~AsyncNetworkServer();
 
     bool initialise();
     bool start();
     void stop();
 
-    // Callback invoked when a complete message is received from a client
-    void setOnMessage(std::function<void(int, const std::string&)> callback);
+    // Callback invoked when a complete message is received from a client. It runs on
+    // that client's io thread, possibly concurrently with other clients' callbacks. The
+    // view points into the session's receive buffer and is valid only until it returns.
+    // Set before start().
+    void setOnMessage(std::function<void(int, std::string_view)> callback);
+    // Invoked once when a client's connection is closed. Set before start().
+    void setOnDisconnect(std::function<void(int)> callback);
+    // Invoked on each io thread, with its index, before it runs any handler; used to
+    // set the thread's CPU affinity and scheduling. Set before start().
+    void setOnThreadStart(std::function<void(std::size_t)> callback);
+
+    // Queue a length-prefixed message to one client; callable from any thread. With a
+    // nonzero maxQueuedBytes the message is dropped if the client's write queue, counted
+    // with the frame being written, would grow beyond it, so a stalled client cannot
+    // make the server buffer without limit. Returns false if the message was dropped or
+    // the client has disconnected.
+    bool send(int clientId, const std::string& message, std::size_t maxQueuedBytes = 0);
 
 private:
+    class Session;
+
     void doAccept();
-    void doRead(int clientId);
-    void doWrite(int clientId, const std::string& message);
     void closeClient(int clientId);
 
-    struct ClientSession {
-        std::shared_ptr<boost::asio::ip::tcp::socket> socket;
-        std::vector<char> buffer;
-        uint32_t expectedLength = 0;
-    };
-
     int port;
-    bool running = false;
+    std::size_t threadCount;
+    std::atomic<bool> running{false};
 
-    boost::asio::io_context ioContext;
+    // contexts[0] also runs the acceptor
+    std::vector<std::unique_ptr<boost::asio::io_context>> contexts;
+    std::vector<boost::asio::executor_work_guard<boost::asio::io_context::executor_type>> workGuards;
+    std::vector<std::thread> ioThreads;
     std::unique_ptr<boost::asio::ip::tcp::acceptor> acceptor;
-    std::thread ioThread;
-
-    std::mutex clientMutex;
-    std::unordered_map<int, ClientSession> clients;
-    std::function<void(int, const std::string&)> onMessage;
+    std::size_t nextContext = 0;  // Accept handler only
+    int nextClientId = 1;         // Accept handler only
 
-    int nextClientId = 1;
+    // Guards the client table for send() and disconnects; never taken while reading
+    InstrumentedMutex clientMutex{"AsyncNetworkServer::clientMutex"};
+    std::unordered_map<int, std::shared_ptr<Session>> clients;
+    std::function<void(int, std::string_view)> onMessage;
+    std::function<void(int)> onDisconnect;
+    std::function<void(std::size_t)> onThreadStart;
 };
@@ -7,7 +7,10 @@
 #include <thread>
 #include <string>
 #include <chrono>
+#include <cstdint>
 #include "AsyncNetworkClient.h"
+#include "ProcessorMetrics.h"
+#include "StimulusChannel.h"
 #include "StimuliData.h"
 #include "ThreadSafeQueue.h"
 
@@ -24,18 +27,28 @@ public:
     void stopProcessing();                      // End processing and clean up
 
     void receiveAudioData(const std::vector<double>& audioData); // Push new audio samples
-    bool isHealthy() const;                     // Expose connection health
+    bool isHealthy() const;                     // Connecting or connected; false once the connection fails
+    bool isConnected() const;                   // The connection is established
+    boost::json::object getMetrics() const;     // Pipeline counters, see ProcessorMetrics
 
 private:
     std::atomic<bool> processing{false};
     std::atomic<bool> healthy{false};
     std::thread processingThread;
 
+    std::unique_ptr<StimulusChannel> stimulusChannel;  // "Auditory:<sourceId>"
     std::unique_ptr<AsyncNetworkClient> networkClient;
-    ThreadSafeQueue<std::vector<double>> audioDataQueue;
+
+    // Samples with the time they were received, which stands in for their capture time
+    struct AudioChunk {
+        std::vector<double> samples;
+        std::uint64_t captureMicros = 0;
+    };
+    ThreadSafeQueue<AudioChunk> audioDataQueue;
+    ProcessorMetrics metrics;
 
     void processAudioDataLoop();
-    void performFFTAndSend(const std::vector<double>& audioBuffer);
+    void performFFTAndSend(const std::vector<double>& audioBuffer, std::uint64_t captureMicros);
 
     static constexpr int FFT_SIZE = 1024;
     std::string sourceId;  // Identifier tag for this processor instance
@@ -11,16 +11,19 @@ class AxonBouton;
 class AxonHillock;
 class AxonBranch;
 
-class Axon : public NeuronalComponent
+class Axon final : public NeuronalComponent
 {
 public:
-    explicit Axon(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit Axon(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~Axon() override = default;
 
     // Override methods from NeuronalComponent
     void initialise() override;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
 
     // Axon-specific methods
     void addBranch(std::shared_ptr<AxonBranch> branch);
@@ -2,6 +2,7 @@
 #define AXONBOUTON_H
 
 #include <memory>
+#include <vector>
 #include "NeuronalComponent.h"
 #include "Position.h"
 #include "SynapticGap.h"
@@ -10,16 +11,19 @@
 class Axon;
 class Neuron;
 
-class AxonBouton : public NeuronalComponent
+class AxonBouton final : public NeuronalComponent
 {
 public:
-    explicit AxonBouton(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit AxonBouton(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~AxonBouton() override = default;
 
     // Override methods from NeuronalComponent
     void initialise() override;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
 
     // AxonBouton-specific methods
     void addSynapticGap(const std::shared_ptr<SynapticGap>& gap);
@@ -9,16 +9,19 @@
 // Forward declarations
 class Axon;
 
-class AxonBranch : public NeuronalComponent
+class AxonBranch final : public NeuronalComponent
 {
 public:
-    explicit AxonBranch(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit AxonBranch(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~AxonBranch() override = default;
 
     // Override methods from NeuronalComponent
     void initialise() override;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
 
     // AxonBranch-specific methods
     void connectAxon(std::shared_ptr<Axon> axon);
@@ -10,16 +10,19 @@
 class Soma;
 class Axon;
 
-class AxonHillock : public NeuronalComponent
+class AxonHillock final : public NeuronalComponent
 {
 public:
-    explicit AxonHillock(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit AxonHillock(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~AxonHillock() override = default;
 
     // Override methods from NeuronalComponent
     void initialise() override;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
 
     // AxonHillock-specific methods
     [[nodiscard]] std::shared_ptr<Axon> getAxon() const;
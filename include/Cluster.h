@@ -11,7 +11,7 @@
 /**
  * @brief The Cluster class represents a group of Neurons.
  */
-class Cluster : public NeuronalComponent
+class Cluster final : public NeuronalComponent
 {
 public:
     /**
@@ -24,7 +24,7 @@ public:
      * @brief Constructor for the Cluster class.
      * @param position The position of the cluster in space.
      */
-    explicit Cluster(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent = {});
+    explicit Cluster(const Position& position, std::weak_ptr<NeuronalComponent> parent = {});
 
     /**
      * @brief Initialises the cluster and its neurons.
@@ -37,6 +37,52 @@ public:
      */
     void update(double deltaTime);
 
+    /**
+     * @brief Gets the number of neurons in the cluster.
+     */
+    size_t getNeuronCount() const;
+
+    /**
+     * @brief Gets how many neurons the last update() actually ran; the rest had settled or were deferred.
+     */
+    size_t getActiveNeuronCount() const;
+
+    /**
+     * @brief Gets how many neurons the last update() skipped because their energy was deferred.
+     */
+    size_t getDeferredNeuronCount() const;
+
+    /**
+     * @brief Enables lazy energy evaluation.
+     *
+     * Neurons whose whole subtree is far from every clamp stop being stepped; their
+     * energies follow a straight line and are computed in closed form when a
+     * component's energy is read or changed through its getters and setters.
+     * @param enabled True to defer idle neurons, false to step every neuron again.
+     */
+    void setLazyEnergy(bool enabled);
+    bool isLazyEnergy() const;
+
+    /**
+     * @brief Brings every deferred neuron's component energies up to the current simulation time.
+     *
+     * The energy getters compute the current value without storing it, and the setters
+     * catch their own neuron up; this stores it for every neuron at once.
+     */
+    void materialiseEnergy();
+
+    /**
+     * @brief Gets the sum of the update time steps so far; during update(), the start of the current tick.
+     */
+    double getSimulationTime() const;
+
+#ifdef AARNN_STATE_VALIDATION
+    /**
+     * @brief Adds the difference between stored and double reference energy of this cluster and every component in it.
+     */
+    void measureEnergyDrift(EnergyDrift& drift);
+#endif
+
     void createNeurons(int num_neurons, int neuron_points_per_layer);
     void associateNeurons(double proximityThreshold);
 
@@ -92,13 +138,13 @@ private:
     /**
       * @brief Generates a position for a new cluster that is at least minDistance away from existing clusters.
       * @param minDistance The minimum distance from existing clusters.
-      * @return A shared pointer to the generated Position.
+      * @return The generated Position.
       */
-    static std::shared_ptr<Position> generateClusterPosition(double minDistance);
+    static Position generateClusterPosition(double minDistance);
 
     // Static members
     static int nextClusterId;     ///< Static counter for generating unique cluster IDs.
-    static std::vector<std::shared_ptr<Position>> existingClusterPositions; ///< List of existing cluster positions.
+    static std::vector<Position> existingClusterPositions; ///< List of existing cluster positions.
 
     int clusterId = -1;            ///< Unique DB identifier for the cluster.
     int clusterType;              ///< Type identifier for the cluster.
@@ -107,6 +153,15 @@ private:
     std::vector<std::shared_ptr<Neuron>> neurons; ///< Collection of neurons within the cluster.
     std::mutex neuronMutex; ///< Mutex for thread safety when accessing neurons.
 
+    // Activity gating state, reused between updates
+    std::vector<char> neuronRunning;      ///< Neurons being updated this tick.
+    std::vector<char> neuronChanged;      ///< Neurons whose own energy step changed something.
+    double energyAfterLastUpdate = 0.0;   ///< Cluster energy once the neurons had drawn on it.
+    size_t activeNeuronCount = 0;         ///< Neurons run by the last update.
+    size_t deferredNeuronCount = 0;       ///< Neurons deferred through the last update.
+    bool lazyEnergy = false;              ///< Defer idle neurons (see setLazyEnergy).
+    double simulationTime = 0.0;          ///< Sum of the update time steps so far.
+
     bool instanceInitialised = false; ///< Flag to check if the cluster has been initialised.
 };
 
@@ -0,0 +1,53 @@
+// DatagramReceiver.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+// UDP listener for unicast and (optionally) IPv4 multicast datagrams. One thread
+// drains the socket with recvmmsg, up to BATCH_SIZE datagrams per system call, into
+// buffers allocated once at start.
+class DatagramReceiver {
+public:
+    static constexpr std::size_t BATCH_SIZE = 64;
+    static constexpr std::size_t MAX_DATAGRAM_SIZE = 65507;
+
+    // multicastGroup empty: unicast only. Otherwise the socket also joins the group on
+    // the default interface.
+    DatagramReceiver(unsigned short port, std::string multicastGroup = "");
+    ~DatagramReceiver();
+
+    // Callback for each datagram, on the receive thread. The view is valid only until
+    // it returns. Set before start().
+    void setOnDatagram(std::function<void(std::string_view)> callback);
+    // Invoked on the receive thread before it starts receiving. Set before start().
+    void setOnThreadStart(std::function<void()> callback);
+
+    bool start();
+    void stop();
+
+    std::uint64_t getDatagramsReceived() const { return datagramsReceived.load(std::memory_order_relaxed); }
+    std::uint64_t getReceiveCalls() const { return receiveCalls.load(std::memory_order_relaxed); }
+    std::uint64_t getTruncated() const { return truncated.load(std::memory_order_relaxed); }
+
+private:
+    void receiveLoop();
+
+    unsigned short port;
+    std::string multicastGroup;
+    int socketFd = -1;
+    std::atomic<bool> running{false};
+    std::thread receiveThread;
+    std::function<void(std::string_view)> onDatagram;
+    std::function<void()> onThreadStart;
+    std::vector<char> buffers;  // BATCH_SIZE slots of MAX_DATAGRAM_SIZE bytes
+
+    std::atomic<std::uint64_t> datagramsReceived{0};
+    std::atomic<std::uint64_t> receiveCalls{0};
+    std::atomic<std::uint64_t> truncated{0};
+};
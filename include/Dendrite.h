@@ -12,7 +12,7 @@
 class DendriteBouton;
 class DendriteBranch;
 
-class Dendrite : public NeuronalComponent
+class Dendrite final : public NeuronalComponent
 {
 private:
     bool instanceInitialised = false;  // Initially, the Dendrite is not initialised
@@ -22,7 +22,7 @@ private:
     int dendriteId = -1;
 
 public:
-    explicit Dendrite(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit Dendrite(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~Dendrite() override = default;
 
@@ -33,7 +33,10 @@ public:
     void updateFromDendriteBranch(std::shared_ptr<DendriteBranch> parentDendriteBranchPointer);
     [[nodiscard]] std::shared_ptr<DendriteBranch> getParentDendriteBranch() const;
     std::shared_ptr<DendriteBouton> getDendriteBoutons();
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
     void setDendriteId(int id);
     int getDendriteId() const;
 };
@@ -8,16 +8,17 @@
 #include "SynapticGap.h"
 
 #include <memory>
+#include <vector>
 
 class Dendrite;
 class DendriteBranch;
 class SynapticGap;
 class Neuron;
 
-class DendriteBouton : public NeuronalComponent
+class DendriteBouton final : public NeuronalComponent
 {
 public:
-    explicit DendriteBouton(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit DendriteBouton(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~DendriteBouton() override = default;
 
@@ -28,7 +29,10 @@ public:
     void setNeuron(std::weak_ptr<Neuron> parentNeuron);
     void updateFromDendrite(std::shared_ptr<Dendrite> parentDendritePointer);
     [[nodiscard]] std::shared_ptr<Dendrite> getParentDendrite() const;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
     void setDendriteBoutonId(int id);
     int getDendriteBoutonId() const;
 
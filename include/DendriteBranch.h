@@ -13,10 +13,10 @@
 class Soma;
 class Dendrite;
 
-class DendriteBranch : public NeuronalComponent
+class DendriteBranch final : public NeuronalComponent
 {
 public:
-    explicit DendriteBranch(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit DendriteBranch(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~DendriteBranch() override = default;
     void initialise() override;
@@ -26,7 +26,10 @@ public:
     [[nodiscard]] std::shared_ptr<Soma> getParentSoma() const;
     void updateFromDendrite(std::shared_ptr<Dendrite> parentDendritePointer);
     [[nodiscard]] std::shared_ptr<Dendrite> getParentDendrite() const;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
     void setDendriteBranchId(int id);
     int getDendriteBranchId() const;
 
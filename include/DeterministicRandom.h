@@ -0,0 +1,96 @@
+// DeterministicRandom.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+
+// Counter-based random numbers for reproducible runs.
+//
+// Every value is a pure function of (run seed, stream, entity, counter): there is
+// no shared generator state, so the numbers an entity draws do not depend on how
+// many threads are running, which thread reaches it first, or what other
+// entities drew before it. The run seed comes from simulation.conf (random_seed)
+// or --seed and must be set before any network component is created.
+namespace DeterministicRandom {
+
+    // One stream per use, so adding draws in one place never shifts the values seen elsewhere
+    enum class Stream : std::uint64_t {
+        ClusterPosition = 1,
+        SensoryReceptor = 2,
+        ConvexHullPoint = 3,
+        SynapticGapGlyph = 4,
+    };
+
+    inline std::atomic<std::uint64_t> runSeed{0};
+
+    inline void setRunSeed(std::uint64_t seed) { runSeed.store(seed, std::memory_order_relaxed); }
+    inline std::uint64_t getRunSeed() { return runSeed.load(std::memory_order_relaxed); }
+
+    // SplitMix64 finaliser: a bijective mix with good avalanche behaviour
+    inline std::uint64_t mix(std::uint64_t value)
+    {
+        value += 0x9E3779B97F4A7C15ULL;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+    inline std::uint64_t bits(Stream stream, std::uint64_t entity, std::uint64_t counter)
+    {
+        std::uint64_t key = mix(getRunSeed() ^ mix(static_cast<std::uint64_t>(stream)));
+        key = mix(key ^ entity);
+        return mix(key ^ counter);
+    }
+
+    // Entity key for things that have no ID of their own, derived from their coordinates
+    inline std::uint64_t keyOf(double x, double y, double z)
+    {
+        std::uint64_t key = 0;
+        for (double coordinate : {x, y, z}) {
+            std::uint64_t coordinateBits;
+            std::memcpy(&coordinateBits, &coordinate, sizeof(coordinateBits));
+            key = mix(key ^ coordinateBits);
+        }
+        return key;
+    }
+
+    // Uniform double in [0, 1) built from the top 53 bits
+    inline double uniform(Stream stream, std::uint64_t entity, std::uint64_t counter)
+    {
+        return static_cast<double>(bits(stream, entity, counter) >> 11) * (1.0 / 9007199254740992.0);
+    }
+}
+
+// Sequence of draws for one entity on one stream. Cheap to construct; create one
+// where the draws happen rather than keeping it around. Meets the
+// UniformRandomBitGenerator requirements, but prefer the helpers below over
+// std:: distributions, whose algorithms differ between standard libraries.
+class RandomStream {
+public:
+    using result_type = std::uint64_t;
+
+    RandomStream(DeterministicRandom::Stream stream, std::uint64_t entity)
+        : stream(stream), entity(entity) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+    result_type operator()() { return DeterministicRandom::bits(stream, entity, counter++); }
+
+    // Uniform double in [0, 1)
+    double uniform() { return DeterministicRandom::uniform(stream, entity, counter++); }
+
+    // Uniform double in [low, high)
+    double uniform(double low, double high) { return low + (high - low) * uniform(); }
+
+    // Integer in [0, bound); bound must be positive
+    int below(int bound) { return static_cast<int>(uniform() * bound); }
+
+private:
+    DeterministicRandom::Stream stream;
+    std::uint64_t entity;
+    std::uint64_t counter = 0;
+};
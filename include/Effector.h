@@ -11,10 +11,10 @@
 class SynapticGap;
 class Position;
 
-class Effector : public NeuronalComponent
+class Effector final : public NeuronalComponent
 {
 public:
-    explicit Effector(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent = {});
+    explicit Effector(const Position& position, std::weak_ptr<NeuronalComponent> parent = {});
 
     ~Effector() override = default;
 
@@ -0,0 +1,45 @@
+// EffectorBank.h
+#pragma once
+
+#include "Effector.h"
+#include "SynapticGap.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Readout of one group of effectors. Every effector's output is the summed energy of
+// the synaptic gaps attached to it (Effector::addSynapticGap); the gaps of all
+// effectors are flattened into one array with per-effector offsets, so a readout is a
+// single pass that writes a contiguous output buffer.
+//
+// The gaps belong to neurons advanced by the neural stage, so readout() must run on
+// that stage's thread, between cluster updates. Under lazy energy a gap's stored
+// energy may lag behind; getEnergyLevel() adds the change deferred up to the
+// cluster's simulation time, so readout() sees current values without a
+// Cluster::materialiseEnergy() pass.
+class EffectorBank {
+public:
+    EffectorBank(std::string name, std::vector<std::shared_ptr<Effector>> effectors);
+    EffectorBank(const EffectorBank&) = delete;
+    EffectorBank& operator=(const EffectorBank&) = delete;
+
+    const std::string& getName() const { return name; }
+    std::size_t size() const { return effectors.size(); }
+    std::size_t getSynapticGapCount() const { return gaps.size(); }
+
+    // Re-reads the effectors' synaptic gaps; call after wiring changes
+    void rebuild();
+
+    // Fills and returns the output buffer, one value per effector in bank order
+    const std::vector<double>& readout();
+    const std::vector<double>& getOutput() const { return output; }
+
+private:
+    std::string name;
+    std::vector<std::shared_ptr<Effector>> effectors;
+    std::vector<SynapticGap*> gaps;       // Owned through the effectors
+    std::vector<std::size_t> gapOffsets;  // Effector i reads gaps[gapOffsets[i], gapOffsets[i + 1])
+    std::vector<double> output;
+};
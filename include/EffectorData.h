@@ -0,0 +1,144 @@
+// EffectorData.h
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <netinet/in.h>
+#include <boost/json.hpp>
+
+// Effector output frames, server to subscriber
+//
+// A subscriber asks for one effector bank by name with
+//   {"subscribe": "<bank>", "version": 1}
+// and the server answers
+//   {"subscribe": ..., "bank": <id>, "effectors": <count>, "version": 1}
+// with bank -1 if there is no such bank. From the next neural tick on it receives
+// one output frame per tick for that bank:
+//
+//   offset  size  field
+//        0     1  EFFECTOR_OUTPUT_TAG
+//        1     1  version             (EFFECTOR_WIRE_VERSION)
+//        2     1  encoding            (EffectorEncoding)
+//        3     1  reserved
+//        4     4  bank id
+//        8     4  entry count
+//       12     4  effector count      (of the whole bank)
+//       16     8  tick                (neural tick of the readout)
+//       24     *  entries
+//
+// A Key frame carries every effector's output as little-endian f32, in bank order.
+// A Delta frame carries only the outputs that moved by more than the bank's epsilon
+// since they were last sent, each as a little-endian u32 index and f32 value; apply
+// it to the previous state. Key frames are sent periodically and whenever a new
+// subscriber joins, so a subscriber starts from the first Key frame it receives.
+// Header fields are in network byte order.
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Effector payloads are copied as little-endian");
+
+constexpr std::uint8_t EFFECTOR_OUTPUT_TAG = 0xB8;
+constexpr std::uint8_t EFFECTOR_WIRE_VERSION = 1;
+constexpr std::size_t EFFECTOR_OUTPUT_HEADER_SIZE = 24;
+constexpr std::size_t EFFECTOR_DELTA_ENTRY_SIZE = 8;
+
+enum class EffectorEncoding : std::uint8_t {
+    Key = 0,
+    Delta = 1
+};
+
+struct EffectorOutputHeader {
+    EffectorEncoding encoding = EffectorEncoding::Key;
+    std::uint32_t bankId = 0;
+    std::uint32_t entryCount = 0;
+    std::uint32_t effectorCount = 0;
+    std::uint64_t tick = 0;
+};
+
+inline bool isEffectorOutput(std::string_view frame) {
+    return !frame.empty() && static_cast<std::uint8_t>(frame[0]) == EFFECTOR_OUTPUT_TAG;
+}
+
+inline void writeEffectorOutputHeader(char* out, const EffectorOutputHeader& header) {
+    const std::uint32_t networkId = htonl(header.bankId);
+    const std::uint32_t networkEntries = htonl(header.entryCount);
+    const std::uint32_t networkEffectors = htonl(header.effectorCount);
+    const std::uint32_t networkTickHigh = htonl(static_cast<std::uint32_t>(header.tick >> 32));
+    const std::uint32_t networkTickLow = htonl(static_cast<std::uint32_t>(header.tick));
+    out[0] = static_cast<char>(EFFECTOR_OUTPUT_TAG);
+    out[1] = static_cast<char>(EFFECTOR_WIRE_VERSION);
+    out[2] = static_cast<char>(header.encoding);
+    out[3] = 0;
+    std::memcpy(out + 4, &networkId, 4);
+    std::memcpy(out + 8, &networkEntries, 4);
+    std::memcpy(out + 12, &networkEffectors, 4);
+    std::memcpy(out + 16, &networkTickHigh, 4);
+    std::memcpy(out + 20, &networkTickLow, 4);
+}
+
+// Validates an output frame and reads its header. Returns false for an unknown
+// version or encoding, or if the length does not match the entry count.
+inline bool parseEffectorOutputHeader(std::string_view frame, EffectorOutputHeader& header) {
+    if (!isEffectorOutput(frame) || frame.size() < EFFECTOR_OUTPUT_HEADER_SIZE
+        || static_cast<std::uint8_t>(frame[1]) != EFFECTOR_WIRE_VERSION) {
+        return false;
+    }
+    const char* in = frame.data();
+    header.encoding = static_cast<EffectorEncoding>(in[2]);
+    std::size_t entrySize;
+    switch (header.encoding) {
+        case EffectorEncoding::Key: entrySize = sizeof(float); break;
+        case EffectorEncoding::Delta: entrySize = EFFECTOR_DELTA_ENTRY_SIZE; break;
+        default: return false;
+    }
+
+    std::uint32_t networkId, networkEntries, networkEffectors, networkTickHigh, networkTickLow;
+    std::memcpy(&networkId, in + 4, 4);
+    std::memcpy(&networkEntries, in + 8, 4);
+    std::memcpy(&networkEffectors, in + 12, 4);
+    std::memcpy(&networkTickHigh, in + 16, 4);
+    std::memcpy(&networkTickLow, in + 20, 4);
+    header.bankId = ntohl(networkId);
+    header.entryCount = ntohl(networkEntries);
+    header.effectorCount = ntohl(networkEffectors);
+    header.tick = (static_cast<std::uint64_t>(ntohl(networkTickHigh)) << 32) | ntohl(networkTickLow);
+    return frame.size() - EFFECTOR_OUTPUT_HEADER_SIZE == static_cast<std::size_t>(header.entryCount) * entrySize;
+}
+
+// Applies a frame accepted by parseEffectorOutputHeader to state, which is resized to
+// the bank's effector count. Delta entries outside the bank are ignored.
+inline void applyEffectorOutput(std::string_view frame, const EffectorOutputHeader& header, std::vector<float>& state) {
+    state.resize(header.effectorCount, 0.0f);
+    const char* in = frame.data() + EFFECTOR_OUTPUT_HEADER_SIZE;
+    if (header.encoding == EffectorEncoding::Key) {
+        const std::size_t count = std::min<std::size_t>(header.entryCount, state.size());
+        std::memcpy(state.data(), in, count * sizeof(float));
+        return;
+    }
+    for (std::uint32_t i = 0; i < header.entryCount; ++i, in += EFFECTOR_DELTA_ENTRY_SIZE) {
+        std::uint32_t index;
+        float value;
+        std::memcpy(&index, in, 4);
+        std::memcpy(&value, in + 4, 4);
+        if (index < state.size()) {
+            state[index] = value;
+        }
+    }
+}
+
+inline std::string serializeEffectorSubscription(const std::string& bank) {
+    boost::json::object obj;
+    obj["subscribe"] = bank;
+    obj["version"] = EFFECTOR_WIRE_VERSION;
+    return boost::json::serialize(obj);
+}
+
+inline std::string serializeEffectorSubscriptionReply(const std::string& bank, std::int64_t bankId,
+                                                      std::size_t effectorCount) {
+    boost::json::object obj;
+    obj["subscribe"] = bank;
+    obj["bank"] = bankId;
+    obj["effectors"] = static_cast<std::uint64_t>(effectorCount);
+    obj["version"] = EFFECTOR_WIRE_VERSION;
+    return boost::json::serialize(obj);
+}
@@ -0,0 +1,86 @@
+// EffectorServer.h
+#pragma once
+
+#include "AsyncNetworkServer.h"
+#include "EffectorBank.h"
+#include "EffectorData.h"
+#include "InstrumentedMutex.h"
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Streams effector output to subscribers over TCP (port EFFECTOR_SERVER_PORT); the
+// outbound counterpart of SensoryReceptorServer. Each neural tick, publish() reads
+// out every bank that has subscribers and sends one Key or Delta frame per bank;
+// see EffectorData.h. Readouts go through the energy getters, which include lazily
+// deferred energy, so they are current under lazy energy as well.
+//
+// Each subscriber's send queue is bounded by MAX_QUEUED_BYTES; a frame that does not
+// fit is dropped for that subscriber only, rather than letting a slow subscriber grow
+// the server's memory and its own latency. Delta frames only decode against every
+// frame before them, so a subscriber that lost one gets a Key frame next.
+class EffectorServer {
+public:
+    // Outputs closer than deltaEpsilon to the value last sent are left out of Delta
+    // frames; a Key frame goes out at least every keyframeInterval ticks
+    explicit EffectorServer(double deltaEpsilon = 1e-6, std::uint32_t keyframeInterval = 100);
+    ~EffectorServer();
+
+    // Bytes a subscriber may have waiting to be written before its frames are dropped
+    static constexpr std::size_t MAX_QUEUED_BYTES = 256u * 1024u;
+
+    // Returns false, and the server stays off, if EFFECTOR_SERVER_PORT is unset or invalid
+    bool initialise();
+    bool startServer();
+    void stopServer();
+
+    // Banks are numbered in registration order; register them all before startServer()
+    void registerBank(std::shared_ptr<EffectorBank> bank);
+
+    // Reads out and sends every subscribed bank. Called on the neural thread, after
+    // the clusters were updated.
+    void publish(std::uint64_t tick);
+
+private:
+    struct Subscriber {
+        int clientId;
+        bool keyframePending;  // New, or lost a frame; its next frame must be a Key frame
+    };
+    struct Bank {
+        std::shared_ptr<EffectorBank> bank;
+        std::vector<Subscriber> subscribers;  // Guarded by subscriberMutex
+        std::vector<float> lastSent;          // Neural thread only; what in-sync subscribers hold
+        std::uint32_t ticksSinceKeyframe = 0;
+    };
+
+    void processMessage(int clientId, std::string_view message);
+    void subscribe(int clientId, const std::string& bankName);
+    void unsubscribe(int clientId);
+    const std::string& encode(std::uint32_t bankId, Bank& state, std::uint64_t tick, bool keyframe);
+    const std::string& encodeKeyframe(std::uint32_t bankId, const Bank& state, std::uint64_t tick);
+
+    std::unique_ptr<AsyncNetworkServer> networkServer{};
+    bool server_initialised = false;
+    std::atomic<bool> running{false};
+    double deltaEpsilon;
+    std::uint32_t keyframeInterval;
+
+    std::vector<std::unique_ptr<Bank>> banks;     // Indexed by bank id
+    std::map<std::string, std::uint32_t> bankIds;  // Bank name -> id, only used at subscription
+    InstrumentedMutex subscriberMutex{"EffectorServer::subscriberMutex"};
+
+    std::string frame;                       // Reused for every encoded frame
+    std::string resyncFrame;                 // Key frame for subscribers that fell out of sync
+    std::vector<Subscriber> publishTargets;  // Copy of a bank's subscribers while sending
+    std::vector<int> droppedTargets;         // Subscribers whose frame was dropped this tick
+
+    std::atomic<std::uint64_t> keyframes{0};
+    std::atomic<std::uint64_t> deltaFrames{0};
+    std::atomic<std::uint64_t> bytesSent{0};
+    std::atomic<std::uint64_t> framesDropped{0};  // Per subscriber
+};
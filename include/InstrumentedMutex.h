@@ -0,0 +1,99 @@
+// InstrumentedMutex.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <boost/json.hpp>
+
+// Per-name lock counters. Every InstrumentedMutex constructed with the same name
+// shares one LockStatistics instance, so per-object locks (e.g. one per receptor)
+// are reported as a single entry.
+class LockStatistics {
+public:
+    // Wait-time histogram bucket i counts contended waits in [2^i, 2^(i+1)) nanoseconds;
+    // the last bucket also absorbs anything longer.
+    static constexpr std::size_t HISTOGRAM_BUCKETS = 32;
+
+    void recordUncontended();
+    void recordContended(std::chrono::nanoseconds waited);
+    void reset();
+
+    boost::json::object toJson() const;
+
+private:
+    std::atomic<std::uint64_t> acquisitions{0};
+    std::atomic<std::uint64_t> contended{0};
+    std::atomic<std::uint64_t> totalWaitNs{0};
+    std::atomic<std::uint64_t> maxWaitNs{0};
+    std::array<std::atomic<std::uint64_t>, HISTOGRAM_BUCKETS> waitHistogram{};
+};
+
+// Registry of all named locks in the process. Registers itself with the
+// StatsRegistry under "locks" on first use.
+class LockRegistry {
+public:
+    static LockRegistry& instance();
+
+    LockStatistics& statisticsFor(const std::string& name);
+    boost::json::object snapshot() const;
+    void resetAll();
+
+private:
+    LockRegistry();
+
+    mutable std::mutex registryMutex; // Only taken when a lock is constructed or a snapshot is built
+    std::map<std::string, std::unique_ptr<LockStatistics>> locks;
+};
+
+// Drop-in replacement for std::mutex that records acquisitions, contended
+// acquisitions and wait time for the named lock. Satisfies Lockable, so it works
+// with std::lock_guard, std::unique_lock and std::condition_variable_any.
+//
+// Build with -DENABLE_LOCK_PROFILING=OFF to compile the wrapper down to a plain mutex.
+class InstrumentedMutex {
+public:
+    explicit InstrumentedMutex(const std::string& name);
+    InstrumentedMutex(const InstrumentedMutex&) = delete;
+    InstrumentedMutex& operator=(const InstrumentedMutex&) = delete;
+
+    void lock()
+    {
+#ifdef AARNN_LOCK_PROFILING
+        if (mutex.try_lock()) {
+            statistics->recordUncontended();
+            return;
+        }
+        auto waitStart = std::chrono::steady_clock::now();
+        mutex.lock();
+        statistics->recordContended(std::chrono::steady_clock::now() - waitStart);
+#else
+        mutex.lock();
+#endif
+    }
+
+    bool try_lock()
+    {
+        bool acquired = mutex.try_lock();
+#ifdef AARNN_LOCK_PROFILING
+        if (acquired) {
+            statistics->recordUncontended();
+        }
+#endif
+        return acquired;
+    }
+
+    void unlock()
+    {
+        mutex.unlock();
+    }
+
+private:
+    std::mutex mutex;
+    LockStatistics* statistics = nullptr;
+};
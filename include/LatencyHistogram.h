@@ -0,0 +1,66 @@
+// LatencyHistogram.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <boost/json.hpp>
+
+// Lock-free histogram of latencies in microseconds, in power-of-two buckets: bucket b
+// holds values below 2^b. Any thread may record(); percentiles are reported as the
+// upper bound of the bucket they fall in, so they are accurate to a factor of two.
+class LatencyHistogram {
+public:
+    static constexpr std::size_t BUCKETS = 40;
+
+    void record(std::uint64_t micros) {
+        std::size_t bucket = 0;
+        while (bucket + 1 < BUCKETS && (micros >> bucket) != 0) {
+            ++bucket;
+        }
+        buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(micros, std::memory_order_relaxed);
+        std::uint64_t previous = maximum.load(std::memory_order_relaxed);
+        while (micros > previous && !maximum.compare_exchange_weak(previous, micros, std::memory_order_relaxed)) {
+        }
+    }
+
+    boost::json::object toJson() const {
+        std::array<std::uint64_t, BUCKETS> snapshot;
+        std::uint64_t total = 0;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            snapshot[b] = buckets[b].load(std::memory_order_relaxed);
+            total += snapshot[b];
+        }
+
+        boost::json::object entry;
+        entry["count"] = total;
+        entry["mean_us"] = total ? static_cast<double>(sum.load(std::memory_order_relaxed)) / static_cast<double>(total) : 0.0;
+        entry["p50_us"] = percentile(snapshot, total, 0.50);
+        entry["p90_us"] = percentile(snapshot, total, 0.90);
+        entry["p99_us"] = percentile(snapshot, total, 0.99);
+        entry["max_us"] = maximum.load(std::memory_order_relaxed);
+        return entry;
+    }
+
+private:
+    static std::uint64_t percentile(const std::array<std::uint64_t, BUCKETS>& snapshot, std::uint64_t total,
+                                    double fraction) {
+        if (total == 0) {
+            return 0;
+        }
+        const auto rank = static_cast<std::uint64_t>(fraction * static_cast<double>(total - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (std::size_t b = 0; b < BUCKETS; ++b) {
+            seen += snapshot[b];
+            if (seen >= rank) {
+                return std::uint64_t{1} << b;
+            }
+        }
+        return std::uint64_t{1} << (BUCKETS - 1);
+    }
+
+    std::array<std::atomic<std::uint64_t>, BUCKETS> buckets{};
+    std::atomic<std::uint64_t> sum{0};
+    std::atomic<std::uint64_t> maximum{0};
+};
@@ -8,6 +8,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <iomanip> // For std::put_time
+#include "InstrumentedMutex.h"
 
 class Logger {
 public:
@@ -17,7 +18,7 @@ public:
 
     template<typename T>
     Logger& operator<<(const T& msg) {
-        std::lock_guard<std::mutex> lock(log_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(log_mutex_);
 
         // Get current time
         auto now = std::chrono::system_clock::now();
@@ -39,7 +40,7 @@ public:
 
 private:
     std::ofstream log_file_;
-    std::mutex log_mutex_;
+    InstrumentedMutex log_mutex_{"Logger::log_mutex_"};
 };
 
 #endif // AARNN_LOGGER_H
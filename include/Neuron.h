@@ -1,6 +1,7 @@
 #ifndef NEURON_H
 #define NEURON_H
 
+#include <atomic>
 #include <memory>
 #include <vector>
 #include "NeuronalComponent.h"
@@ -18,10 +19,14 @@ class DendriteBranch;
 class Dendrite;
 class Axon;
 
-class Neuron : public NeuronalComponent
+class Neuron final : public NeuronalComponent
 {
 public:
-    explicit Neuron(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit Neuron(const Position& position, std::weak_ptr<NeuronalComponent> parent);
+    Neuron(const Position& position, int neuronId, std::weak_ptr<NeuronalComponent> parent);
+
+    // Reserves count consecutive neuron IDs and returns the first
+    static int reserveNeuronIds(int count);
 
     // Methods
     std::shared_ptr<Soma> getSoma();
@@ -38,18 +43,55 @@ public:
     double getPropagationRate() const;
     void setNeuronType(int type);
     int getNeuronType() const;
-    void update(double deltaTime);
+    // Both return false if nothing in the neuron changed
+    bool update(double deltaTime);
+    // Everything update() does except this neuron's own energy step. Steps a flattened
+    // copy of the subtree taken on the first call, so the structure must be complete
+    // by then.
+    bool updateComponents(double deltaTime);
+    // Appends this neuron and every component update() reaches, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
     void updateFromCluster(std::shared_ptr<Cluster> parentPointer);
+
+    // Lazy energy (see Cluster::setLazyEnergy). While no step could clamp, every
+    // component's energy changes at a constant rate, so the subtree can stop being
+    // stepped and be brought up to date in closed form when needed. Times are the
+    // owning cluster's simulation time.
+    //
+    // Defers the subtree from now on if at least one more step of up to maxDeltaTime
+    // stays within that range; the network structure must not change afterwards.
+    bool tryDeferEnergy(double now, double maxDeltaTime);
+    bool isEnergyDeferred() const;
+    // True if a step of deltaTime starting at tickStart can be skipped
+    bool canStayDeferred(double tickStart, double deltaTime) const;
+    // Brings every component's energy up to now and stays deferred
+    void catchUpEnergy(double now);
+    // Brings every component's energy up to now and resumes per-step updates
+    void endEnergyDeferral(double now);
+    // How far the subtree's stored energy lags the parent cluster's simulation time;
+    // the energy getters of the subtree's components add their rate times this
+    double deferredEnergyElapsed() const override;
+    // Catches up to the parent cluster's simulation time; called by the energy
+    // setters of every component in the subtree
+    void materialiseDeferredEnergy() override;
     std::shared_ptr<Cluster> getParentCluster() const;
 
 private:
+    struct ComponentEntry {
+        NeuronalComponent* component;
+        int parentIndex;       // Index of the parent in componentEntries; -1 for this neuron
+        double netRate = 0.0;  // Energy change per unit time while deferred (lazy energy)
+    };
+
+    void buildComponentEntries();
+
     void traverseAxonsForStorage(const std::shared_ptr<Axon>& axon);
     void traverseDendritesForStorage(const std::vector<std::shared_ptr<DendriteBranch>>& dendriteBranches);
-    std::shared_ptr<SynapticGap> traverseAxons(const std::shared_ptr<Axon>& axon, const std::shared_ptr<Position>& positionPtr);
-    std::shared_ptr<SynapticGap> traverseDendrites(const std::shared_ptr<Dendrite>& dendrite, const std::shared_ptr<Position>& positionPtr);
+    std::shared_ptr<SynapticGap> traverseAxons(const std::shared_ptr<Axon>& axon, const Position& targetPosition);
+    std::shared_ptr<SynapticGap> traverseDendrites(const std::shared_ptr<Dendrite>& dendrite, const Position& targetPosition);
 
     // Static member for generating unique neuron IDs
-    static int nextNeuronId;
+    static std::atomic<int> nextNeuronId;
 
     // Member variables
     int neuronId = -1;
@@ -61,6 +103,19 @@ private:
     std::vector<std::shared_ptr<AxonBouton>> axonBoutons;
     double propagationRate;
     std::shared_ptr<Cluster> parentCluster;
+
+    // This neuron followed by its subtree in update order, built on the first update
+    // and used by the flattened update and lazy energy
+    std::vector<ComponentEntry> componentEntries;
+    bool componentEntriesBuilt = false;
+    bool componentEntriesValid = false;
+
+    // Lazy energy state
+    bool energyDeferred = false;
+    double deferredSince = 0.0;
+    double deferredUntil = 0.0;
+    double deferralStepLimit = 0.0;
+    bool lazyEnergyOwnerSet = false;
 };
 
 #endif // NEURON_H
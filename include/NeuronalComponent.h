@@ -1,34 +1,66 @@
 #ifndef NEURONALCOMPONENT_H
 #define NEURONALCOMPONENT_H
 
+#include <atomic>
 #include <memory>
 #include "Position.h"
+#include "Precision.h"
 
 class NeuronalComponent : public std::enable_shared_from_this<NeuronalComponent>
 {
 protected:
-    std::shared_ptr<Position> position;
+    Position position;  // Owned by value; use moveTo/translate to change it
     std::weak_ptr<NeuronalComponent> parent;
+
+    // Energy management attributes, stored as state_t (see Precision.h)
+    state_t energyLevel;
+    state_t maxEnergyLevel;
+    state_t energyConsumptionRate;
+    state_t energyReplenishRate;
+
+#ifdef AARNN_STATE_VALIDATION
+    // The same energy state in double, advanced by the same steps, to measure the
+    // drift caused by reduced-precision storage
+    struct ReferenceEnergy {
+        double energyLevel;
+        double maxEnergyLevel;
+        double energyConsumptionRate;
+        double energyReplenishRate;
+    };
+    ReferenceEnergy reference;
+#endif
+
     bool instanceInitialised = false;
 
-    // Energy management attributes
-    double energyLevel;
-    double maxEnergyLevel;
-    double energyConsumptionRate;
-    double energyReplenishRate;
+    // Activity gating. quiescent is only touched by whoever drives this component's
+    // update; wakeRequested may be set from any thread.
+    bool quiescent = false;
+    std::atomic<bool> wakeRequested{false};
+
+    // Lazy energy: the neuron whose deferral covers this component, or null, and the
+    // rate this component's energy changes at while deferred. getEnergyLevel() adds the
+    // change since the stored value without writing anything; energy writes bring the
+    // neuron up to date first.
+    NeuronalComponent* lazyEnergyOwner = nullptr;
+    double lazyEnergyRate = 0.0;
 
 public:
-    explicit NeuronalComponent(std::shared_ptr<Position> position, std::weak_ptr<NeuronalComponent> parent = {});
+    explicit NeuronalComponent(const Position& position, std::weak_ptr<NeuronalComponent> parent = {});
 
     // Position management
-    virtual void updatePosition(const std::shared_ptr<Position>& newPosition);
-    std::shared_ptr<Position> getPosition() const;
+    const Position& getPosition() const { return position; }
+    void moveTo(const Position& newPosition);
+    void translate(double dx, double dy, double dz);
     virtual void setParent(std::weak_ptr<NeuronalComponent> parentComponent);
+    std::shared_ptr<NeuronalComponent> getParentComponent() const;
 
     // Initialization
     virtual void initialise();
 
-    // Energy management
+    // Energy management. getEnergyLevel() includes energy deferred by lazy evaluation
+    // and never writes, so it is as safe to call off the neural thread as reading the
+    // stored energy was; the setters may catch the owning neuron up and so belong on
+    // the neural thread.
     virtual double getEnergyLevel() const;
     virtual double getMaxEnergyLevel() const;
     virtual double getEnergyConsumptionRate() const;
@@ -41,9 +73,62 @@ public:
     virtual void energyDrain(double amount);
     virtual void useEnergy(double amount);
     virtual void updateEnergy(double deltaTime);
+    // One energy step; returns false if it changed neither this component nor its parent
+    bool stepEnergy(double deltaTime);
+    // The same step with the parent already resolved (nullptr for a root), for callers
+    // that keep the hierarchy themselves and want to avoid the weak_ptr lock
+    bool stepEnergy(double deltaTime, NeuronalComponent* parentComponent);
+
+    // Non-virtual reads of the stored energy state for the tick path. The virtual
+    // getters above remain the API for everything else.
+    double storedEnergyLevel() const { return energyLevel; }
+    double storedMaxEnergyLevel() const { return maxEnergyLevel; }
+    double storedEnergyConsumptionRate() const { return energyConsumptionRate; }
+    double storedEnergyReplenishRate() const { return energyReplenishRate; }
+
+    // Activity gating: a component whose update changes nothing settles and is skipped
+    // until wake() is called for it or for anything beneath it. The driver brackets each
+    // update with beginUpdate() (false = skip this tick) and endUpdate().
+    bool beginUpdate();
+    void endUpdate(bool changed);
+    bool isQuiescent() const;
+    bool hasPendingWake() const;
+    void wake();
+
+    // Closed-form catch-up for lazily evaluated energy. Only valid over a stretch where
+    // no step would have clamped (see Neuron::tryDeferEnergy); the result is clamped to
+    // [0, max] regardless.
+    void applyEnergyCatchUp(double amount);
+    void setLazyEnergyOwner(NeuronalComponent* owner) { lazyEnergyOwner = owner; }
+    void setLazyEnergyRate(double rate) { lazyEnergyRate = rate; }
+    // Simulation time the stored energy of this component's subtree lags behind; only
+    // a deferred Neuron has any. Reads only.
+    virtual double deferredEnergyElapsed() const { return 0.0; }
+    // Brings deferred energy up to the owning cluster's simulation time; only a
+    // deferred Neuron has anything to do. Neural thread only.
+    virtual void materialiseDeferredEnergy() {}
+
+#ifdef AARNN_STATE_VALIDATION
+    double getReferenceEnergyLevel() const;
+#endif
 
     // Destructor
     virtual ~NeuronalComponent() = default;
+
+private:
+    // Adds amount (negative to drain) to the stored energy, clamped to [0, max].
+    // Unlike energyTopup/energyDrain it leaves the validation reference alone.
+    void addStoredEnergy(double amount);
+    void materialiseOwner()
+    {
+        if (lazyEnergyOwner)
+        {
+            lazyEnergyOwner->materialiseDeferredEnergy();
+        }
+    }
+#ifdef AARNN_STATE_VALIDATION
+    void stepReferenceEnergy(double deltaTime, NeuronalComponent* parentComponent);
+#endif
 };
 
 #endif // NEURONALCOMPONENT_H
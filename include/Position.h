@@ -3,18 +3,25 @@
 
 #include <tuple>
 #include <iostream>
+#include "Precision.h"
 
+// Plain value type; components own their position rather than sharing one through
+// a pointer, so moving one component never moves another.
 class Position {
 public:
-    double x, y, z;
+    coord_t x, y, z;
 
     Position(double x, double y, double z);
 
     [[nodiscard]] double distanceTo(const Position &other) const;
     void setPosition(double newX, double newY, double newZ);
+    void translate(double dx, double dy, double dz);
+    [[nodiscard]] Position offsetBy(double dx, double dy, double dz) const;
     double calcPropagationTime(const Position &position1, double propagationRate) const;
     bool operator==(const Position &other) const;
     std::tuple<double, double, double> getPosition() const;
 };
 
+std::ostream &operator<<(std::ostream &stream, const Position &position);
+
 #endif // POSITION_H
@@ -0,0 +1,48 @@
+// Precision.h
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Storage type for per-component state (energies and rates). Arithmetic is done in
+// double and only the stored value is narrowed, so float storage halves the state
+// without changing how a step is computed. Selected at build time with
+// -DAARNN_STATE_PRECISION=float|double.
+#ifdef AARNN_STATE_FLOAT
+using state_t = float;
+constexpr const char* STATE_PRECISION_NAME = "float32";
+#else
+using state_t = double;
+constexpr const char* STATE_PRECISION_NAME = "float64";
+#endif
+
+// Coordinate type for Position, selected with -DAARNN_POSITION_PRECISION=float|double.
+// Distances are still computed in double; float only narrows what is stored.
+#ifdef AARNN_POSITION_FLOAT
+using coord_t = float;
+constexpr const char* POSITION_PRECISION_NAME = "float32";
+#else
+using coord_t = double;
+constexpr const char* POSITION_PRECISION_NAME = "float64";
+#endif
+
+// Difference between stored state and the double reference path kept in
+// validation builds (-DENABLE_STATE_VALIDATION=ON)
+struct EnergyDrift {
+    std::uint64_t components = 0;
+    double sumAbsolute = 0.0;
+    double maxAbsolute = 0.0;
+    double maxRelative = 0.0;  // Relative to the reference value, for non-zero references
+
+    void add(double stored, double reference)
+    {
+        const double absolute = std::fabs(stored - reference);
+        components++;
+        sumAbsolute += absolute;
+        maxAbsolute = std::max(maxAbsolute, absolute);
+        if (reference != 0.0) {
+            maxRelative = std::max(maxRelative, absolute / std::fabs(reference));
+        }
+    }
+};
@@ -9,19 +9,47 @@
 #include <mutex>
 #include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <random>
 #include <boost/json.hpp>
 #include "AuditoryProcessor.h"
 #include "VisualProcessor.h"
 
 
 // Manages a group of sensory processors (e.g. Auditory, Visual).
-// Handles lifecycle (initialise, start, stop), health monitoring,
-// and provides hooks for periodic diagnostics or recovery.
+// Handles lifecycle (initialise, start, stop) and supervises health: an unhealthy
+// processor is restarted off the supervisor thread, with exponential backoff and
+// jitter between failed attempts, so one processor reconnecting never holds up the
+// others or a status query. A restart only counts as successful once the processor's
+// connection is confirmed, and the failure count is only cleared after it has then
+// stayed healthy for RESTART_STABLE_PERIOD, so a processor that connects and drops
+// again keeps backing off.
 class ProcessorManager {
 public:
+    // Supervision state of one processor
+    enum class ProcessorState {
+        Running,     // Healthy, or not yet found unhealthy
+        Restarting,  // A restart attempt is in flight
+        Verifying,   // Restarted; waiting for the connection to be confirmed
+        Backoff      // The last attempt failed; waiting to retry
+    };
+
+    // Backoff before retry n (n >= 1) is drawn from [d/2, d] with
+    // d = min(RESTART_BACKOFF_BASE * 2^(n-1), RESTART_BACKOFF_MAX)
+    static constexpr std::chrono::milliseconds RESTART_BACKOFF_BASE{500};
+    static constexpr std::chrono::milliseconds RESTART_BACKOFF_MAX{60000};
+    static constexpr std::chrono::milliseconds SUPERVISOR_TICK{250};
+    // A restarted processor not connected within this has failed the attempt
+    static constexpr std::chrono::milliseconds RESTART_CONFIRM_TIMEOUT{5000};
+    static constexpr std::chrono::milliseconds RESTART_STABLE_PERIOD{30000};
+
     ProcessorManager();
     ~ProcessorManager();
 
+    // Ids are unique per modality; registering one again is refused and logged
     void registerAuditoryProcessor(const std::string& id, const std::string& host, unsigned short port);
     void registerVisualProcessor(const std::string& id, const std::string& host, unsigned short port);
     void loadFromJsonConfig(const std::string& filePath); // Load processors dynamically
@@ -29,15 +57,48 @@ public:
     void startAll();
     void stopAll();
 
-    void monitorHealth(); // Optional background health checker
-    // Query the current status of all processors (auditory and visual)
+    // Query the current status of all processors (auditory and visual): supervision
+    // state and each processor's pipeline metrics. Never waits on a restart.
     boost::json::object getProcessorStatuses() const;
 
 private:
+    // A processor under supervision. The state and counters are written by the
+    // supervisor thread and read by status queries.
+    struct Supervised {
+        std::string id;
+        std::function<bool()> isHealthy;
+        std::function<bool()> isConnected;
+        std::function<bool()> restart;  // Stop, reconnect and start again; false if that could not begin
+        std::function<boost::json::object()> metrics;
+
+        std::atomic<ProcessorState> state{ProcessorState::Running};
+        std::atomic<std::uint32_t> consecutiveFailures{0};
+        std::atomic<std::uint64_t> restarts{0};
+        std::atomic<std::int64_t> retryAtMillis{0};  // steady_clock; retry (Backoff) or give up (Verifying)
+        std::atomic<std::int64_t> stableAtMillis{0};  // steady_clock; failures are cleared once Running past it
+        std::future<bool> attempt;                    // Supervisor thread only
+    };
+
+    template <typename Processor>
+    static std::shared_ptr<Supervised> supervise(const std::string& id, const std::shared_ptr<Processor>& processor);
+    void superviseProcessors();
+    void advance(Supervised& processor, std::chrono::steady_clock::time_point now);
+    void retryLater(Supervised& processor, std::int64_t nowMillis, const char* reason);
+    std::chrono::milliseconds backoffFor(std::uint32_t failures);
+    static boost::json::object statusOf(const Supervised& processor);
+
     std::unordered_map<std::string, std::shared_ptr<AuditoryProcessor>> auditoryProcessors;
     std::unordered_map<std::string, std::shared_ptr<VisualProcessor>> visualProcessors;
+    // In registration order; the supervisor works on a copy taken each tick
+    std::vector<std::shared_ptr<Supervised>> supervisedAuditory;
+    std::vector<std::shared_ptr<Supervised>> supervisedVisual;
 
     std::thread healthMonitorThread;
     std::atomic<bool> monitoring{false};
+    std::mutex monitorWakeMutex;
+    std::condition_variable monitorWake;  // Cuts the supervisor's sleep short at stopAll()
+    std::mt19937 jitter{std::random_device{}()};  // Supervisor thread only
+    // Guards the processor tables only; never held while a processor is stopped,
+    // started or reconnected
     mutable std::mutex processorMutex;
 };
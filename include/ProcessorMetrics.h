@@ -0,0 +1,80 @@
+// ProcessorMetrics.h
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <boost/json.hpp>
+#include "AsyncNetworkClient.h"
+#include "LatencyHistogram.h"
+#include "StimuliData.h"
+#include "StimulusChannel.h"
+
+// Pipeline counters of one sensory processor, so a sensor that falls behind shows up
+// before it skews the simulation. Updated lock-free from the processor's capture and
+// processing threads; toJson() may be called from any thread.
+class ProcessorMetrics {
+public:
+    // A frame (video frame, audio chunk) arrived from the sensor
+    void captured() { framesCaptured.fetch_add(1, std::memory_order_relaxed); }
+    // Frames waiting between capture and processing
+    void enqueued() { queueDepth.fetch_add(1, std::memory_order_relaxed); }
+    void dequeued() { queueDepth.fetch_sub(1, std::memory_order_relaxed); }
+    // Time spent turning captured data into stimulus values (FFT, image reduction)
+    void processed(std::uint64_t micros) { processingTime.record(micros); }
+
+    // Outcome of one StimulusChannel::send(); an accepted frame records its age, from
+    // capture to hand-off to the transport
+    void sent(bool accepted, std::uint64_t captureMicros) {
+        if (!accepted) {
+            framesDropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        framesSent.fetch_add(1, std::memory_order_relaxed);
+        const std::uint64_t now = stimulusClockMicros();
+        sendLatency.record(now > captureMicros ? now - captureMicros : 0);
+    }
+    // A frame refused because the processor's connection has failed
+    void sendFailed() { sendErrors.fetch_add(1, std::memory_order_relaxed); }
+
+    // Every initialise(); connections after the first are reconnects
+    void connected(bool succeeded) {
+        (succeeded ? connections : connectFailures).fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Adds the bytes the processor's channel sent and the state of its TCP write queue
+    boost::json::object toJson(const StimulusChannel& channel, const AsyncNetworkClient& client) const {
+        boost::json::object metrics;
+        const std::uint64_t connected = connections.load(std::memory_order_relaxed);
+        metrics["frames_captured"] = framesCaptured.load(std::memory_order_relaxed);
+        metrics["frames_sent"] = framesSent.load(std::memory_order_relaxed);
+        metrics["frames_dropped"] = framesDropped.load(std::memory_order_relaxed);
+        metrics["send_errors"] = sendErrors.load(std::memory_order_relaxed);
+        metrics["queue_depth"] = std::max<std::int64_t>(0, queueDepth.load(std::memory_order_relaxed));
+        metrics["processing"] = processingTime.toJson();
+        metrics["send_latency"] = sendLatency.toJson();
+        metrics["reconnects"] = connected > 0 ? connected - 1 : 0;
+        metrics["connect_failures"] = connectFailures.load(std::memory_order_relaxed);
+        metrics["bytes_sent"] = channel.getBytesSent();
+
+        const ClientWriteStatistics writes = client.getWriteStatistics();
+        boost::json::object tcp;
+        tcp["frames_queued"] = writes.framesQueued;
+        tcp["frames_sent"] = writes.framesSent;
+        tcp["frames_dropped"] = writes.framesDropped;
+        tcp["queued_bytes_high_water"] = writes.queuedBytesHighWater;
+        metrics["tcp"] = std::move(tcp);
+        return metrics;
+    }
+
+private:
+    std::atomic<std::uint64_t> framesCaptured{0};
+    std::atomic<std::uint64_t> framesSent{0};
+    std::atomic<std::uint64_t> framesDropped{0};  // Refused by the channel: no credit, full ring or queue
+    std::atomic<std::uint64_t> sendErrors{0};
+    std::atomic<std::int64_t> queueDepth{0};
+    std::atomic<std::uint64_t> connections{0};
+    std::atomic<std::uint64_t> connectFailures{0};
+    LatencyHistogram processingTime;
+    LatencyHistogram sendLatency;
+};
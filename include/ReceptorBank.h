@@ -0,0 +1,112 @@
+// ReceptorBank.h
+#pragma once
+
+#include "InstrumentedMutex.h"
+#include "Precision.h"
+#include "SensoryReceptor.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// What happens to whole frames (stimulate(values, count)) that arrive between updates:
+//   Sum         every frame is added into the next update (lock-free)
+//   Latest      only the newest frame is applied; older ones are coalesced away
+//   DropOldest  frames queue up to the bank's depth and one is applied per update;
+//               a full queue drops its oldest frame
+enum class IngestPolicy { Sum, Latest, DropOldest };
+
+const char* ingestPolicyName(IngestPolicy policy);
+bool parseIngestPolicy(const std::string& name, IngestPolicy& policy);
+
+struct IngestStatistics {
+    std::uint64_t received = 0;   // Frames handed to the bank
+    std::uint64_t applied = 0;    // Frames (or sums of frames) that reached an update
+    std::uint64_t coalesced = 0;  // Frames merged into another one (Sum) or overwritten (Latest)
+    std::uint64_t dropped = 0;    // Frames evicted from a full queue (DropOldest)
+};
+
+// Contiguous state for one group of sensory receptors (one hemisphere of one modality).
+//
+// The SensoryReceptor objects stay in the network for their positions and synaptic
+// gaps, but the per-tick state (pending stimulus, threshold, sensitivity and energy)
+// lives here in parallel arrays and is advanced by a single loop over the bank. The
+// receptors' own energy fields are not advanced once they are in a bank; read
+// energies through getEnergyLevel(index).
+class ReceptorBank {
+public:
+    // Banks at least this large also split the update across OpenMP threads
+    static constexpr std::size_t PARALLEL_UPDATE_THRESHOLD = 4096;
+
+    // Each slot is seeded from its receptor's current parameters. ingestDepth bounds the
+    // DropOldest queue and is the credit window offered to producers.
+    ReceptorBank(std::string name, std::vector<std::shared_ptr<SensoryReceptor>> receptors,
+                 IngestPolicy ingestPolicy = IngestPolicy::Sum, std::size_t ingestDepth = 4);
+    ReceptorBank(const ReceptorBank&) = delete;
+    ReceptorBank& operator=(const ReceptorBank&) = delete;
+
+    const std::string& getName() const { return name; }
+    std::size_t size() const { return receptors.size(); }
+    const std::vector<std::shared_ptr<SensoryReceptor>>& getReceptors() const { return receptors; }
+
+    IngestPolicy getIngestPolicy() const { return ingestPolicy; }
+    std::size_t getIngestDepth() const { return ingestDepth; }
+    IngestStatistics getIngestStatistics() const;
+
+    // Producer side, callable from any thread. A single-receptor stimulus is always
+    // summed without locking. A frame (values[i] goes to receptor i; extra values are
+    // ignored) follows the ingest policy; only Latest and DropOldest take a lock.
+    //
+    // creditTag is an opaque, nonzero identifier of the flow-control credit the frame
+    // spent. A DropOldest bank queues it with the frame and releases it when the frame
+    // leaves the queue, applied or evicted; other policies ignore it.
+    void stimulate(std::size_t index, double intensity);
+    void stimulate(const double* values, std::size_t count, std::uint64_t creditTag = 0);
+    void stimulate(const std::vector<double>& values) { stimulate(values.data(), values.size()); }
+
+    // Appends the credit tags released since the previous call to released
+    void takeReleasedCredits(std::vector<std::uint64_t>& released);
+
+    // One step for every receptor in the bank. Returns how many changed.
+    std::uint64_t update(double deltaTime);
+
+    double getEnergyLevel(std::size_t index) const { return energyLevel[index]; }
+    void setThreshold(std::size_t index, double value) { threshold[index] = value; }
+    void setSensitivity(std::size_t index, double value) { sensitivity[index] = value; }
+
+private:
+    std::string name;
+    std::vector<std::shared_ptr<SensoryReceptor>> receptors;
+
+    // Stimulus accumulated since the last update. Producers add to a slot atomically;
+    // update() takes each slot with one exchange into processingStimulus, so nothing
+    // added concurrently is lost and neither side ever waits for the other.
+    std::unique_ptr<std::atomic<double>[]> pendingStimulus;
+    std::vector<double> processingStimulus;
+
+    // Frames waiting for Latest/DropOldest, ingestDepth slots of size() values each
+    void takeQueuedFrame();
+    IngestPolicy ingestPolicy;
+    std::size_t ingestDepth;
+    InstrumentedMutex ingestMutex{"ReceptorBank::ingestMutex"};
+    std::vector<double> frameQueue;
+    std::vector<std::uint64_t> frameCredits;    // Credit tag of each queued frame
+    std::vector<std::uint64_t> releasedCredits;
+    std::size_t queueHead = 0;
+    std::size_t queuedFrames = 0;
+
+    std::atomic<std::uint64_t> framesReceived{0};
+    std::atomic<std::uint64_t> framesApplied{0};
+    std::atomic<std::uint64_t> framesCoalesced{0};
+    std::atomic<std::uint64_t> framesDropped{0};
+    std::atomic<std::uint64_t> framesSinceUpdate{0};  // Sum only
+
+    std::vector<double> threshold;
+    std::vector<double> sensitivity;
+    std::vector<state_t> energyLevel;
+    std::vector<state_t> maxEnergyLevel;
+    std::vector<state_t> energyConsumptionRate;
+};
@@ -0,0 +1,68 @@
+// SensoryModalityRegistry.h
+#pragma once
+
+#include "Neuron.h"
+#include "ReceptorBank.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Layout and wiring of one sensory modality. Receptors are split evenly between a left
+// and a right hemisphere; the right one is the left one shifted by hemisphereOffset
+// along x.
+struct SensoryModalityConfig {
+    std::string name;
+    int receptorCount = 0;         // Across both hemispheres
+    int pointsPerLayer = 4;        // Passed to get_coordinates
+    double originX = 0.0;          // Offset of the left hemisphere
+    double originY = 0.0;
+    double originZ = 0.0;
+    double hemisphereOffset = 0.0;
+    int wiringStride = 0;          // Every Nth receptor (except the first) is wired to a neuron; 0 = none
+    IngestPolicy ingestPolicy = IngestPolicy::Sum;
+    int ingestDepth = 4;           // Frame queue bound and producer credit window per tick
+};
+
+// All sensory modalities of the network, read from simulation.conf:
+//
+//   sensory_modalities=Visual,Auditory,Olfactory
+//   <name>_receptors, <name>_points_per_layer, <name>_origin=x,y,z,
+//   <name>_hemisphere_offset, <name>_wiring_stride,
+//   <name>_ingest_policy=sum|latest|drop_oldest, <name>_ingest_depth   (name lower-cased)
+//
+// Visual, Auditory and Olfactory have built-in layouts and fall back to the older
+// num_pixels/num_phonels/num_scentels and *_points_per_layer keys. Any other modality
+// needs at least <name>_receptors. Each hemisphere gets its own ReceptorBank, named
+// "<Name>_Left" / "<Name>_Right".
+class SensoryModalityRegistry {
+public:
+    static std::vector<SensoryModalityConfig> readConfig(const std::map<std::string, std::string>& config);
+
+    // Creates and initialises every receptor, in modality, hemisphere, index order
+    void build(const std::vector<SensoryModalityConfig>& modalities);
+
+    // Moves a dendrite of each chosen neuron next to its receptor and associates the
+    // receptor's synaptic gap. Neurons are processed in parallel; each neuron's
+    // receptors are handled in build order, so the result does not depend on the
+    // thread count. Returns the number of gaps associated.
+    std::size_t wire(const std::vector<std::shared_ptr<Neuron>>& neurons, double proximityThreshold);
+
+    // One step of every bank; returns how many receptors changed
+    std::uint64_t update(double deltaTime);
+
+    const std::vector<std::shared_ptr<ReceptorBank>>& getBanks() const { return banks; }
+    std::size_t getReceptorCount() const;
+
+private:
+    struct Modality {
+        SensoryModalityConfig config;
+        std::vector<std::shared_ptr<ReceptorBank>> hemispheres;
+    };
+
+    std::vector<Modality> modalities;
+    std::vector<std::shared_ptr<ReceptorBank>> banks;  // All hemispheres, in build order
+};
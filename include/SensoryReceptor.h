@@ -5,19 +5,19 @@
 #include "Position.h"
 #include "SynapticGap.h"
 
+#include <atomic>
 #include <chrono>
 #include <iostream>
 #include <memory>
 #include <vector>
 #include <cmath>
-#include <mutex>
 
 class SynapticGap;
 
-class SensoryReceptor : public NeuronalComponent
+class SensoryReceptor final : public NeuronalComponent
 {
 public:
-    explicit SensoryReceptor(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent = {});
+    explicit SensoryReceptor(const Position& position, std::weak_ptr<NeuronalComponent> parent = {});
 
     ~SensoryReceptor() override = default;
 
@@ -48,10 +48,18 @@ public:
     // Setters for receptor parameters
     void setSensitivity(double sensitivity);
     void setThreshold(double threshold);
+    double getSensitivity() const;
+    double getThreshold() const;
 
-    void update(double deltaTime);
+    // Returns false if the receptor had settled and was skipped
+    bool update(double deltaTime);
+
+    // Assigned in construction order; keys the receptor's random stream
+    int getSensoryReceptorId() const;
 
 private:
+    static std::atomic<int> nextSensoryReceptorId;
+
     bool                                      instanceInitialised = false;
     std::vector<std::shared_ptr<SynapticGap>> synapticGaps;
     std::shared_ptr<SynapticGap>              synapticGap;
@@ -74,9 +82,9 @@ private:
     double sensitivity = 1.0; // How strongly the receptor responds to stimuli
     double threshold = 0.0;   // Minimum intensity required to trigger a response
 
-    // Internal state
-    double accumulatedStimulus = 0.0;
-    std::mutex receptorMutex;
+    // Internal state. stimulate() adds to it atomically from any thread and update()
+    // takes it with one exchange, so neither side locks.
+    std::atomic<double> accumulatedStimulus{0.0};
 
 };
 
@@ -1,11 +1,25 @@
 // SensoryReceptorServer.h
 
-#include "SensoryReceptor.h"
+#include "InstrumentedMutex.h"
+#include "LatencyHistogram.h"
+#include "ReceptorBank.h"
+#include "StimuliData.h"
 #include <thread>
 #include <atomic>
+#include <cstdint>
 #include <map>
+#include <string_view>
+#include <vector>
 #include "AsyncNetworkServer.h" // Custom class for network communication
+#include "DatagramReceiver.h"
+#include "SharedMemoryRing.h"
+#include "ThreadPinning.h"
 
+// Receives producer stimulus over TCP (port SENSORY_SERVER_PORT) and, if
+// SENSORY_UDP_PORT is set, also over UDP on that port, joining the IPv4 multicast
+// group SENSORY_UDP_GROUP if given. Both paths carry the same batch frames and are
+// routed to the same banks; see StimuliData.h. Producers on the same host can hand
+// over a SharedMemoryRing at registration, which a poller thread drains.
 class SensoryReceptorServer {
 public:
     SensoryReceptorServer();
@@ -16,16 +30,140 @@ public:
     bool startServer();
     void stopServer();
 
-    void registerReceptors(const std::string& receptorType,
-                           const std::vector<std::shared_ptr<SensoryReceptor>>& receptors);
+    // Banks are numbered in registration order; register them all before startServer()
+    void registerBank(std::shared_ptr<ReceptorBank> bank);
+
+    // Returns to each producer channel the credits it spent since the last call. Called
+    // once per receptor tick, after the banks were drained.
+    void grantCredits();
+
+    // Largest number of flow-controlled channels; later registrations get none
+    static constexpr std::uint32_t MAX_CHANNELS = 1024;
+
+    // Time alignment. With a latency budget, a timestamped frame is held until its
+    // capture time plus the budget and then released by releaseAlignedFrames(), so
+    // frames of different modalities captured together reach their banks on the same
+    // receptor tick however long each took to arrive. Frames arriving after their
+    // release time are late and applied at once; frames stamped in the future (clock
+    // skew) are early and held for the budget from arrival. A held frame keeps its
+    // producer's credit until it is released, so credits also bound how many frames a
+    // producer has held. 0, the default, applies every frame on arrival. Set before
+    // startServer().
+    void setLatencyBudget(std::uint64_t budgetMicros) { latencyBudgetMicros = budgetMicros; }
+    // Applies the held frames that are due; called once per receptor tick before the
+    // banks are updated. Returns how many were released.
+    std::size_t releaseAlignedFrames();
+
+    // Held frames beyond this are applied on arrival and counted as overflow
+    static constexpr std::size_t MAX_ALIGNED_FRAMES = 4096;
+
+    // Places the ingestion threads: with cpus, the server runs one TCP io thread per
+    // cpu, each pinned to its own, and the UDP receiver and ring poller are pinned to
+    // the whole set; with a priority, all of them run under SCHED_FIFO. Keeping other
+    // threads off those cpus is up to the caller. Set before initialise().
+    void setIoThreadPolicy(IoThreadPolicy policy) { ioPolicy = std::move(policy); }
 
 private:
     std::unique_ptr<AsyncNetworkServer> networkServer{};
+    std::unique_ptr<DatagramReceiver> datagramReceiver{};
     std::atomic<bool> running;
     int server_port;
     bool server_initialised = false;
-    // Map receptor type to receptors
-    std::map<std::string, std::vector<std::shared_ptr<SensoryReceptor>>> receptorMap;
+    // Indexed by the bank id handed out at channel registration
+    std::vector<std::shared_ptr<ReceptorBank>> banks;
+    std::map<std::string, std::uint32_t> bankIds;  // Bank name -> id, only used at registration
+
+    // Producer channels, indexed by channel id (0 is unused). Batches look slots up
+    // without a lock; channelMutex serialises registrations and disconnects. A slot is
+    // freed when its client disconnects and reused by a later registration; its
+    // generation changes whenever it is freed or re-registered, so credits of frames
+    // queued under an earlier owner are not returned to the new one.
+    static constexpr std::uint32_t FREE_CHANNEL = 0xFFFFFFFFu;  // bankId of a free slot
+    struct Channel {
+        std::atomic<int> clientId{0};
+        std::atomic<std::uint32_t> bankId{FREE_CHANNEL};
+        std::atomic<std::uint32_t> generation{0};
+        std::atomic<std::uint32_t> spent{0};  // Credits consumed by the bank since the last grant
+
+        // UDP loss accounting, updated by the receive thread
+        std::atomic<bool> sequenced{false};
+        std::atomic<std::uint32_t> nextSequence{0};
+        std::atomic<std::uint64_t> datagramsReceived{0};
+        std::atomic<std::uint64_t> datagramsLost{0};
+        std::atomic<std::uint64_t> datagramsLate{0};
+    };
+    std::unique_ptr<Channel[]> channels{new Channel[MAX_CHANNELS]};
+    std::atomic<std::uint32_t> channelCount{1};
+    InstrumentedMutex channelMutex{"SensoryReceptorServer::channelMutex"};
+    std::atomic<std::uint64_t> datagramsMalformed{0};
+    std::atomic<std::uint64_t> datagramsUnsequenced{0};  // Routed, but not from a registered channel
+    std::vector<std::uint64_t> releasedCredits;  // Receptor thread only
+
+    // A batch's credit tag names its channel slot and the slot's generation; 0 means
+    // the frame spent no credit. The credit goes back to the producer once the bank
+    // has consumed the frame: at once for Sum and Latest banks, when it leaves the
+    // queue for DropOldest banks.
+    static std::uint64_t creditTag(std::uint32_t channelId, std::uint32_t generation) {
+        return (static_cast<std::uint64_t>(generation) << 32) | channelId;
+    }
+    void stimulateBank(std::uint32_t bankId, const double* values, std::size_t count, std::uint64_t credit);
+    void returnCredit(std::uint64_t credit);
+    void releaseChannels(int clientId);
+
+    // Shared-memory rings of local producers; the poller works on a copy of the list,
+    // refreshed when ringsVersion changes
+    InstrumentedMutex ringMutex{"SensoryReceptorServer::ringMutex"};
+    std::vector<std::shared_ptr<SharedMemoryRing>> rings;
+    std::atomic<std::uint64_t> ringsVersion{0};
+    std::thread ringThread;
+    std::atomic<std::uint64_t> ringFrames{0};
+    std::atomic<std::uint64_t> ringMalformed{0};
+
+    // Ingestion thread placement; the counters record what the system allowed
+    void applyIoThreadPolicy(const std::vector<int>& cpus);
+    IoThreadPolicy ioPolicy;
+    std::atomic<std::uint32_t> ioThreadsPinned{0};
+    std::atomic<std::uint32_t> ioThreadsRealtime{0};
+    std::atomic<std::uint32_t> ioPolicyFailures{0};
+
+    // Capture timestamp to arrival at the server, over every transport
+    LatencyHistogram ingestLatency;
+
+    // Jitter buffer: a min-heap on release time, ties in arrival order. Value vectors
+    // are recycled through spareValues, so a steady stream stops allocating.
+    struct AlignedFrame {
+        std::uint64_t releaseMicros;
+        std::uint64_t arrival;
+        std::uint32_t bankId;
+        std::uint64_t credit;  // Returned on release, see creditTag()
+        std::vector<double> values;
+    };
+    void deliver(std::uint32_t bankId, const double* values, std::size_t count, std::uint64_t timestampMicros,
+                 std::uint64_t credit = 0);
+    boost::json::value alignmentStatistics() const;
+    std::uint64_t latencyBudgetMicros = 0;
+    mutable InstrumentedMutex alignmentMutex{"SensoryReceptorServer::alignmentMutex"};
+    std::vector<AlignedFrame> alignedFrames;
+    std::vector<std::vector<double>> spareValues;
+    std::uint64_t alignedArrivals = 0;
+    std::vector<AlignedFrame> releasing;  // Receptor thread only
+    std::atomic<std::uint64_t> framesOnTime{0};
+    std::atomic<std::uint64_t> framesLate{0};
+    std::atomic<std::uint64_t> framesEarly{0};
+    std::atomic<std::uint64_t> framesOverflowed{0};
+    LatencyHistogram lateBy;
 
-    void processStimuliData(const std::string& data);
+    // Called concurrently from the network server's io threads. The bank tables are
+    // fixed once the server starts, and banks accept stimulus from any thread.
+    void processMessage(int clientId, std::string_view message);
+    void processBatch(std::string_view frame, bool spendsCredit);
+    void processDatagram(std::string_view datagram);
+    Channel* findChannel(std::uint32_t channelId, std::uint32_t bankId);
+    boost::json::value datagramStatistics() const;
+    void registerChannel(int clientId, const std::string& channel, const std::vector<StimulusFormat>& offered,
+                         const std::string& ring);
+    bool attachRing(const std::string& ringName);
+    void pollRings();
+    void processStimuliData(std::string_view data);
+    std::int64_t resolveChannel(const std::string& channel) const;
 };
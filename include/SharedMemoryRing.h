@@ -0,0 +1,147 @@
+// SharedMemoryRing.h
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Single-producer, single-consumer ring of variable-length records in POSIX shared
+// memory (/dev/shm), for processes on the same host. The producer creates the ring
+// and the consumer attaches to it by name; after that neither side makes a system
+// call per record. Records are written in place and read in place.
+//
+// Each record is a 4-byte length followed by the payload, padded to 8 bytes. A record
+// that does not fit before the end of the buffer is preceded by a wrap marker and
+// written at the start instead.
+class SharedMemoryRing {
+public:
+    static constexpr std::uint32_t MAGIC = 0x4152524Eu;  // "ARRN"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr std::size_t DEFAULT_CAPACITY = 1u << 20;
+
+    explicit SharedMemoryRing(std::string name);
+    ~SharedMemoryRing();
+    SharedMemoryRing(const SharedMemoryRing&) = delete;
+    SharedMemoryRing& operator=(const SharedMemoryRing&) = delete;
+
+    // Producer: creates the segment, capacity rounded up to a power of two. The
+    // segment is unlinked and marked closed when the producer's ring is destroyed.
+    bool create(std::size_t capacity);
+    // Consumer: maps an existing segment
+    bool attach();
+
+    const std::string& getName() const { return name; }
+    std::size_t getCapacity() const { return capacity; }
+    bool isClosed() const;  // Producer has gone
+    // A record length or the ring's counters were corrupt; drain() reads nothing more
+    bool isMalformed() const { return malformed; }
+
+    // Producer side. Reserves length bytes and lets fill(char*) write them; returns
+    // false, writing nothing, if the ring is full.
+    template <typename Fill>
+    bool tryWrite(std::size_t length, Fill&& fill);
+    bool tryWrite(std::string_view record) {
+        return tryWrite(record.size(), [&record](char* out) { std::memcpy(out, record.data(), record.size()); });
+    }
+
+    // Consumer side. Hands up to maxRecords records to onRecord(std::string_view); the
+    // view points into the ring and is released once the callback returns. Returns the
+    // number of records consumed. A corrupt ring is marked malformed instead of being
+    // read past its records.
+    template <typename Callback>
+    std::size_t drain(Callback&& onRecord, std::size_t maxRecords);
+
+private:
+    struct Header {
+        std::uint32_t magic;
+        std::uint32_t version;
+        std::uint64_t capacity;
+        alignas(64) std::atomic<std::uint64_t> head;    // Bytes written, producer only
+        alignas(64) std::atomic<std::uint64_t> tail;    // Bytes consumed, consumer only
+        alignas(64) std::atomic<std::uint32_t> closed;
+    };
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free, "Ring counters must be address-free");
+
+    static constexpr std::uint32_t WRAP_MARKER = 0xFFFFFFFFu;
+    static constexpr std::size_t LENGTH_SIZE = sizeof(std::uint32_t);
+    static constexpr std::size_t DATA_OFFSET = (sizeof(Header) + 63) & ~std::size_t{63};
+
+    static std::size_t recordSize(std::size_t length) { return (LENGTH_SIZE + length + 7) & ~std::size_t{7}; }
+    bool map(int fd, std::size_t bytes);
+
+    std::string name;
+    bool owner = false;
+    bool malformed = false;
+    std::size_t capacity = 0;
+    std::size_t mappedBytes = 0;
+    Header* header = nullptr;
+    char* data = nullptr;
+};
+
+template <typename Fill>
+bool SharedMemoryRing::tryWrite(std::size_t length, Fill&& fill) {
+    const std::size_t size = recordSize(length);
+    if (!header || size > capacity / 2) {
+        return false;
+    }
+
+    std::uint64_t head = header->head.load(std::memory_order_relaxed);
+    const std::uint64_t tail = header->tail.load(std::memory_order_acquire);
+    std::size_t offset = static_cast<std::size_t>(head & (capacity - 1));
+    const std::size_t skip = offset + size > capacity ? capacity - offset : 0;
+    if (capacity - (head - tail) < skip + size) {
+        return false;
+    }
+
+    if (skip != 0) {
+        std::memcpy(data + offset, &WRAP_MARKER, LENGTH_SIZE);
+        head += skip;
+        offset = 0;
+    }
+    const std::uint32_t recordLength = static_cast<std::uint32_t>(length);
+    std::memcpy(data + offset, &recordLength, LENGTH_SIZE);
+    fill(data + offset + LENGTH_SIZE);
+    header->head.store(head + size, std::memory_order_release);
+    return true;
+}
+
+template <typename Callback>
+std::size_t SharedMemoryRing::drain(Callback&& onRecord, std::size_t maxRecords) {
+    if (!header || malformed) {
+        return 0;
+    }
+
+    std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+    const std::uint64_t head = header->head.load(std::memory_order_acquire);
+    if (head - tail > capacity) {
+        malformed = true;
+        return 0;
+    }
+    std::size_t consumed = 0;
+    while (tail != head && consumed < maxRecords) {
+        const std::size_t offset = static_cast<std::size_t>(tail & (capacity - 1));
+        std::uint32_t length;
+        std::memcpy(&length, data + offset, LENGTH_SIZE);
+        if (length == WRAP_MARKER) {
+            if (capacity - offset > head - tail) {
+                malformed = true;
+                break;
+            }
+            tail += capacity - offset;
+            continue;
+        }
+        if (recordSize(length) > capacity - offset || recordSize(length) > head - tail) {
+            malformed = true;  // Corrupt length; stop rather than read past it
+            break;
+        }
+        onRecord(std::string_view(data + offset + LENGTH_SIZE, length));
+        tail += recordSize(length);
+        header->tail.store(tail, std::memory_order_release);
+        ++consumed;
+    }
+    header->tail.store(tail, std::memory_order_release);
+    return consumed;
+}
@@ -14,10 +14,10 @@ class SynapticGap;
 class DendriteBranch;
 class Neuron;
 
-class Soma : public NeuronalComponent
+class Soma final : public NeuronalComponent
 {
 public:
-    explicit Soma(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit Soma(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~Soma() override = default;
 
@@ -30,7 +30,10 @@ public:
     [[nodiscard]] const std::vector<std::shared_ptr<DendriteBranch>>& getDendriteBranches() const;
     void updateFromNeuron(std::shared_ptr<Neuron> parentPointer);
     [[nodiscard]] std::shared_ptr<Neuron> getParentNeuron() const;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
     void setSomaId(int id);
     int getSomaId() const;
 
@@ -0,0 +1,29 @@
+// StatsRegistry.h
+#pragma once
+
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <boost/json.hpp>
+
+// Process-wide collection point for runtime statistics. Subsystems register a
+// provider under a name; snapshot() calls every provider and returns one JSON
+// object keyed by provider name.
+class StatsRegistry {
+public:
+    using Provider = std::function<boost::json::value()>;
+
+    static StatsRegistry& instance();
+
+    void registerProvider(const std::string& name, Provider provider);
+    void unregisterProvider(const std::string& name);
+
+    boost::json::object snapshot() const;
+
+private:
+    StatsRegistry() = default;
+
+    mutable std::mutex providerMutex;
+    std::map<std::string, Provider> providers;
+};
@@ -1,14 +1,28 @@
 // StimuliData.h
 #pragma once
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <string>
+#include <string_view>
 #include <vector>
+#include <netinet/in.h>
 #include <boost/json.hpp> // JSON library
 
 struct StimuliData {
     std::string receptorType;
     std::vector<double> values;
+    std::uint64_t timestampMicros = 0;  // Capture time, microseconds since the epoch; 0 if unknown
 };
 
+// Clock of every stimulus timestamp. Producers and the server must share it, so in
+// practice they run on one host or on hosts kept in sync by NTP/PTP.
+inline std::uint64_t stimulusClockMicros() {
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
 // Serialization
 inline std::string serializeStimuliData(const StimuliData& data) {
     // Build a JSON object
@@ -22,17 +36,20 @@ inline std::string serializeStimuliData(const StimuliData& data) {
         arr.push_back(v);
     }
     obj["values"] = std::move(arr);
+    if (data.timestampMicros != 0) {
+        obj["timestamp"] = static_cast<std::int64_t>(data.timestampMicros);
+    }
 
     // Serialize the object to a string
     return boost::json::serialize(obj);
 }
 
 // Deserialization
-inline StimuliData deserializeStimuliData(const std::string& jsonString) {
+inline StimuliData deserializeStimuliData(std::string_view jsonString) {
     StimuliData data;
 
     // Parse into a boost::json::value, then get the object view
-    boost::json::value jv = boost::json::parse(jsonString);
+    boost::json::value jv = boost::json::parse(boost::json::string_view(jsonString.data(), jsonString.size()));
     const auto& obj = jv.as_object();
 
     // Extract receptorType (as_string returns a boost::json::string)
@@ -44,6 +61,360 @@ inline StimuliData deserializeStimuliData(const std::string& jsonString) {
     for (const auto& el : arr) {
         data.values.push_back(el.as_double());
     }
+    if (const auto* timestamp = obj.if_contains("timestamp")) {
+        data.timestampMicros = static_cast<std::uint64_t>(timestamp->as_int64());
+    }
 
     return data;
-}
\ No newline at end of file
+}
+
+// Channel registration and binary batches
+//
+// A producer registers its channel once with
+//   {"register": "<Modality>:<id>", "version": 1, "formats": ["f32", "f16", ...]}
+// listing the payload formats it can send, most preferred first. The server answers
+//   {"register": ..., "bank": <id>, "receptors": <count>, "version": 1, "format": "f32",
+//    "channel": <id>, "credits": <n>}
+// with bank -1 if no bank matches, and format "json" if it shares no binary format
+// with the producer. From then on the producer sends batch frames addressed by that
+// id, so the server routes each message without touching a string.
+//
+// Each batch spends one credit. The server returns credits with credit frames as the
+// simulation drains the bank, so a producer can run at most "credits" frames ahead of
+// the receptor tick. Channel 0 (or no "credits" in the reply) means no flow control.
+//
+//   offset  size  field
+//        0     1  STIMULUS_BATCH_TAG  (never '{', so batches and JSON share a connection)
+//        1     1  version             (STIMULUS_WIRE_VERSION)
+//        2     1  format              (StimulusFormat)
+//        3     1  reserved
+//        4     4  bank id
+//        8     4  value count
+//       12     4  channel id          (0 if none)
+//       16     8  timestamp           (capture time, stimulusClockMicros(); 0 if unknown)
+//       24     *  values              (little-endian f64, f32 or f16)
+//
+// Header fields are in network byte order. The payload is read straight out of the
+// receive buffer; JSON StimuliData stays accepted on the same connection for debugging.
+//
+// A producer on the same host may also name a SharedMemoryRing it created ("ring":
+// "/name" in the request). If the server can attach to it the reply carries
+// "ring": true, and the producer then writes batch frames into the ring instead of
+// the socket. Ring frames spend no credit; a full ring drops them at the producer.
+//
+// Datagram, producer to server over UDP (no credits; loss is counted instead):
+//        0     1  STIMULUS_DATAGRAM_TAG
+//        1     1  version
+//        2     2  reserved
+//        4     4  sequence number     (per channel, starting at 0)
+//        8     *  batch frame as above
+//
+// Credit frame, server to producer:
+//        0     1  STIMULUS_CREDIT_TAG
+//        1     1  version
+//        2     2  reserved
+//        4     4  channel id
+//        8     4  credits returned
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "Stimulus payloads are copied as little-endian");
+
+constexpr std::uint8_t STIMULUS_BATCH_TAG = 0xB5;
+constexpr std::uint8_t STIMULUS_WIRE_VERSION = 1;
+constexpr std::size_t STIMULUS_BATCH_HEADER_SIZE = 24;
+constexpr std::uint8_t STIMULUS_CREDIT_TAG = 0xB6;
+constexpr std::uint8_t STIMULUS_DATAGRAM_TAG = 0xB7;
+constexpr std::size_t STIMULUS_DATAGRAM_HEADER_SIZE = 8;
+constexpr std::size_t STIMULUS_CREDIT_FRAME_SIZE = 12;
+constexpr std::int64_t UNREGISTERED_BANK = -1;
+
+enum class StimulusFormat : std::uint8_t {
+    Float64 = 0,
+    Float32 = 1,
+    Float16 = 2,
+    Json = 0xFF  // Not a payload format: the channel sends StimuliData
+};
+
+inline std::size_t stimulusValueSize(StimulusFormat format) {
+    switch (format) {
+        case StimulusFormat::Float64: return 8;
+        case StimulusFormat::Float32: return 4;
+        case StimulusFormat::Float16: return 2;
+        default: return 0;
+    }
+}
+
+inline const char* stimulusFormatName(StimulusFormat format) {
+    switch (format) {
+        case StimulusFormat::Float64: return "f64";
+        case StimulusFormat::Float32: return "f32";
+        case StimulusFormat::Float16: return "f16";
+        default: return "json";
+    }
+}
+
+inline bool parseStimulusFormat(const std::string& name, StimulusFormat& format) {
+    for (auto candidate : {StimulusFormat::Float64, StimulusFormat::Float32, StimulusFormat::Float16,
+                           StimulusFormat::Json}) {
+        if (name == stimulusFormatName(candidate)) {
+            format = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// IEEE 754 binary16, round to nearest even
+inline std::uint16_t floatToHalf(float value) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    const std::uint32_t sign = (bits >> 16) & 0x8000u;
+    const std::uint32_t biasedExponent = (bits >> 23) & 0xFFu;
+    std::uint32_t mantissa = bits & 0x7FFFFFu;
+
+    if (biasedExponent == 0xFFu) {
+        return static_cast<std::uint16_t>(sign | 0x7C00u | (mantissa ? 0x200u : 0u));
+    }
+    const int exponent = static_cast<int>(biasedExponent) - 127 + 15;
+    if (exponent >= 31) {
+        return static_cast<std::uint16_t>(sign | 0x7C00u);
+    }
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            return static_cast<std::uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        const int shift = 14 - exponent;
+        std::uint32_t half = mantissa >> shift;
+        const std::uint32_t rest = mantissa & ((1u << shift) - 1);
+        const std::uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<std::uint16_t>(sign | half);
+    }
+    std::uint32_t half = (static_cast<std::uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const std::uint32_t rest = mantissa & 0x1FFFu;
+    if (rest > 0x1000u || (rest == 0x1000u && (half & 1u))) {
+        ++half;  // A carry into the exponent is still the correctly rounded value
+    }
+    return static_cast<std::uint16_t>(sign | half);
+}
+
+inline float halfToFloat(std::uint16_t half) {
+    const std::uint32_t sign = (half & 0x8000u) << 16;
+    const std::uint32_t exponent = (half >> 10) & 0x1Fu;
+    const std::uint32_t mantissa = half & 0x3FFu;
+
+    std::uint32_t bits;
+    if (exponent == 0x1Fu) {
+        bits = sign | 0x7F800000u | (mantissa << 13);
+    } else if (exponent != 0) {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    } else if (mantissa == 0) {
+        bits = sign;
+    } else {
+        const float magnitude = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -magnitude : magnitude;
+    }
+    float value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+struct StimulusBatchHeader {
+    std::uint8_t version = STIMULUS_WIRE_VERSION;
+    StimulusFormat format = StimulusFormat::Float32;
+    std::uint32_t bankId = 0;
+    std::uint32_t valueCount = 0;
+    std::uint32_t channelId = 0;
+    std::uint64_t timestampMicros = 0;
+};
+
+inline bool isStimulusBatch(std::string_view frame) {
+    return !frame.empty() && static_cast<std::uint8_t>(frame[0]) == STIMULUS_BATCH_TAG;
+}
+
+inline std::size_t stimulusBatchSize(StimulusFormat format, std::size_t valueCount) {
+    return STIMULUS_BATCH_HEADER_SIZE + valueCount * stimulusValueSize(format);
+}
+
+// Writes a batch frame of stimulusBatchSize(format, values.size()) bytes to out, e.g.
+// straight into a shared-memory ring
+inline void writeStimulusBatch(char* out, std::uint32_t bankId, std::uint32_t channelId, StimulusFormat format,
+                               std::uint64_t timestampMicros, const std::vector<double>& values) {
+    const std::size_t valueSize = stimulusValueSize(format);
+    const std::uint32_t networkId = htonl(bankId);
+    const std::uint32_t networkCount = htonl(static_cast<std::uint32_t>(values.size()));
+    const std::uint32_t networkChannel = htonl(channelId);
+    const std::uint32_t networkTimeHigh = htonl(static_cast<std::uint32_t>(timestampMicros >> 32));
+    const std::uint32_t networkTimeLow = htonl(static_cast<std::uint32_t>(timestampMicros));
+    out[0] = static_cast<char>(STIMULUS_BATCH_TAG);
+    out[1] = static_cast<char>(STIMULUS_WIRE_VERSION);
+    out[2] = static_cast<char>(format);
+    out[3] = 0;
+    std::memcpy(out + 4, &networkId, 4);
+    std::memcpy(out + 8, &networkCount, 4);
+    std::memcpy(out + 12, &networkChannel, 4);
+    std::memcpy(out + 16, &networkTimeHigh, 4);
+    std::memcpy(out + 20, &networkTimeLow, 4);
+
+    out += STIMULUS_BATCH_HEADER_SIZE;
+    for (double v : values) {
+        if (format == StimulusFormat::Float64) {
+            std::memcpy(out, &v, 8);
+        } else if (format == StimulusFormat::Float32) {
+            const float f = static_cast<float>(v);
+            std::memcpy(out, &f, 4);
+        } else {
+            const std::uint16_t h = floatToHalf(static_cast<float>(v));
+            std::memcpy(out, &h, 2);
+        }
+        out += valueSize;
+    }
+}
+
+inline std::string serializeStimulusBatch(std::uint32_t bankId, std::uint32_t channelId, StimulusFormat format,
+                                          std::uint64_t timestampMicros, const std::vector<double>& values) {
+    std::string frame(stimulusBatchSize(format, values.size()), '\0');
+    writeStimulusBatch(&frame[0], bankId, channelId, format, timestampMicros, values);
+    return frame;
+}
+
+// Validates a batch frame and reads its header. Returns false for an unknown version
+// or format, or if the length does not match the value count.
+inline bool parseStimulusBatchHeader(std::string_view frame, StimulusBatchHeader& header) {
+    if (!isStimulusBatch(frame) || frame.size() < STIMULUS_BATCH_HEADER_SIZE) {
+        return false;
+    }
+    const char* in = frame.data();
+    header.version = static_cast<std::uint8_t>(in[1]);
+    header.format = static_cast<StimulusFormat>(in[2]);
+    const std::size_t valueSize = stimulusValueSize(header.format);
+    if (header.version != STIMULUS_WIRE_VERSION || valueSize == 0) {
+        return false;
+    }
+
+    std::uint32_t networkId, networkCount, networkChannel, networkTimeHigh, networkTimeLow;
+    std::memcpy(&networkId, in + 4, 4);
+    std::memcpy(&networkCount, in + 8, 4);
+    std::memcpy(&networkChannel, in + 12, 4);
+    std::memcpy(&networkTimeHigh, in + 16, 4);
+    std::memcpy(&networkTimeLow, in + 20, 4);
+    header.bankId = ntohl(networkId);
+    header.valueCount = ntohl(networkCount);
+    header.channelId = ntohl(networkChannel);
+    header.timestampMicros = (static_cast<std::uint64_t>(ntohl(networkTimeHigh)) << 32) | ntohl(networkTimeLow);
+    return frame.size() - STIMULUS_BATCH_HEADER_SIZE == static_cast<std::size_t>(header.valueCount) * valueSize;
+}
+
+// Widens the payload of a frame accepted by parseStimulusBatchHeader into out[0, valueCount)
+inline void decodeStimulusBatch(std::string_view frame, const StimulusBatchHeader& header, double* out) {
+    const char* in = frame.data() + STIMULUS_BATCH_HEADER_SIZE;
+    switch (header.format) {
+        case StimulusFormat::Float64:
+            std::memcpy(out, in, header.valueCount * sizeof(double));
+            break;
+        case StimulusFormat::Float32:
+            for (std::uint32_t i = 0; i < header.valueCount; ++i) {
+                float f;
+                std::memcpy(&f, in + i * 4, 4);
+                out[i] = f;
+            }
+            break;
+        case StimulusFormat::Float16:
+            for (std::uint32_t i = 0; i < header.valueCount; ++i) {
+                std::uint16_t h;
+                std::memcpy(&h, in + i * 2, 2);
+                out[i] = halfToFloat(h);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+inline std::string serializeChannelRegistration(const std::string& channel, const std::vector<StimulusFormat>& formats,
+                                               const std::string& ring = "") {
+    boost::json::object obj;
+    obj["register"] = channel;
+    if (!ring.empty()) {
+        obj["ring"] = ring;
+    }
+    obj["version"] = STIMULUS_WIRE_VERSION;
+    boost::json::array names;
+    for (auto format : formats) {
+        names.push_back(boost::json::string(stimulusFormatName(format)));
+    }
+    obj["formats"] = std::move(names);
+    return boost::json::serialize(obj);
+}
+
+inline std::string serializeChannelRegistrationReply(const std::string& channel, std::int64_t bankId,
+                                                     std::size_t receptorCount, StimulusFormat format,
+                                                     std::uint32_t channelId, std::uint32_t credits,
+                                                     bool ringAttached = false) {
+    boost::json::object obj;
+    obj["register"] = channel;
+    obj["bank"] = bankId;
+    obj["receptors"] = static_cast<std::uint64_t>(receptorCount);
+    obj["version"] = STIMULUS_WIRE_VERSION;
+    obj["format"] = stimulusFormatName(format);
+    if (channelId != 0) {
+        obj["channel"] = channelId;
+        obj["credits"] = credits;
+    }
+    if (ringAttached) {
+        obj["ring"] = true;
+    }
+    return boost::json::serialize(obj);
+}
+
+inline bool isStimulusCredit(std::string_view frame) {
+    return frame.size() == STIMULUS_CREDIT_FRAME_SIZE && static_cast<std::uint8_t>(frame[0]) == STIMULUS_CREDIT_TAG;
+}
+
+inline std::string serializeStimulusCredit(std::uint32_t channelId, std::uint32_t credits) {
+    std::string frame(STIMULUS_CREDIT_FRAME_SIZE, '\0');
+    const std::uint32_t networkChannel = htonl(channelId);
+    const std::uint32_t networkCredits = htonl(credits);
+    frame[0] = static_cast<char>(STIMULUS_CREDIT_TAG);
+    frame[1] = static_cast<char>(STIMULUS_WIRE_VERSION);
+    std::memcpy(&frame[4], &networkChannel, 4);
+    std::memcpy(&frame[8], &networkCredits, 4);
+    return frame;
+}
+
+inline bool parseStimulusCredit(std::string_view frame, std::uint32_t& channelId, std::uint32_t& credits) {
+    if (!isStimulusCredit(frame) || static_cast<std::uint8_t>(frame[1]) != STIMULUS_WIRE_VERSION) {
+        return false;
+    }
+    std::uint32_t networkChannel, networkCredits;
+    std::memcpy(&networkChannel, frame.data() + 4, 4);
+    std::memcpy(&networkCredits, frame.data() + 8, 4);
+    channelId = ntohl(networkChannel);
+    credits = ntohl(networkCredits);
+    return true;
+}
+
+inline std::string serializeStimulusDatagram(std::uint32_t sequence, const std::string& batchFrame) {
+    std::string datagram(STIMULUS_DATAGRAM_HEADER_SIZE, '\0');
+    const std::uint32_t networkSequence = htonl(sequence);
+    datagram[0] = static_cast<char>(STIMULUS_DATAGRAM_TAG);
+    datagram[1] = static_cast<char>(STIMULUS_WIRE_VERSION);
+    std::memcpy(&datagram[4], &networkSequence, 4);
+    datagram += batchFrame;
+    return datagram;
+}
+
+// Splits a datagram into its sequence number and the batch frame it carries
+inline bool parseStimulusDatagram(std::string_view datagram, std::uint32_t& sequence, std::string_view& batchFrame) {
+    if (datagram.size() < STIMULUS_DATAGRAM_HEADER_SIZE
+        || static_cast<std::uint8_t>(datagram[0]) != STIMULUS_DATAGRAM_TAG
+        || static_cast<std::uint8_t>(datagram[1]) != STIMULUS_WIRE_VERSION) {
+        return false;
+    }
+    std::uint32_t networkSequence;
+    std::memcpy(&networkSequence, datagram.data() + 4, 4);
+    sequence = ntohl(networkSequence);
+    batchFrame = datagram.substr(STIMULUS_DATAGRAM_HEADER_SIZE);
+    return true;
+}
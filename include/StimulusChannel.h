@@ -0,0 +1,85 @@
+// StimulusChannel.h
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "AsyncNetworkClient.h"
+#include "SharedMemoryRing.h"
+#include "StimuliData.h"
+
+// Producer end of one stimulus stream to the SensoryReceptorServer. The channel
+// ("<Modality>:<id>") is registered with the server, which answers with a bank id and
+// the payload format to use; once that arrives every send() is a binary batch
+// addressed by the id. Until then values go out as JSON StimuliData and each send()
+// repeats the registration request, so a request made before the connection was up
+// is not lost. If the server has no bank for the channel it stays on JSON and stops
+// asking.
+//
+// Registration also grants a credit window; each batch spends a credit and the server
+// returns them as the simulation drains the receptors. A send() with no credit left
+// is dropped here (counted by getThrottledFrames()), so a producer that outruns the
+// receptor tick sheds frames instead of queueing them.
+//
+// The preferred format defaults to f32 and can be overridden with the
+// STIMULUS_WIRE_FORMAT environment variable (f64, f32, f16, or json to keep every
+// message readable while debugging).
+//
+// With STIMULUS_UDP_TARGET=<host>:<port> (a unicast or multicast address the server
+// listens on), registered batches go out as sequence-numbered UDP datagrams instead;
+// they spend no credit, and loss is counted on the server. Registration and batches
+// too large for one datagram still use TCP.
+//
+// With STIMULUS_SHM_RING=<bytes> the channel creates a SharedMemoryRing of that size
+// and offers it at registration; a server on the same host attaches and registered
+// batches are then written straight into the ring. Like datagrams they spend no
+// credit; a full ring drops the frame and counts it as throttled. The ring has a
+// single producer, so send() must then only be called from one thread.
+class StimulusChannel {
+public:
+    StimulusChannel(AsyncNetworkClient& client, std::string channel,
+                    StimulusFormat preferredFormat = StimulusFormat::Float32);
+    ~StimulusChannel();
+    StimulusChannel(const StimulusChannel&) = delete;
+    StimulusChannel& operator=(const StimulusChannel&) = delete;
+
+    // Installs the reply handler on the client; call before the first send() and again
+    // before each reconnect
+    void open();
+    // captureMicros is when the values were captured (stimulusClockMicros()); the
+    // server can use it to align modalities. 0 stamps the frame with the send time.
+    // Returns false if the frame was dropped for lack of credit or ring or queue space,
+    // or because the client's connection has failed.
+    bool send(const std::vector<double>& values, std::uint64_t captureMicros = 0);
+
+    bool isRegistered() const { return bankId.load(std::memory_order_acquire) >= 0; }
+    const std::string& getChannel() const { return channel; }
+    StimulusFormat getFormat() const { return format.load(std::memory_order_relaxed); }
+    std::uint64_t getThrottledFrames() const { return throttledFrames.load(std::memory_order_relaxed); }
+    // Bytes of the frames send() accepted, as handed to the ring, socket or client
+    std::uint64_t getBytesSent() const { return bytesSent.load(std::memory_order_relaxed); }
+
+private:
+    void onReply(const std::string& message);
+    void openDatagramSocket(const std::string& target);
+    void createRing(const std::string& size);
+
+    AsyncNetworkClient& client;
+    std::string channel;
+    std::vector<StimulusFormat> offeredFormats;  // Most preferred first
+    std::atomic<std::int64_t> bankId;
+    std::atomic<StimulusFormat> format{StimulusFormat::Json};
+    std::atomic<bool> refused{false};
+    std::atomic<std::uint32_t> channelId{0};      // 0: the server does no flow control
+    std::atomic<std::int64_t> credits{0};
+    std::atomic<std::uint64_t> throttledFrames{0};
+    std::atomic<std::uint64_t> bytesSent{0};
+
+    int datagramSocket = -1;               // Connected UDP socket, or -1 for TCP only
+    std::atomic<std::uint32_t> datagramSequence{0};
+
+    std::unique_ptr<SharedMemoryRing> ring;  // Offered to the server, or null
+    std::atomic<bool> ringAttached{false};
+};
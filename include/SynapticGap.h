@@ -16,16 +16,19 @@ class AxonBouton;
 class SensoryReceptor;
 class AxonHillock;
 
-class SynapticGap : public NeuronalComponent
+class SynapticGap final : public NeuronalComponent
 {
 public:
-    explicit SynapticGap(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent);
+    explicit SynapticGap(const Position& position, std::weak_ptr<NeuronalComponent> parent);
 
     ~SynapticGap() override = default;
 
     // Override methods from NeuronalComponent
     void initialise() override;
-    void update(double deltaTime);
+    // Returns false if nothing in this component's subtree changed
+    bool update(double deltaTime);
+    // Appends this component and everything update() reaches from it, in update order
+    void collectComponents(std::vector<NeuronalComponent*>& components);
 
     // SynapticGap-specific methods
     // Method to check if the SynapticGap has been associated
@@ -0,0 +1,26 @@
+// ThreadPinning.h
+#pragma once
+
+#include <string>
+#include <vector>
+
+// CPU placement of latency-critical threads (Linux). The sensory ingestion threads can
+// be pinned to dedicated cores and optionally run under SCHED_FIFO, while the rest of
+// the process is kept off those cores.
+struct IoThreadPolicy {
+    std::vector<int> cpus;      // Empty: no pinning
+    int realtimePriority = 0;   // SCHED_FIFO priority 1-99; 0 keeps the normal scheduler
+};
+
+// Parses "2,3" or "4-7,10" into a sorted list of distinct CPU numbers
+bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+std::string formatCpuList(const std::vector<int>& cpus);
+
+// Each returns false (leaving the thread as it was) if the system refuses, e.g.
+// without CAP_SYS_NICE for SCHED_FIFO
+bool pinCurrentThread(const std::vector<int>& cpus);
+bool makeCurrentThreadRealtime(int priority);
+
+// Removes cpus from the calling thread's affinity. Threads it creates afterwards,
+// including the OpenMP pool if it is not yet running, inherit the narrower set.
+bool excludeCpusFromCurrentThread(const std::vector<int>& cpus);
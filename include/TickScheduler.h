@@ -0,0 +1,115 @@
+// TickScheduler.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <boost/json.hpp>
+
+// Fixed-rate loop driver. Each tick has an absolute deadline (start + n * period)
+// and the scheduler sleeps *until* that deadline rather than *for* a period, so the
+// tick rate does not drift with the amount of work done per tick.
+//
+// A tick runs a list of phases in order. Each phase receives the wall-clock time
+// since its own previous run, so skipped ticks are covered by a larger deltaTime
+// rather than lost.
+//
+// When a tick finishes after the next deadline it is counted as an overrun; if the
+// scheduler falls more than a whole period behind, the missed ticks are skipped
+// instead of being replayed back to back. A periodic phase runs on the first tick at
+// or past each multiple of its everyNTicks, so skipped indices never make it miss its
+// turn. While the recent load (work time / period) stays high, phases marked
+// sheddable run SHED_FACTOR times less often, by the same rule, until the load drops
+// again.
+//
+// Statistics are exported through StatsRegistry as "scheduler.<name>" and remain
+// there after the scheduler is destroyed.
+class TickScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using PhaseFunction = std::function<void(double deltaTime)>;
+
+    struct Phase {
+        std::string name;
+        PhaseFunction run;
+        unsigned everyNTicks = 1;  // Run on the ticks whose index reaches a multiple of N
+        bool sheddable = false;    // May run less often while the scheduler is overloaded
+    };
+
+    static constexpr unsigned SHED_FACTOR = 4;
+    static constexpr double OVERLOAD_ENTER = 0.9;  // Smoothed load above which shedding starts
+    static constexpr double OVERLOAD_EXIT = 0.7;   // Smoothed load below which shedding stops
+
+    TickScheduler(const std::string& name, Clock::duration period);
+    TickScheduler(const TickScheduler&) = delete;
+    TickScheduler& operator=(const TickScheduler&) = delete;
+
+    void addPhase(Phase phase);
+
+    // Runs ticks until running becomes false or maxTicks ticks have run (0 = no limit).
+    void run(const std::atomic<bool>& running, std::uint64_t maxTicks = 0);
+
+    // Waits for the next deadline and runs one tick.
+    void tick();
+
+    bool isOverloaded() const { return overloaded; }
+    boost::json::object statistics() const;
+
+private:
+    struct PhaseState {
+        Phase phase;
+        Clock::time_point lastRun{};
+        std::uint64_t nextDueTick = 0;       // Next multiple of everyNTicks
+        std::uint64_t nextUnshedTick = 0;    // Next multiple of everyNTicks * SHED_FACTOR after the last run
+        bool ranThisTick = false;
+        bool shedThisTick = false;
+        double secondsThisTick = 0.0;
+    };
+
+    struct PhaseCounters {
+        std::string name;
+        std::uint64_t runs = 0;
+        std::uint64_t shed = 0;
+        double totalSeconds = 0.0;
+        double maxSeconds = 0.0;
+    };
+
+    struct Statistics {
+        mutable std::mutex mutex;
+        double periodSeconds = 0.0;
+        std::uint64_t ticks = 0;
+        std::uint64_t overruns = 0;
+        std::uint64_t skippedTicks = 0;
+        std::uint64_t overloadEpisodes = 0;
+        double totalJitterSeconds = 0.0;
+        double maxJitterSeconds = 0.0;
+        double totalWorkSeconds = 0.0;
+        double maxWorkSeconds = 0.0;
+        double smoothedLoad = 0.0;
+        bool overloaded = false;
+        std::vector<PhaseCounters> phases;
+
+        boost::json::object toJson() const;
+    };
+
+    bool isShed(const PhaseState& state) const;
+    void publish(double jitterSeconds, double workSeconds, bool overrun, std::uint64_t skipped, bool enteredOverload);
+
+    std::string name;
+    std::string statsKey;
+    Clock::duration period;
+    Clock::time_point nextDeadline{};
+    bool started = false;
+    std::uint64_t tickIndex = 0;
+    double smoothedLoad = 0.0;
+    std::atomic<bool> overloaded{false};
+    std::vector<PhaseState> phases;
+
+    // Shared with the StatsRegistry provider
+    std::shared_ptr<Statistics> stats;
+};
@@ -0,0 +1,63 @@
+// TripleBuffer.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Lock-free single-producer / single-consumer handoff of the latest value.
+//
+// The producer fills writeBuffer() and calls publish(); the consumer calls
+// acquire() and, if it returns true, reads readBuffer(). Neither side ever
+// waits for the other: a slow consumer simply skips intermediate values, and
+// the producer always has a free slot to write into. Slots are reused, so
+// buffers holding vectors keep their capacity between publishes.
+//
+// Every publish is stamped with a monotonically increasing version so the
+// consumer can tell how many values it skipped.
+template <typename T>
+class TripleBuffer {
+public:
+    // Producer side
+    T& writeBuffer() { return slots[writeIndex].value; }
+
+    void publish()
+    {
+        slots[writeIndex].version = ++producerVersion;
+        std::uint8_t previous = middle.exchange(static_cast<std::uint8_t>(writeIndex | FRESH_BIT),
+                                                std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+    }
+
+    std::uint64_t publishedVersion() const { return producerVersion; }
+
+    // Consumer side. Returns false (and leaves readBuffer() unchanged) if nothing
+    // new has been published since the previous acquire.
+    bool acquire()
+    {
+        if ((middle.load(std::memory_order_relaxed) & FRESH_BIT) == 0) {
+            return false;
+        }
+        std::uint8_t previous = middle.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& readBuffer() const { return slots[readIndex].value; }
+    std::uint64_t readVersion() const { return slots[readIndex].version; }
+
+private:
+    static constexpr std::uint8_t INDEX_MASK = 0x3;
+    static constexpr std::uint8_t FRESH_BIT = 0x4;
+
+    struct Slot {
+        T value{};
+        std::uint64_t version = 0;
+    };
+
+    std::array<Slot, 3> slots;
+    std::uint8_t writeIndex = 0;                 // Owned by the producer
+    std::uint8_t readIndex = 1;                  // Owned by the consumer
+    std::atomic<std::uint8_t> middle{2};         // Shared; FRESH_BIT set when it holds an unread value
+    std::uint64_t producerVersion = 0;           // Owned by the producer
+};
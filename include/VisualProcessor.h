@@ -1,6 +1,7 @@
 // VisualProcessor.h
 #pragma once
 
+#include <cstdint>
 #include <vector>
 #include <memory>
 #include <atomic>
@@ -9,6 +10,8 @@
 #include <opencv2/core/mat.hpp>
 #include "SensoryReceptor.h"
 #include "AsyncNetworkClient.h"
+#include "ProcessorMetrics.h"
+#include "StimulusChannel.h"
 
 // VisualProcessor captures frames from a video source, processes them,
 // and transmits data over the network via AsyncNetworkClient.
@@ -21,7 +24,9 @@ public:
     void startProcessing();
     void stopProcessing();
 
-    bool isHealthy() const;
+    bool isHealthy() const;  // Connecting or connected; false once the connection fails
+    bool isConnected() const;  // The connection is established
+    boost::json::object getMetrics() const;  // Pipeline counters, see ProcessorMetrics
     void setVisualReceptors(const std::vector<std::shared_ptr<SensoryReceptor>>& receptors);
 
 private:
@@ -30,10 +35,12 @@ private:
     std::atomic<bool> healthy;
     std::thread processingThread;
 
+    std::unique_ptr<StimulusChannel> stimulusChannel;  // "Visual:<id>"
     std::unique_ptr<AsyncNetworkClient> networkClient;
     std::vector<std::shared_ptr<SensoryReceptor>> visualReceptors;
+    ProcessorMetrics metrics;  // Frames are processed as captured, so the queue depth stays 0
 
     void captureVisualData();
-    void processVisualData(cv::Mat& frame);
+    void processVisualData(cv::Mat& frame, std::uint64_t captureMicros);
     void stimulateReceptors(double intensity);
 };
@@ -10,7 +10,8 @@
 #include <functional> // For std::function
 #include <atomic>     // For std::atomic
 #include <mutex>      // For std::mutex
-#include <condition_variable> // For std::condition_variable
+#include <condition_variable> // For std::condition_variable_any
+#include "InstrumentedMutex.h"
 
 // Forward declarations for your AARNN entity classes.
 // These are essential to avoid circular dependencies and allow shared_ptr usage.
@@ -29,12 +30,49 @@ class Dendrite;
 class DendriteBouton;
 class Position; // Assuming Position is a simple struct/class with x,y,z members
 
+/**
+ * @brief State of one component as written by the periodic database update.
+ *
+ * `propagationRate` is only meaningful for clusters and neurons.
+ */
+struct ComponentState {
+    int id;
+    double x, y, z;
+    double energyLevel;
+    double maxEnergyLevel;
+    double propagationRate;
+};
+
+/**
+ * @brief Plain-data copy of the network state, one vector per database table.
+ *
+ * Decouples persistence from simulation: the simulation thread captures a snapshot
+ * and hands it over (see TripleBuffer.h); the database thread writes it at its own
+ * rate without touching the live network.
+ */
+struct NetworkSnapshot {
+    std::vector<ComponentState> clusters;
+    std::vector<ComponentState> neurons;
+    std::vector<ComponentState> somas;
+    std::vector<ComponentState> axonHillocks;
+    std::vector<ComponentState> axons;
+    std::vector<ComponentState> axonBoutons;
+    std::vector<ComponentState> synapticGaps;
+    std::vector<ComponentState> axonBranches;
+    std::vector<ComponentState> dendriteBranches;
+    std::vector<ComponentState> dendrites;
+    std::vector<ComponentState> dendriteBoutons;
+
+    void clear();
+    std::size_t size() const;
+};
+
 // Global atomic flags and mutexes, externed from main.cpp.
 // These are used for thread synchronization in updateDatabase.
 extern std::atomic<bool> running;
 extern std::atomic<bool> dbUpdateReady;
-extern std::mutex changedNeuronsMutex;
-extern std::condition_variable cv;
+extern InstrumentedMutex changedNeuronsMutex;
+extern std::condition_variable_any cv;
 
 // --- Public Database API Functions ---
 
@@ -77,6 +115,30 @@ void prepareAllStatements(pqxx::connection& conn);
 void batch_insert_clusters(pqxx::transaction_base& txn,
                            const std::vector<std::shared_ptr<Cluster>>& clusters);
 
+/**
+ * @brief Copies the state written by the periodic database update into a snapshot.
+ *
+ * Must run on the thread that updates the clusters so the copy is consistent. The
+ * snapshot's vectors keep their capacity, so reusing one avoids reallocation.
+ * Energies of lazily evaluated (deferred) neurons are brought up to date first.
+ *
+ * @param clusters A constant reference to the vector of top-level Cluster objects.
+ * @param snapshot The snapshot to overwrite.
+ */
+void captureNetworkSnapshot(const std::vector<std::shared_ptr<Cluster>>& clusters,
+                            NetworkSnapshot& snapshot);
+
+/**
+ * @brief Writes a snapshot to the database in a single pipelined transaction.
+ *
+ * Uses the prepared statements defined in `prepareAllStatements`.
+ *
+ * @param conn The active pqxx::connection to the PostgreSQL database.
+ * @param snapshot The snapshot to persist.
+ * @throws std::exception (from pqxx) if the transaction fails.
+ */
+void flushNetworkSnapshot(pqxx::connection& conn, const NetworkSnapshot& snapshot);
+
 /**
  * @brief Continuously updates neuron-related data in the database using a pipeline.
  *
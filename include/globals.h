@@ -11,13 +11,14 @@
 #include <unordered_set>
 #include <mutex>
 #include <condition_variable>
+#include "InstrumentedMutex.h"
 #include "Neuron.h"
 
 extern std::unordered_set<std::shared_ptr<Neuron>> changedNeurons;
 extern std::unordered_set<std::shared_ptr<Cluster>> changedClusters;
-extern std::mutex changedNeuronsMutex;
+extern InstrumentedMutex changedNeuronsMutex;
 extern std::atomic<bool> running;
-extern std::condition_variable cv;
+extern std::condition_variable_any cv;
 extern std::atomic<bool> dbUpdateReady;
 
 #endif //AARNN_GLOBALS_H
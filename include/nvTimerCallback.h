@@ -38,17 +38,17 @@ class nvTimerCallback : public vtkCommand
         nvPoints->Reset();
         for(const auto &neuron: nvNeurons)
         {
-            const PositionPtr &neuronPosition = neuron->getPosition();
+            const Position &neuronPosition = neuron->getPosition();
 
             // Create a vtkIdList to hold the point indices of the line vertices
             vtkSmartPointer<vtkIdList> pointIDs = vtkSmartPointer<vtkIdList>::New();
-            pointIDs->InsertNextId(nvPoints->InsertNextPoint(neuronPosition->x, neuronPosition->y, neuronPosition->z));
+            pointIDs->InsertNextId(nvPoints->InsertNextPoint(neuronPosition.x, neuronPosition.y, neuronPosition.z));
 
-            const PositionPtr &somaPosition = neuron->getSoma()->getPosition();
+            const Position &somaPosition = neuron->getSoma()->getPosition();
             // Add the sphere centre point to the vtkPolyData
             vtkSmartPointer<vtkSphereSource> sphere = vtkSmartPointer<vtkSphereSource>::New();
             sphere->SetRadius(1.0);  // Adjust the sphere radius as needed
-            sphere->SetCenter(somaPosition->x, somaPosition->y, somaPosition->z);
+            sphere->SetCenter(somaPosition.x, somaPosition.y, somaPosition.z);
             sphere->SetThetaResolution(32);  // Set the sphere resolution
             sphere->SetPhiResolution(16);
             sphere->Update();
@@ -70,19 +70,19 @@ class nvTimerCallback : public vtkCommand
             }
 
             // Add the position of the axon hillock to the vtkPoints and vtkPolyData
-            const PositionPtr &axonHillockPosition = neuron->getSoma()->getAxonHillock()->getPosition();
+            const Position &axonHillockPosition = neuron->getSoma()->getAxonHillock()->getPosition();
             pointIDs->InsertNextId(
-             nvPoints->InsertNextPoint(axonHillockPosition->x, axonHillockPosition->y, axonHillockPosition->z));
+             nvPoints->InsertNextPoint(axonHillockPosition.x, axonHillockPosition.y, axonHillockPosition.z));
 
             // Add the position of the axon to the vtkPoints and vtkPolyData
-            const PositionPtr &axonPosition = neuron->getSoma()->getAxonHillock()->getAxon()->getPosition();
-            pointIDs->InsertNextId(nvPoints->InsertNextPoint(axonPosition->x, axonPosition->y, axonPosition->z));
+            const Position &axonPosition = neuron->getSoma()->getAxonHillock()->getAxon()->getPosition();
+            pointIDs->InsertNextId(nvPoints->InsertNextPoint(axonPosition.x, axonPosition.y, axonPosition.z));
 
             // Add the position of the axon bouton to the vtkPoints and vtkPolyData
-            const PositionPtr &axonBoutonPosition =
+            const Position &axonBoutonPosition =
              neuron->getSoma()->getAxonHillock()->getAxon()->getAxonBouton()->getPosition();
             pointIDs->InsertNextId(
-             nvPoints->InsertNextPoint(axonBoutonPosition->x, axonBoutonPosition->y, axonBoutonPosition->z));
+             nvPoints->InsertNextPoint(axonBoutonPosition.x, axonBoutonPosition.y, axonBoutonPosition.z));
 
             // Add the position of the synaptic gap to the vtkPoints and vtkPolyData
             addSynapticGapToRenderer(nvRenderer,
@@ -29,9 +29,9 @@ const int SAMPLE_RATE = 16000;
 const int FRAMES_PER_BUFFER = 256;
 typedef float SAMPLE;
 [[maybe_unused]] static int gNumNoInputs = 0;
-using PositionPtr = std::shared_ptr<Position>;
-inline std::uniform_real_distribution<> distr(-0.15, 1.0 - 0.15);
-inline std::mt19937 gen(12345);
+// Range of the random offsets of the glyphs drawn around a synaptic gap
+constexpr double SYNAPTIC_GAP_GLYPH_OFFSET_MIN = -0.15;
+constexpr double SYNAPTIC_GAP_GLYPH_OFFSET_MAX = 1.0 - 0.15;
 
 void atomic_add(std::atomic<double>& atomic_val, double value);
 
@@ -67,6 +67,23 @@ bool convertStringToBool(const std::string& value);
 
 void associateSynapticGap(Neuron& neuron1, Neuron& neuron2, double proximityThreshold);
 
+// A synapse associateSynapticGap(neuron1, neuron2, ...) would make: neuron1's axon gap
+// `gap` and neuron2's dendrite bouton `bouton`, as indices into getSynapticGapsAxon()
+// and getDendriteBoutons().
+struct SynapseCandidate {
+    size_t gap;
+    size_t bouton;
+};
+
+// Read-only half of associateSynapticGap(Neuron&, Neuron&, double): for each axon gap of
+// neuron1, the first dendrite bouton of neuron2 within range. Safe to call in parallel.
+std::vector<SynapseCandidate> findSynapseCandidates(Neuron& neuron1, Neuron& neuron2, double proximityThreshold);
+
+// Connects the candidates whose gap is still unassociated. Applying the results of
+// findSynapseCandidates in a fixed pair order gives the same wiring as calling
+// associateSynapticGap serially in that order.
+void applySynapseCandidates(Neuron& neuron1, Neuron& neuron2, const std::vector<SynapseCandidate>& candidates);
+
 void associateSynapticGap(SensoryReceptor& receptor, Neuron& neuron, double proximityThreshold);
 
 typedef CGAL::Exact_predicates_inexact_constructions_kernel K;
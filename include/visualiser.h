@@ -77,6 +77,11 @@ public:
      */
     int getUpdateInterval() const { return update_interval_ms_; }
 
+    /**
+     * @brief Sets the update interval in milliseconds; must be called before visualise().
+     */
+    void setUpdateInterval(int interval_ms) { update_interval_ms_ = interval_ms; }
+
 private:
     // Core steps
     void initializeVTKPipeline();
@@ -7,6 +7,7 @@
 #include <mutex>
 #include <set>
 #include <string>
+#include "InstrumentedMutex.h"
 
 /// A minimal thread-safe WebSocket server using WebSocket++
 class WebSocketServer {
@@ -21,7 +22,7 @@ private:
     using server_t = websocketpp::server<websocketpp::config::asio>;
     server_t ws_server_;
     std::set<websocketpp::connection_hdl, std::owner_less<websocketpp::connection_hdl>> connections_;
-    std::mutex conn_mutex_;
+    InstrumentedMutex conn_mutex_{"WebSocketServer::conn_mutex_"};
 
     void on_open(websocketpp::connection_hdl hdl);
     void on_close(websocketpp::connection_hdl hdl);
@@ -4,7 +4,7 @@
 #include "AxonHillock.h"
 #include <iostream>
 
-Axon::Axon(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+Axon::Axon(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -21,7 +21,7 @@ void Axon::initialise()
         if (!onwardAxonBouton)
         {
             onwardAxonBouton = std::make_shared<AxonBouton>(
-                    std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+                    position.offsetBy(1, 1, 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         }
         onwardAxonBouton->initialise();
         onwardAxonBouton->updateFromAxon(std::static_pointer_cast<Axon>(shared_from_this()));
@@ -30,10 +30,10 @@ void Axon::initialise()
     }
 }
 
-void Axon::update(double deltaTime)
+bool Axon::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Propagate signal if possible
     //if (canPropagateSignal())
@@ -44,13 +44,28 @@ void Axon::update(double deltaTime)
     // Update onward Axon Bouton
     if (onwardAxonBouton)
     {
-        onwardAxonBouton->update(deltaTime);
+        changed |= onwardAxonBouton->update(deltaTime);
     }
 
     // Update branches
     for (auto& axonBranch : axonBranches)
     {
-        axonBranch->update(deltaTime);
+        changed |= axonBranch->update(deltaTime);
+    }
+
+    return changed;
+}
+
+void Axon::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    if (onwardAxonBouton)
+    {
+        onwardAxonBouton->collectComponents(components);
+    }
+    for (auto& axonBranch : axonBranches)
+    {
+        axonBranch->collectComponents(components);
     }
 }
 
@@ -4,7 +4,7 @@
 #include "Neuron.h"
 #include <iostream>
 
-AxonBouton::AxonBouton(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+AxonBouton::AxonBouton(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -21,7 +21,7 @@ void AxonBouton::initialise()
         if (!onwardSynapticGap)
         {
             onwardSynapticGap = std::make_shared<SynapticGap>(
-                    std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+                    position.offsetBy(1, 1, 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         }
         onwardSynapticGap->initialise();
         onwardSynapticGap->updateFromAxonBouton(std::static_pointer_cast<AxonBouton>(shared_from_this()));
@@ -30,15 +30,26 @@ void AxonBouton::initialise()
     }
 }
 
-void AxonBouton::update(double deltaTime)
+bool AxonBouton::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Additional updates if necessary
     if (onwardSynapticGap)
     {
-        onwardSynapticGap->update(deltaTime);
+        changed |= onwardSynapticGap->update(deltaTime);
+    }
+
+    return changed;
+}
+
+void AxonBouton::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    if (onwardSynapticGap)
+    {
+        onwardSynapticGap->collectComponents(components);
     }
 }
 
@@ -3,7 +3,7 @@
 #include "utils.h"
 #include <iostream>
 
-AxonBranch::AxonBranch(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+AxonBranch::AxonBranch(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -20,7 +20,7 @@ void AxonBranch::initialise()
         if (onwardAxons.empty())
         {
             // Create a new Axon and connect it
-            auto newAxonPosition = std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1);
+            auto newAxonPosition = position.offsetBy(1, 1, 1);
             auto newAxon = std::make_shared<Axon>(newAxonPosition, std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
             connectAxon(newAxon);
 
@@ -33,28 +33,37 @@ void AxonBranch::initialise()
     }
 }
 
-void AxonBranch::update(double deltaTime)
+bool AxonBranch::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Update onward Axons
     for (auto& axon : onwardAxons)
     {
-        axon->update(deltaTime);
+        changed |= axon->update(deltaTime);
     }
 
     // Additional updates if necessary
+    return changed;
+}
+
+void AxonBranch::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    for (auto& axon : onwardAxons)
+    {
+        axon->collectComponents(components);
+    }
 }
 
 void AxonBranch::connectAxon(std::shared_ptr<Axon> axon)
 {
     auto coords = get_coordinates(static_cast<int>(onwardAxons.size() + 1),
                                   static_cast<int>(onwardAxons.size() + 1), 5);
-    auto currentPosition = axon->getPosition();
-    currentPosition->x += static_cast<double>(std::get<0>(coords));
-    currentPosition->y += static_cast<double>(std::get<1>(coords));
-    currentPosition->z += static_cast<double>(std::get<2>(coords));
+    axon->translate(static_cast<double>(std::get<0>(coords)),
+                    static_cast<double>(std::get<1>(coords)),
+                    static_cast<double>(std::get<2>(coords)));
     onwardAxons.emplace_back(std::move(axon));
 }
 
@@ -3,7 +3,7 @@
 #include "Soma.h"
 #include <iostream>
 
-AxonHillock::AxonHillock(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+AxonHillock::AxonHillock(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -21,7 +21,7 @@ void AxonHillock::initialise()
         {
             std::cout << "Creating Axon" << std::endl;
             onwardAxon = std::make_shared<Axon>(
-                    std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+                    position.offsetBy(1, 1, 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         }
 
         std::cout << "AxonHillock initialising Axon" << std::endl;
@@ -34,18 +34,28 @@ void AxonHillock::initialise()
     std::cout << "AxonHillock initialised" << std::endl;
 }
 
-void AxonHillock::update(double deltaTime)
+bool AxonHillock::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Update the onward axon
     if (onwardAxon)
     {
-        onwardAxon->update(deltaTime);
+        changed |= onwardAxon->update(deltaTime);
     }
 
     // Additional updates if necessary
+    return changed;
+}
+
+void AxonHillock::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    if (onwardAxon)
+    {
+        onwardAxon->collectComponents(components);
+    }
 }
 
 std::shared_ptr<Axon> AxonHillock::getAxon() const
@@ -6,14 +6,14 @@
 #include <mutex>
 #include <atomic>
 #include <omp.h>
-#include <random>
+#include "DeterministicRandom.h"
 
 // Initialise static member
 int Cluster::nextClusterId = 0;
-std::vector<std::shared_ptr<Position>> Cluster::existingClusterPositions;
+std::vector<Position> Cluster::existingClusterPositions;
 
 // Constructor
-Cluster::Cluster(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+Cluster::Cluster(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent), clusterId(nextClusterId++)
 {
     // Add the cluster's position to the list of existing cluster positions
@@ -23,16 +23,16 @@ Cluster::Cluster(const std::shared_ptr<Position>& position, std::weak_ptr<Neuron
 // Static method to create a new cluster
 std::shared_ptr<Cluster> Cluster::createCluster(double minDistance)
 {
-    std::shared_ptr<Position> position = generateClusterPosition(minDistance);
+    Position position = generateClusterPosition(minDistance);
     auto cluster = std::make_shared<Cluster>(position);
     return cluster;
 }
 
 // Static method to generate a position for a new cluster
-std::shared_ptr<Position> Cluster::generateClusterPosition(double minDistance)
+Position Cluster::generateClusterPosition(double minDistance)
 {
     // Generate a position that is at least minDistance away from all existing clusters
-    std::shared_ptr<Position> newPosition;
+    Position newPosition(0.0, 0.0, 0.0);
 
     const int maxAttempts = 1000;
     int attempt = 0;
@@ -43,27 +43,25 @@ std::shared_ptr<Position> Cluster::generateClusterPosition(double minDistance)
     double minY = -1000.0, maxY = 1000.0;
     double minZ = -1000.0, maxZ = 1000.0;
 
-    static std::mt19937 rng(std::random_device{}());
-    std::uniform_real_distribution<double> distX(minX, maxX);
-    std::uniform_real_distribution<double> distY(minY, maxY);
-    std::uniform_real_distribution<double> distZ(minZ, maxZ);
+    // Keyed by the ID the new cluster will receive, so each cluster's candidates depend only on the run seed
+    RandomStream rng(DeterministicRandom::Stream::ClusterPosition, static_cast<std::uint64_t>(nextClusterId));
 
     while (attempt < maxAttempts && !positionFound) {
         attempt++;
 
         // Generate random coordinates
-        double x = distX(rng);
-        double y = distY(rng);
-        double z = distZ(rng);
+        double x = rng.uniform(minX, maxX);
+        double y = rng.uniform(minY, maxY);
+        double z = rng.uniform(minZ, maxZ);
 
-        newPosition = std::make_shared<Position>(x, y, z);
+        newPosition = Position(x, y, z);
 
         // Check distance to existing clusters
         positionFound = true; // Assume it's valid unless we find a cluster too close
         for (const auto& pos : existingClusterPositions) {
-            double dx = pos->x - x;
-            double dy = pos->y - y;
-            double dz = pos->z - z;
+            double dx = pos.x - x;
+            double dy = pos.y - y;
+            double dz = pos.z - z;
             double distance = sqrt(dx*dx + dy*dy + dz*dz);
             if (distance < minDistance) {
                 positionFound = false;
@@ -120,18 +118,19 @@ void Cluster::createNeurons(int num_neurons, int neuron_points_per_layer)
 {
     neurons.resize(num_neurons); // Resize to allow indexed access
 
+    // Reserve a contiguous block of IDs up front so neuron i always gets firstNeuronId + i,
+    // whichever thread constructs it
+    int firstNeuronId = Neuron::reserveNeuronIds(num_neurons);
+
     // Use OpenMP for parallel processing
 #pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < num_neurons; ++i)
     {
         auto coords = get_coordinates(i, num_neurons, neuron_points_per_layer);
 
-        double x = position->x + std::get<0>(coords);
-        double y = position->y + std::get<1>(coords);
-        double z = position->z + std::get<2>(coords);
-
-        auto neuronPosition = std::make_shared<Position>(x, y, z);
-        auto neuron = std::make_shared<Neuron>(neuronPosition, std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+        Position neuronPosition = position.offsetBy(std::get<0>(coords), std::get<1>(coords), std::get<2>(coords));
+        auto neuron = std::make_shared<Neuron>(neuronPosition, firstNeuronId + i,
+                                               std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
 
         neurons[i] = neuron; // Assign neuron to its position in the vector
     }
@@ -142,13 +141,28 @@ void Cluster::associateNeurons(double proximityThreshold)
 {
     size_t num_neurons = neurons.size();
 
-    // Use OpenMP for parallel processing
+    // Find candidate synapses in parallel (read-only), then connect them serially in
+    // (i, j) order so the wiring is the same for any thread count
+    std::vector<std::vector<std::pair<size_t, std::vector<SynapseCandidate>>>> candidates(num_neurons);
+
 #pragma omp parallel for schedule(dynamic)
     for (size_t i = 0; i < num_neurons; ++i)
     {
         for (size_t j = i + 1; j < num_neurons; ++j)
         {
-            associateSynapticGap(*neurons[i], *neurons[j], proximityThreshold);
+            auto found = findSynapseCandidates(*neurons[i], *neurons[j], proximityThreshold);
+            if (!found.empty())
+            {
+                candidates[i].emplace_back(j, std::move(found));
+            }
+        }
+    }
+
+    for (size_t i = 0; i < num_neurons; ++i)
+    {
+        for (const auto& [j, found] : candidates[i])
+        {
+            applySynapseCandidates(*neurons[i], *neurons[j], found);
         }
     }
 }
@@ -210,21 +224,153 @@ int Cluster::getClusterType() const
 void Cluster::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    stepEnergy(deltaTime);
+
+    // Advanced only after the serial pass, so energy read there catches deferred
+    // neurons up to the start of this tick
+    const double tickStart = simulationTime;
 
-    // Update each Neuron in parallel
     size_t num_neurons = neurons.size();
+    neuronRunning.assign(num_neurons, 0);
+    neuronChanged.assign(num_neurons, 0);
 
-    // Use OpenMP for parallel processing
-#pragma omp parallel for schedule(dynamic)
+    // Neurons that settled with nothing to draw may be able to draw again if this
+    // cluster has gained energy since the previous update
+    if (energyLevel > energyAfterLastUpdate)
+    {
+        for (auto& neuron : neurons)
+        {
+            if (neuron)
+            {
+                neuron->wake();
+            }
+        }
+    }
+
+    // Neurons draw energy from this cluster, so apply their energy steps serially in
+    // index order; the result then does not depend on thread scheduling. Settled
+    // neurons are skipped until something wakes them. A deferred neuron only costs its
+    // full draw, which it is guaranteed to get for as long as it stays deferred.
+    size_t active = 0;
+    size_t deferred = 0;
     for (size_t i = 0; i < num_neurons; ++i)
     {
         auto& neuron = neurons[i];
-        if (neuron)
+        if (!neuron)
+        {
+            continue;
+        }
+        if (neuron->isEnergyDeferred())
+        {
+            double draw = neuron->storedEnergyReplenishRate() * deltaTime;
+            if (neuron->canStayDeferred(tickStart, deltaTime) && energyLevel >= draw)
+            {
+                energyDrain(draw);
+                ++deferred;
+                continue;
+            }
+            neuron->endEnergyDeferral(tickStart);
+        }
+        if (neuron->beginUpdate())
         {
-            neuron->update(deltaTime);
+            neuronRunning[i] = 1;
+            neuronChanged[i] = neuron->stepEnergy(deltaTime) ? 1 : 0;
+            ++active;
+        }
+    }
+    simulationTime = tickStart + deltaTime;
+    energyAfterLastUpdate = energyLevel;
+    activeNeuronCount = active;
+    deferredNeuronCount = deferred;
+
+    // Each neuron's components only draw from that neuron, so the subtrees can run in parallel
+    const bool deferEnergy = lazyEnergy;
+    const double now = simulationTime;
+#pragma omp parallel for schedule(dynamic)
+    for (size_t i = 0; i < num_neurons; ++i)
+    {
+        if (neuronRunning[i])
+        {
+            auto& neuron = neurons[i];
+            bool changed = neuron->updateComponents(deltaTime) || neuronChanged[i];
+            neuron->endUpdate(changed);
+            if (deferEnergy && changed)
+            {
+                neuron->tryDeferEnergy(now, deltaTime);
+            }
         }
     }
 
     // Additional updates if necessary
-}
\ No newline at end of file
+}
+
+void Cluster::setLazyEnergy(bool enabled)
+{
+    lazyEnergy = enabled;
+    if (!enabled)
+    {
+        for (auto& neuron : neurons)
+        {
+            if (neuron)
+            {
+                neuron->endEnergyDeferral(simulationTime);
+            }
+        }
+    }
+}
+
+bool Cluster::isLazyEnergy() const
+{
+    return lazyEnergy;
+}
+
+void Cluster::materialiseEnergy()
+{
+    for (auto& neuron : neurons)
+    {
+        if (neuron)
+        {
+            neuron->catchUpEnergy(simulationTime);
+        }
+    }
+}
+
+#ifdef AARNN_STATE_VALIDATION
+void Cluster::measureEnergyDrift(EnergyDrift& drift)
+{
+    drift.add(getEnergyLevel(), getReferenceEnergyLevel());
+    std::vector<NeuronalComponent*> components;
+    for (auto& neuron : neurons)
+    {
+        if (neuron)
+        {
+            components.clear();
+            neuron->collectComponents(components);
+            for (const auto* component : components)
+            {
+                drift.add(component->getEnergyLevel(), component->getReferenceEnergyLevel());
+            }
+        }
+    }
+}
+#endif
+
+double Cluster::getSimulationTime() const
+{
+    return simulationTime;
+}
+
+size_t Cluster::getNeuronCount() const
+{
+    return neurons.size();
+}
+
+size_t Cluster::getActiveNeuronCount() const
+{
+    return activeNeuronCount;
+}
+
+size_t Cluster::getDeferredNeuronCount() const
+{
+    return deferredNeuronCount;
+}
@@ -3,7 +3,7 @@
 #include "Position.h"
 #include <memory>
 
-Dendrite::Dendrite(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+Dendrite::Dendrite(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -18,7 +18,7 @@ void Dendrite::initialise()
         if (!this->dendriteBouton)
         {
             this->dendriteBouton = std::make_shared<DendriteBouton>(
-                    std::make_shared<Position>(position->x - 1, position->y - 1, position->z - 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+                    position.offsetBy(-1, -1, -1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
             this->dendriteBouton->initialise();
             this->dendriteBouton->updateFromDendrite(std::static_pointer_cast<Dendrite>(shared_from_this()));
         }
@@ -56,18 +56,28 @@ std::shared_ptr<DendriteBouton> Dendrite::getDendriteBoutons()
     return dendriteBouton;
 }
 
-void Dendrite::update(double deltaTime)
+bool Dendrite::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Update the axon hillock
     if (dendriteBouton)
     {
-        dendriteBouton->update(deltaTime);
+        changed |= dendriteBouton->update(deltaTime);
     }
 
     // Additional updates if necessary
+    return changed;
+}
+
+void Dendrite::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    if (dendriteBouton)
+    {
+        dendriteBouton->collectComponents(components);
+    }
 }
 
 void Dendrite::setDendriteId(int id)
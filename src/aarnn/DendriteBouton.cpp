@@ -3,7 +3,7 @@
 #include "Neuron.h"
 #include <utility>
 
-DendriteBouton::DendriteBouton(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+DendriteBouton::DendriteBouton(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -49,10 +49,15 @@ std::shared_ptr<SynapticGap> DendriteBouton::getSynapticGap() const
     return onwardSynapticGap;
 }
 
-void DendriteBouton::update(double deltaTime)
+bool DendriteBouton::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    return stepEnergy(deltaTime);
+}
+
+void DendriteBouton::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
 }
 
 void DendriteBouton::setDendriteBoutonId(int id)
@@ -3,7 +3,7 @@
 #include "utils.h"
 #include <iostream>
 
-DendriteBranch::DendriteBranch(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+DendriteBranch::DendriteBranch(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -20,7 +20,7 @@ void DendriteBranch::initialise()
         if (onwardDendrites.empty())
         {
             // Create a new Dendrite and connect it
-            auto newDendritePosition = std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1);
+            auto newDendritePosition = position.offsetBy(1, 1, 1);
             auto newDendrite = std::make_shared<Dendrite>(newDendritePosition, std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
             connectDendrite(newDendrite);
 
@@ -37,10 +37,9 @@ void DendriteBranch::connectDendrite(std::shared_ptr<Dendrite> dendrite)
 {
     auto coords = get_coordinates(static_cast<int>(onwardDendrites.size() + 1),
                                   static_cast<int>(onwardDendrites.size() + 1), 5);
-    auto currentPosition = dendrite->getPosition();
-    currentPosition->x += static_cast<double>(std::get<0>(coords));
-    currentPosition->y += static_cast<double>(std::get<1>(coords));
-    currentPosition->z += static_cast<double>(std::get<2>(coords));
+    dendrite->translate(static_cast<double>(std::get<0>(coords)),
+                        static_cast<double>(std::get<1>(coords)),
+                        static_cast<double>(std::get<2>(coords)));
     onwardDendrites.emplace_back(std::move(dendrite));
 }
 
@@ -69,18 +68,28 @@ std::shared_ptr<Dendrite> DendriteBranch::getParentDendrite() const
     return parentDendrite;
 }
 
-void DendriteBranch::update(double deltaTime)
+bool DendriteBranch::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Update dendrites
     for (auto& dendrite : onwardDendrites)
     {
-        dendrite->update(deltaTime);
+        changed |= dendrite->update(deltaTime);
     }
 
     // Additional updates if necessary
+    return changed;
+}
+
+void DendriteBranch::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    for (auto& dendrite : onwardDendrites)
+    {
+        dendrite->collectComponents(components);
+    }
 }
 
 void DendriteBranch::setDendriteBranchId(int id)
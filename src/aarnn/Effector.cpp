@@ -2,7 +2,7 @@
 #include "SynapticGap.h"
 #include <utility>
 
-Effector::Effector(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+Effector::Effector(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
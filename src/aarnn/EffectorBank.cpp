@@ -0,0 +1,35 @@
+// EffectorBank.cpp
+#include "EffectorBank.h"
+
+#include <utility>
+
+EffectorBank::EffectorBank(std::string name, std::vector<std::shared_ptr<Effector>> bankEffectors)
+    : name(std::move(name)), effectors(std::move(bankEffectors)) {
+    rebuild();
+}
+
+void EffectorBank::rebuild() {
+    gaps.clear();
+    gapOffsets.clear();
+    gapOffsets.reserve(effectors.size() + 1);
+    gapOffsets.push_back(0);
+    for (const auto& effector : effectors) {
+        for (const auto& gap : effector->getSynapticGaps()) {
+            gaps.push_back(gap.get());
+        }
+        gapOffsets.push_back(gaps.size());
+    }
+    output.assign(effectors.size(), 0.0);
+}
+
+// getEnergyLevel() includes lazily deferred energy (see NeuronalComponent)
+const std::vector<double>& EffectorBank::readout() {
+    for (std::size_t i = 0; i < effectors.size(); ++i) {
+        double energy = 0.0;
+        for (std::size_t k = gapOffsets[i]; k < gapOffsets[i + 1]; ++k) {
+            energy += gaps[k]->getEnergyLevel();
+        }
+        output[i] = energy;
+    }
+    return output;
+}
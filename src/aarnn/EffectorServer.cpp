@@ -0,0 +1,246 @@
+// EffectorServer.cpp
+#include "EffectorServer.h"
+#include "StatsRegistry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+
+EffectorServer::EffectorServer(double deltaEpsilon, std::uint32_t keyframeInterval)
+    : deltaEpsilon(deltaEpsilon), keyframeInterval(std::max<std::uint32_t>(keyframeInterval, 1)) {}
+
+EffectorServer::~EffectorServer() {
+    stopServer();
+}
+
+bool EffectorServer::initialise() {
+    const char* portStr = std::getenv("EFFECTOR_SERVER_PORT");
+    if (!portStr) {
+        std::cout << "EFFECTOR_SERVER_PORT is not set; effector output is not streamed." << std::endl;
+        return false;
+    }
+    char* endPtr = nullptr;
+    const long port = std::strtol(portStr, &endPtr, 10);
+    if (endPtr == portStr || *endPtr != '\0' || port <= 0 || port > 65535) {
+        std::cerr << "Invalid EFFECTOR_SERVER_PORT: '" << portStr << "'." << std::endl;
+        return false;
+    }
+
+    networkServer = std::make_unique<AsyncNetworkServer>(static_cast<int>(port), 1);
+    server_initialised = networkServer->initialise();
+    if (!server_initialised) {
+        std::cerr << "Failed to initialise effector network server." << std::endl;
+    }
+    return server_initialised;
+}
+
+bool EffectorServer::startServer() {
+    if (!server_initialised) {
+        return false;
+    }
+
+    networkServer->setOnMessage([this](int clientId, std::string_view message) {
+        processMessage(clientId, message);
+    });
+    networkServer->setOnDisconnect([this](int clientId) { unsubscribe(clientId); });
+    if (!networkServer->start()) {
+        std::cerr << "Failed to start effector network server." << std::endl;
+        return false;
+    }
+
+    running = true;
+    StatsRegistry::instance().registerProvider("effectors", [this]() {
+        boost::json::object effectors;
+        std::size_t subscriptions = 0;
+        {
+            std::lock_guard<InstrumentedMutex> lock(subscriberMutex);
+            for (const auto& state : banks) {
+                subscriptions += state->subscribers.size();
+            }
+        }
+        effectors["subscriptions"] = subscriptions;
+        effectors["key_frames"] = keyframes.load(std::memory_order_relaxed);
+        effectors["delta_frames"] = deltaFrames.load(std::memory_order_relaxed);
+        effectors["bytes"] = bytesSent.load(std::memory_order_relaxed);
+        effectors["dropped_frames"] = framesDropped.load(std::memory_order_relaxed);
+        return boost::json::value(std::move(effectors));
+    });
+    return true;
+}
+
+void EffectorServer::stopServer() {
+    if (running) {
+        StatsRegistry::instance().unregisterProvider("effectors");
+        running = false;
+    }
+    if (networkServer) {
+        networkServer->stop();
+    }
+}
+
+void EffectorServer::registerBank(std::shared_ptr<EffectorBank> bank) {
+    auto inserted = bankIds.emplace(bank->getName(), static_cast<std::uint32_t>(banks.size()));
+    if (!inserted.second) {
+        std::cerr << "Duplicate effector bank " << bank->getName() << "; ignoring it." << std::endl;
+        return;
+    }
+    auto state = std::make_unique<Bank>();
+    state->lastSent.assign(bank->size(), 0.0f);
+    state->bank = std::move(bank);
+    banks.push_back(std::move(state));
+}
+
+void EffectorServer::processMessage(int clientId, std::string_view message) {
+    try {
+        boost::json::value jv = boost::json::parse(boost::json::string_view(message.data(), message.size()));
+        const auto* bankName = jv.as_object().if_contains("subscribe");
+        if (bankName) {
+            subscribe(clientId, std::string(bankName->as_string()));
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Malformed effector subscription from client " << clientId << ": " << e.what() << std::endl;
+    }
+}
+
+void EffectorServer::subscribe(int clientId, const std::string& bankName) {
+    auto it = bankIds.find(bankName);
+    if (it == bankIds.end()) {
+        networkServer->send(clientId, serializeEffectorSubscriptionReply(bankName, -1, 0));
+        return;
+    }
+
+    // Under the lock, so the reply is queued before the first output frame, which is a
+    // Key frame
+    Bank& state = *banks[it->second];
+    std::lock_guard<InstrumentedMutex> lock(subscriberMutex);
+    networkServer->send(clientId, serializeEffectorSubscriptionReply(bankName, it->second, state.bank->size()));
+    state.subscribers.push_back(Subscriber{clientId, true});
+}
+
+void EffectorServer::unsubscribe(int clientId) {
+    std::lock_guard<InstrumentedMutex> lock(subscriberMutex);
+    for (auto& state : banks) {
+        auto& subscribers = state->subscribers;
+        subscribers.erase(std::remove_if(subscribers.begin(), subscribers.end(),
+                                         [clientId](const Subscriber& s) { return s.clientId == clientId; }),
+                          subscribers.end());
+    }
+}
+
+void EffectorServer::publish(std::uint64_t tick) {
+    if (!running) {
+        return;
+    }
+    for (std::uint32_t bankId = 0; bankId < banks.size(); ++bankId) {
+        Bank& state = *banks[bankId];
+        {
+            std::lock_guard<InstrumentedMutex> lock(subscriberMutex);
+            publishTargets = state.subscribers;
+            for (auto& subscriber : state.subscribers) {
+                subscriber.keyframePending = false;
+            }
+        }
+        if (publishTargets.empty()) {
+            continue;
+        }
+
+        // The shared frame is a Key frame only if no subscriber is in sync; otherwise
+        // out-of-sync subscribers get a Key frame of lastSent, the state the Delta frame
+        // brought the others to
+        const bool allPending = std::all_of(publishTargets.begin(), publishTargets.end(),
+                                            [](const Subscriber& s) { return s.keyframePending; });
+        const std::string& encoded = encode(bankId, state, tick, allPending);
+        const bool anyPending = !allPending && std::any_of(publishTargets.begin(), publishTargets.end(),
+                                                           [](const Subscriber& s) { return s.keyframePending; });
+        const std::string& resync = anyPending ? encodeKeyframe(bankId, state, tick) : encoded;
+
+        droppedTargets.clear();
+        for (const auto& subscriber : publishTargets) {
+            const std::string& out = subscriber.keyframePending ? resync : encoded;
+            if (networkServer->send(subscriber.clientId, out, MAX_QUEUED_BYTES)) {
+                bytesSent.fetch_add(out.size(), std::memory_order_relaxed);
+            } else {
+                droppedTargets.push_back(subscriber.clientId);
+            }
+        }
+        if (droppedTargets.empty()) {
+            continue;
+        }
+        framesDropped.fetch_add(droppedTargets.size(), std::memory_order_relaxed);
+        std::lock_guard<InstrumentedMutex> lock(subscriberMutex);
+        for (auto& subscriber : state.subscribers) {
+            if (std::find(droppedTargets.begin(), droppedTargets.end(), subscriber.clientId) != droppedTargets.end()) {
+                subscriber.keyframePending = true;
+            }
+        }
+    }
+}
+
+// A Key frame of the values last sent, without reading the bank again
+const std::string& EffectorServer::encodeKeyframe(std::uint32_t bankId, const Bank& state, std::uint64_t tick) {
+    const std::size_t count = state.lastSent.size();
+    EffectorOutputHeader header;
+    header.bankId = bankId;
+    header.effectorCount = static_cast<std::uint32_t>(count);
+    header.tick = tick;
+    header.encoding = EffectorEncoding::Key;
+    header.entryCount = static_cast<std::uint32_t>(count);
+    resyncFrame.resize(EFFECTOR_OUTPUT_HEADER_SIZE + count * sizeof(float));
+    std::memcpy(&resyncFrame[EFFECTOR_OUTPUT_HEADER_SIZE], state.lastSent.data(), count * sizeof(float));
+    writeEffectorOutputHeader(&resyncFrame[0], header);
+    keyframes.fetch_add(1, std::memory_order_relaxed);
+    return resyncFrame;
+}
+
+// Builds this tick's frame for one bank in the reused frame buffer. A Delta frame that
+// would not be smaller than a Key frame is sent as a Key frame instead.
+const std::string& EffectorServer::encode(std::uint32_t bankId, Bank& state, std::uint64_t tick, bool keyframe) {
+    const std::vector<double>& output = state.bank->readout();
+    const std::size_t count = output.size();
+
+    EffectorOutputHeader header;
+    header.bankId = bankId;
+    header.effectorCount = static_cast<std::uint32_t>(count);
+    header.tick = tick;
+
+    if (!keyframe && ++state.ticksSinceKeyframe < keyframeInterval) {
+        frame.resize(EFFECTOR_OUTPUT_HEADER_SIZE + count * EFFECTOR_DELTA_ENTRY_SIZE);
+        char* out = &frame[EFFECTOR_OUTPUT_HEADER_SIZE];
+        std::uint32_t changed = 0;
+        for (std::uint32_t i = 0; i < count; ++i) {
+            const float value = static_cast<float>(output[i]);
+            if (std::fabs(value - state.lastSent[i]) <= deltaEpsilon) {
+                continue;
+            }
+            std::memcpy(out, &i, 4);
+            std::memcpy(out + 4, &value, 4);
+            out += EFFECTOR_DELTA_ENTRY_SIZE;
+            state.lastSent[i] = value;
+            ++changed;
+        }
+        if (changed * EFFECTOR_DELTA_ENTRY_SIZE < count * sizeof(float)) {
+            header.encoding = EffectorEncoding::Delta;
+            header.entryCount = changed;
+            frame.resize(EFFECTOR_OUTPUT_HEADER_SIZE + changed * EFFECTOR_DELTA_ENTRY_SIZE);
+            writeEffectorOutputHeader(&frame[0], header);
+            deltaFrames.fetch_add(1, std::memory_order_relaxed);
+            return frame;
+        }
+    }
+
+    header.encoding = EffectorEncoding::Key;
+    header.entryCount = static_cast<std::uint32_t>(count);
+    frame.resize(EFFECTOR_OUTPUT_HEADER_SIZE + count * sizeof(float));
+    char* out = &frame[EFFECTOR_OUTPUT_HEADER_SIZE];
+    for (std::size_t i = 0; i < count; ++i) {
+        state.lastSent[i] = static_cast<float>(output[i]);
+    }
+    std::memcpy(out, state.lastSent.data(), count * sizeof(float));
+    writeEffectorOutputHeader(&frame[0], header);
+    state.ticksSinceKeyframe = 0;
+    keyframes.fetch_add(1, std::memory_order_relaxed);
+    return frame;
+}
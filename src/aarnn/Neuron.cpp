@@ -1,22 +1,36 @@
 #include "Neuron.h"
 #include "Soma.h"
+#include "InstrumentedMutex.h"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <mutex>
+#include <unordered_map>
 #include <omp.h>
 
 // Initialise static member
-int Neuron::nextNeuronId = 0;
+std::atomic<int> Neuron::nextNeuronId{0};
 
 // Mutexes for thread safety
-std::mutex synapticGapsAxonMutex;
-std::mutex synapticGapsDendriteMutex;
+InstrumentedMutex synapticGapsAxonMutex("synapticGapsAxonMutex");
+InstrumentedMutex synapticGapsDendriteMutex("synapticGapsDendriteMutex");
 
 // Constructor
-Neuron::Neuron(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+Neuron::Neuron(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent), neuronId(nextNeuronId++)
 {
 }
 
+Neuron::Neuron(const Position& position, int neuronId, std::weak_ptr<NeuronalComponent> parent)
+        : NeuronalComponent(position, parent), neuronId(neuronId)
+{
+}
+
+int Neuron::reserveNeuronIds(int count)
+{
+    return nextNeuronId.fetch_add(count);
+}
+
 // Get the soma associated with the neuron
 std::shared_ptr<Soma> Neuron::getSoma()
 {
@@ -35,7 +49,7 @@ void Neuron::initialise()
         if (!this->soma)
         {
             std::cout << "Creating Soma" << std::endl;
-            // Pass the neuron's position to the soma
+            // The soma starts at the neuron's position (a copy, not an alias)
             this->soma = std::make_shared<Soma>(position, std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         }
 
@@ -103,13 +117,13 @@ void Neuron::addSynapticGapAxon(std::shared_ptr<SynapticGap> synapticGap)
 }
 
 // Traverse axons to find a specific synaptic gap
-std::shared_ptr<SynapticGap> Neuron::traverseAxons(const std::shared_ptr<Axon>& axon, const std::shared_ptr<Position>& positionPtr)
+std::shared_ptr<SynapticGap> Neuron::traverseAxons(const std::shared_ptr<Axon>& axon, const Position& targetPosition)
 {
     std::shared_ptr<AxonBouton> axonBouton = axon->getAxonBouton();
     if (axonBouton)
     {
         std::shared_ptr<SynapticGap> gap = axonBouton->getSynapticGap();
-        if (gap && gap->getPosition() == positionPtr)
+        if (gap && gap->getPosition() == targetPosition)
         {
             return gap;
         }
@@ -121,7 +135,7 @@ std::shared_ptr<SynapticGap> Neuron::traverseAxons(const std::shared_ptr<Axon>&
         const std::vector<std::shared_ptr<Axon>>& onwardAxons = branch->getAxons();
         for (const auto& onwardAxon : onwardAxons)
         {
-            std::shared_ptr<SynapticGap> gap = traverseAxons(onwardAxon, positionPtr);
+            std::shared_ptr<SynapticGap> gap = traverseAxons(onwardAxon, targetPosition);
             if (gap)
             {
                 return gap;
@@ -133,13 +147,13 @@ std::shared_ptr<SynapticGap> Neuron::traverseAxons(const std::shared_ptr<Axon>&
 }
 
 // Traverse dendrites to find a specific synaptic gap
-std::shared_ptr<SynapticGap> Neuron::traverseDendrites(const std::shared_ptr<Dendrite>& dendrite, const std::shared_ptr<Position>& positionPtr)
+std::shared_ptr<SynapticGap> Neuron::traverseDendrites(const std::shared_ptr<Dendrite>& dendrite, const Position& targetPosition)
 {
     std::shared_ptr<DendriteBouton> dendriteBouton = dendrite->getDendriteBouton();
     if (dendriteBouton)
     {
         std::shared_ptr<SynapticGap> gap = dendriteBouton->getSynapticGap();
-        if (gap && gap->getPosition() == positionPtr)
+        if (gap && gap->getPosition() == targetPosition)
         {
             return gap;
         }
@@ -151,7 +165,7 @@ std::shared_ptr<SynapticGap> Neuron::traverseDendrites(const std::shared_ptr<Den
         const std::vector<std::shared_ptr<Dendrite>>& childDendrites = branch->getDendrites();
         for (const auto& onwardDendrite : childDendrites)
         {
-            std::shared_ptr<SynapticGap> gap = traverseDendrites(onwardDendrite, positionPtr);
+            std::shared_ptr<SynapticGap> gap = traverseDendrites(onwardDendrite, targetPosition);
             if (gap)
             {
                 return gap;
@@ -172,21 +186,18 @@ void Neuron::traverseAxonsForStorage(const std::shared_ptr<Axon>& axon)
         if (gap)
         {
             // Protect shared resource with mutex
-            std::lock_guard<std::mutex> lock(synapticGapsAxonMutex);
+            std::lock_guard<InstrumentedMutex> lock(synapticGapsAxonMutex);
             synapticGapsAxon.emplace_back(std::move(gap));
         }
     }
 
     const std::vector<std::shared_ptr<AxonBranch>>& branches = axon->getAxonBranches();
-    // Parallelize the loop over branches
-#pragma omp parallel for schedule(dynamic)
+    // Serial, so gaps are stored in tree order (association visits them in this order)
     for (size_t i = 0; i < branches.size(); ++i)
     {
         const auto& branch = branches[i];
         const std::vector<std::shared_ptr<Axon>>& onwardAxons = branch->getAxons();
 
-        // Parallelize the loop over onwardAxons
-#pragma omp parallel for schedule(dynamic)
         for (size_t j = 0; j < onwardAxons.size(); ++j)
         {
             traverseAxonsForStorage(onwardAxons[j]);
@@ -197,15 +208,12 @@ void Neuron::traverseAxonsForStorage(const std::shared_ptr<Axon>& axon)
 // Traverse dendrites to store synaptic gaps
 void Neuron::traverseDendritesForStorage(const std::vector<std::shared_ptr<DendriteBranch>>& dendriteBranches)
 {
-    // Parallelize the loop over dendriteBranches
-#pragma omp parallel for schedule(dynamic)
+    // Serial, so gaps are stored in tree order (association visits them in this order)
     for (size_t i = 0; i < dendriteBranches.size(); ++i)
     {
         const auto& branch = dendriteBranches[i];
         const std::vector<std::shared_ptr<Dendrite>>& onwardDendrites = branch->getDendrites();
 
-        // Parallelize the loop over onwardDendrites
-#pragma omp parallel for schedule(dynamic)
         for (size_t j = 0; j < onwardDendrites.size(); ++j)
         {
             const auto& onwardDendrite = onwardDendrites[j];
@@ -217,7 +225,7 @@ void Neuron::traverseDendritesForStorage(const std::vector<std::shared_ptr<Dendr
                 if (gap)
                 {
                     // Protect shared resource with mutex
-                    std::lock_guard<std::mutex> lock(synapticGapsDendriteMutex);
+                    std::lock_guard<InstrumentedMutex> lock(synapticGapsDendriteMutex);
                     synapticGapsDendrite.emplace_back(std::move(gap));
                 }
             }
@@ -276,18 +284,219 @@ int Neuron::getNeuronType() const
 }
 
 // Update the neuron state over time
-void Neuron::update(double deltaTime)
+bool Neuron::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
+
+    changed |= updateComponents(deltaTime);
+    return changed;
+}
+
+bool Neuron::updateComponents(double deltaTime)
+{
+    if (!componentEntriesBuilt)
+    {
+        buildComponentEntries();
+    }
+
+    bool changed = false;
+
+    if (componentEntriesValid)
+    {
+        // The same steps in the same order as soma->update(), run over the flattened
+        // subtree: direct calls only, and no weak_ptr lock per component
+        for (size_t k = 1; k < componentEntries.size(); ++k)
+        {
+            const auto& entry = componentEntries[k];
+            changed |= entry.component->stepEnergy(deltaTime, componentEntries[entry.parentIndex].component);
+        }
+        return changed;
+    }
 
     // Update the soma
     if (this->soma)
     {
-        this->soma->update(deltaTime);
+        changed |= this->soma->update(deltaTime);
     }
 
     // Additional updates if necessary
+    return changed;
+}
+
+void Neuron::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    if (this->soma)
+    {
+        this->soma->collectComponents(components);
+    }
+}
+
+void Neuron::buildComponentEntries()
+{
+    componentEntriesBuilt = true;
+    componentEntries.clear();
+
+    std::vector<NeuronalComponent*> components;
+    collectComponents(components);
+
+    // Every component must be reached once and draw from a component earlier in the
+    // list; anything drawing from outside this neuron cannot be stepped or caught up locally
+    std::unordered_map<const NeuronalComponent*, int> indexOf;
+    componentEntriesValid = true;
+    for (size_t k = 0; k < components.size() && componentEntriesValid; ++k)
+    {
+        int parentIndex = -1;
+        if (k > 0)
+        {
+            auto parentComponent = components[k]->getParentComponent();
+            auto found = indexOf.find(parentComponent.get());
+            if (found == indexOf.end())
+            {
+                componentEntriesValid = false;
+                break;
+            }
+            parentIndex = found->second;
+        }
+        if (!indexOf.emplace(components[k], static_cast<int>(k)).second)
+        {
+            componentEntriesValid = false;
+            break;
+        }
+        componentEntries.push_back({components[k], parentIndex});
+    }
+
+    if (!componentEntriesValid)
+    {
+        componentEntries.clear();
+    }
+}
+
+bool Neuron::tryDeferEnergy(double now, double maxDeltaTime)
+{
+    if (!componentEntriesBuilt)
+    {
+        buildComponentEntries();
+    }
+    // The neuron's own draw is charged by its cluster, so it needs a parent
+    if (!componentEntriesValid || maxDeltaTime <= 0.0 || !getParentComponent())
+    {
+        return false;
+    }
+
+    // While nothing clamps, each component drains its consumption, draws its full
+    // replenishment from its parent and gives its children theirs
+    for (auto& entry : componentEntries)
+    {
+        entry.netRate = entry.component->storedEnergyReplenishRate() - entry.component->storedEnergyConsumptionRate();
+    }
+    for (const auto& entry : componentEntries)
+    {
+        if (entry.parentIndex >= 0)
+        {
+            componentEntries[entry.parentIndex].netRate -= entry.component->storedEnergyReplenishRate();
+        }
+    }
+
+    // A step of up to maxDeltaTime does not clamp while energy stays between lower and
+    // upper: neither the component's own drain nor, after its replenishment, its
+    // children's draws can take it below zero, and its full draw still fits. The
+    // horizon is how long every component stays in its range.
+    double horizon = std::numeric_limits<double>::infinity();
+    for (const auto& entry : componentEntries)
+    {
+        const double energy = entry.component->storedEnergyLevel();
+        const double consumption = entry.component->storedEnergyConsumptionRate();
+        const double replenish = entry.component->storedEnergyReplenishRate();
+        const double lower = std::max(consumption, -entry.netRate) * maxDeltaTime;
+        const double upper = entry.component->storedMaxEnergyLevel() - std::max(0.0, (replenish - consumption) * maxDeltaTime);
+        if (energy < lower || energy > upper)
+        {
+            return false;
+        }
+        if (entry.netRate < 0.0)
+        {
+            horizon = std::min(horizon, (energy - lower) / -entry.netRate);
+        }
+        else if (entry.netRate > 0.0)
+        {
+            horizon = std::min(horizon, (upper - energy) / entry.netRate);
+        }
+    }
+    if (horizon < maxDeltaTime)
+    {
+        return false;
+    }
+
+    // From the first deferral on, reading any component's energy includes the deferred
+    // change and changing it catches this neuron up first
+    for (const auto& entry : componentEntries)
+    {
+        entry.component->setLazyEnergyRate(entry.netRate);
+        if (!lazyEnergyOwnerSet)
+        {
+            entry.component->setLazyEnergyOwner(this);
+        }
+    }
+    lazyEnergyOwnerSet = true;
+
+    energyDeferred = true;
+    deferredSince = now;
+    deferredUntil = now + horizon;
+    deferralStepLimit = maxDeltaTime;
+    return true;
+}
+
+bool Neuron::isEnergyDeferred() const
+{
+    return energyDeferred;
+}
+
+bool Neuron::canStayDeferred(double tickStart, double deltaTime) const
+{
+    return energyDeferred && !hasPendingWake() && deltaTime <= deferralStepLimit &&
+           tickStart + deltaTime <= deferredUntil;
+}
+
+void Neuron::catchUpEnergy(double now)
+{
+    if (!energyDeferred)
+    {
+        return;
+    }
+    const double elapsed = now - deferredSince;
+    if (elapsed > 0.0)
+    {
+        for (const auto& entry : componentEntries)
+        {
+            entry.component->applyEnergyCatchUp(entry.netRate * elapsed);
+        }
+    }
+    deferredSince = now;
+}
+
+void Neuron::endEnergyDeferral(double now)
+{
+    catchUpEnergy(now);
+    energyDeferred = false;
+}
+
+double Neuron::deferredEnergyElapsed() const
+{
+    if (!energyDeferred || !parentCluster)
+    {
+        return 0.0;
+    }
+    return std::max(0.0, parentCluster->getSimulationTime() - deferredSince);
+}
+
+void Neuron::materialiseDeferredEnergy()
+{
+    if (energyDeferred && parentCluster)
+    {
+        catchUpEnergy(parentCluster->getSimulationTime());
+    }
 }
 
 void Neuron::updateFromCluster(std::shared_ptr<Cluster> parentPointer)
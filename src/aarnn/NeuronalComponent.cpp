@@ -1,24 +1,28 @@
 #include "NeuronalComponent.h"
 
+#include <algorithm>
 #include <utility>
 
-NeuronalComponent::NeuronalComponent(std::shared_ptr<Position> position, std::weak_ptr<NeuronalComponent> parent)
-        : position(std::move(position)), parent(std::move(parent)),
+NeuronalComponent::NeuronalComponent(const Position& position, std::weak_ptr<NeuronalComponent> parent)
+        : position(position), parent(std::move(parent)),
           energyLevel(100.0),
           maxEnergyLevel(100.0),
           energyConsumptionRate(0.005),
           energyReplenishRate(0.002)
 {
+#ifdef AARNN_STATE_VALIDATION
+    reference = {energyLevel, maxEnergyLevel, 0.005, 0.002};
+#endif
 }
 
-void NeuronalComponent::updatePosition(const std::shared_ptr<Position>& newPosition)
+void NeuronalComponent::moveTo(const Position& newPosition)
 {
     position = newPosition;
 }
 
-std::shared_ptr<Position> NeuronalComponent::getPosition() const
+void NeuronalComponent::translate(double dx, double dy, double dz)
 {
-    return position;
+    position.translate(dx, dy, dz);
 }
 
 void NeuronalComponent::setParent(std::weak_ptr<NeuronalComponent> parentComponent)
@@ -27,6 +31,11 @@ void NeuronalComponent::setParent(std::weak_ptr<NeuronalComponent> parentCompone
 
 }
 
+std::shared_ptr<NeuronalComponent> NeuronalComponent::getParentComponent() const
+{
+    return parent.lock();
+}
+
 void NeuronalComponent::initialise()
 {
     if (!instanceInitialised)
@@ -38,6 +47,16 @@ void NeuronalComponent::initialise()
 
 double NeuronalComponent::getEnergyLevel() const
 {
+    if (lazyEnergyOwner)
+    {
+        // The value the catch-up would store, computed without storing it
+        const double elapsed = lazyEnergyOwner->deferredEnergyElapsed();
+        if (elapsed > 0.0)
+        {
+            const double energy = energyLevel;
+            return std::clamp(energy + lazyEnergyRate * elapsed, 0.0, static_cast<double>(maxEnergyLevel));
+        }
+    }
     return energyLevel;
 }
 
@@ -58,11 +77,16 @@ double NeuronalComponent::getEnergyReplenishRate() const
 
 void NeuronalComponent::setEnergyLevel(double energy)
 {
+    materialiseOwner();
     energyLevel = energy;
     if (energyLevel > maxEnergyLevel)
     {
         energyLevel = maxEnergyLevel;
     }
+#ifdef AARNN_STATE_VALIDATION
+    reference.energyLevel = std::min(energy, reference.maxEnergyLevel);
+#endif
+    wake();
 }
 
 void NeuronalComponent::setMaxEnergyLevel(double maxEnergy)
@@ -72,65 +96,198 @@ void NeuronalComponent::setMaxEnergyLevel(double maxEnergy)
     {
         energyLevel = maxEnergyLevel;
     }
+#ifdef AARNN_STATE_VALIDATION
+    reference.maxEnergyLevel = maxEnergy;
+    reference.energyLevel = std::min(reference.energyLevel, maxEnergy);
+#endif
+    wake();
 }
 
 void NeuronalComponent::setEnergyConsumptionRate(double rate)
 {
     energyConsumptionRate = rate;
+#ifdef AARNN_STATE_VALIDATION
+    reference.energyConsumptionRate = rate;
+#endif
+    wake();
 }
 
 void NeuronalComponent::setEnergyReplenishRate(double rate)
 {
     energyReplenishRate = rate;
+#ifdef AARNN_STATE_VALIDATION
+    reference.energyReplenishRate = rate;
+#endif
+    wake();
 }
 
 void NeuronalComponent::energyTopup(double amount)
 {
-    energyLevel += amount;
-    if (energyLevel > maxEnergyLevel)
-    {
-        energyLevel = maxEnergyLevel;
-    }
+    materialiseOwner();
+    addStoredEnergy(amount);
+#ifdef AARNN_STATE_VALIDATION
+    reference.energyLevel = std::min(reference.energyLevel + amount, reference.maxEnergyLevel);
+#endif
 }
 
 void NeuronalComponent::energyDrain(double amount)
 {
-    energyLevel -= amount;
-    if (energyLevel < 0.0)
+    materialiseOwner();
+    addStoredEnergy(-amount);
+#ifdef AARNN_STATE_VALIDATION
+    reference.energyLevel = std::max(reference.energyLevel - amount, 0.0);
+#endif
+}
+
+void NeuronalComponent::addStoredEnergy(double amount)
+{
+    // Computed in double and narrowed once when stored
+    double energy = energyLevel + amount;
+    if (energy > maxEnergyLevel)
+    {
+        energy = maxEnergyLevel;
+    }
+    if (energy < 0.0)
     {
-        energyLevel = 0.0;
+        energy = 0.0;
     }
+    energyLevel = static_cast<state_t>(energy);
 }
 
 void NeuronalComponent::useEnergy(double amount)
 {
     energyDrain(amount);
+    wake();
 }
 
 void NeuronalComponent::updateEnergy(double deltaTime)
 {
+    stepEnergy(deltaTime);
+}
+
+bool NeuronalComponent::stepEnergy(double deltaTime)
+{
+    // Lock the weak_ptr to get a shared_ptr
+    auto parentShared = parent.lock();
+    return stepEnergy(deltaTime, parentShared.get());
+}
+
+bool NeuronalComponent::stepEnergy(double deltaTime, NeuronalComponent* parentComponent)
+{
+#ifdef AARNN_STATE_VALIDATION
+    stepReferenceEnergy(deltaTime, parentComponent);
+#endif
+
+    const double energyBefore = energyLevel;
+
     // Simulate energy consumption for maintenance
-    energyDrain(energyConsumptionRate * deltaTime);
+    addStoredEnergy(-energyConsumptionRate * deltaTime);
 
     // Simulate energy replenishment from parent
     double replenishAmount = energyReplenishRate * deltaTime;
 
-    // Lock the weak_ptr to get a shared_ptr
-    if (auto parentShared = parent.lock())
+    if (parentComponent)
     {
-        // Draw energy from parent if available
-        double availableEnergy = std::min(replenishAmount, parentShared->getEnergyLevel());
-        energyTopup(availableEnergy);
-        parentShared->energyDrain(availableEnergy);
+        // Draw energy from parent if available, but only as much as this component can
+        // hold, so a full component does not burn its parent's energy
+        double availableEnergy = std::min({replenishAmount, parentComponent->storedEnergyLevel(),
+                                           static_cast<double>(maxEnergyLevel) - energyLevel});
+        if (availableEnergy > 0.0)
+        {
+            addStoredEnergy(availableEnergy);
+            parentComponent->addStoredEnergy(-availableEnergy);
+            return true;
+        }
     }
     else
     {
         // For root components without a parent, replenish from external source
         if ( energyLevel == 0.0 ) {
             //energyTopup(replenishAmount);
-            energyTopup(100.0);
+            addStoredEnergy(100.0);
             std::cout << "Energy replenished" << std::endl;
         }
     }
+
+    return energyLevel != energyBefore;
 }
 
+bool NeuronalComponent::beginUpdate()
+{
+    // Consume a pending wake; one that arrives after this point keeps the flag set for next tick
+    bool woken = wakeRequested.load(std::memory_order_acquire) &&
+                 wakeRequested.exchange(false, std::memory_order_acq_rel);
+    if (quiescent && !woken)
+    {
+        return false;
+    }
+    quiescent = false;
+    return true;
+}
+
+void NeuronalComponent::endUpdate(bool changed)
+{
+    quiescent = !changed;
+}
+
+bool NeuronalComponent::isQuiescent() const
+{
+    return quiescent;
+}
+
+bool NeuronalComponent::hasPendingWake() const
+{
+    return wakeRequested.load(std::memory_order_acquire);
+}
+
+void NeuronalComponent::wake()
+{
+    // Whichever ancestor is gated has to run again for this component to be reached
+    std::shared_ptr<NeuronalComponent> ancestor; // Keeps the current ancestor alive while it is touched
+    for (NeuronalComponent* component = this; component != nullptr; component = ancestor.get())
+    {
+        if (!component->wakeRequested.load(std::memory_order_relaxed))
+        {
+            component->wakeRequested.store(true, std::memory_order_release);
+        }
+        ancestor = component->parent.lock();
+    }
+}
+
+void NeuronalComponent::applyEnergyCatchUp(double amount)
+{
+    addStoredEnergy(amount);
+#ifdef AARNN_STATE_VALIDATION
+    reference.energyLevel = std::clamp(reference.energyLevel + amount, 0.0, reference.maxEnergyLevel);
+#endif
+}
+
+#ifdef AARNN_STATE_VALIDATION
+double NeuronalComponent::getReferenceEnergyLevel() const
+{
+    return reference.energyLevel;
+}
+
+void NeuronalComponent::stepReferenceEnergy(double deltaTime, NeuronalComponent* parentComponent)
+{
+    // stepEnergy carried out entirely in double
+    double& energy = reference.energyLevel;
+    energy = std::max(energy - reference.energyConsumptionRate * deltaTime, 0.0);
+
+    if (parentComponent)
+    {
+        double availableEnergy = std::min({reference.energyReplenishRate * deltaTime,
+                                           parentComponent->reference.energyLevel,
+                                           reference.maxEnergyLevel - energy});
+        if (availableEnergy > 0.0)
+        {
+            energy += availableEnergy;
+            parentComponent->reference.energyLevel -= availableEnergy;
+        }
+    }
+    else if (energy == 0.0)
+    {
+        energy = std::min(100.0, reference.maxEnergyLevel);
+    }
+}
+#endif
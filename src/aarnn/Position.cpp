@@ -1,19 +1,29 @@
 #include "Position.h"
 #include "vtkincludes.h"
 
-Position::Position(double x, double y, double z) : x(x), y(y), z(z) {}
+Position::Position(double x, double y, double z)
+    : x(static_cast<coord_t>(x)), y(static_cast<coord_t>(y)), z(static_cast<coord_t>(z)) {}
 
 // Function to calculate the Euclidean distance between two positions
 [[nodiscard]] double Position::distanceTo(const Position &other) const {
-    double diff[3] = {x - other.x, y - other.y, z - other.z};
+    double diff[3] = {static_cast<double>(x) - other.x, static_cast<double>(y) - other.y,
+                      static_cast<double>(z) - other.z};
     return vtkMath::Norm(diff);
 }
 
 // Function to set the position coordinates
 void Position::setPosition(double newX, double newY, double newZ) {
-    x = newX;
-    y = newY;
-    z = newZ;
+    x = static_cast<coord_t>(newX);
+    y = static_cast<coord_t>(newY);
+    z = static_cast<coord_t>(newZ);
+}
+
+void Position::translate(double dx, double dy, double dz) {
+    setPosition(x + dx, y + dy, z + dz);
+}
+
+Position Position::offsetBy(double dx, double dy, double dz) const {
+    return {x + dx, y + dy, z + dz};
 }
 
 double Position::calcPropagationTime(const Position &position1, double propagationRate) const {
@@ -29,3 +39,7 @@ std::tuple<double, double, double> Position::getPosition() const {
     std::cout << "Position: " << x << ", " << y << ", " << z << std::endl;
     return std::make_tuple(x, y, z);
 }
+
+std::ostream &operator<<(std::ostream &stream, const Position &position) {
+    return stream << "(" << position.x << ", " << position.y << ", " << position.z << ")";
+}
@@ -1,7 +1,10 @@
 // ProcessorManager.cpp
 #include "ProcessorManager.h"
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <utility>
 
 namespace json = boost::json;
 
@@ -11,24 +14,69 @@ ProcessorManager::~ProcessorManager() {
     stopAll();
 }
 
+// An id can be registered once. Replacing a live processor would leave the old one
+// running and could release a restart still in flight under processorMutex.
 void ProcessorManager::registerAuditoryProcessor(const std::string& id, const std::string& host, unsigned short port) {
-    auto processor = std::make_shared<AuditoryProcessor>(host, port, id);
-    if (processor->initialise()) {
+    {
         std::lock_guard<std::mutex> lock(processorMutex);
-        auditoryProcessors[id] = processor;
-    } else {
+        if (auditoryProcessors.count(id) != 0) {
+            std::cerr << "Auditory processor " << id << " is already registered; ignoring it." << std::endl;
+            return;
+        }
+    }
+    auto processor = std::make_shared<AuditoryProcessor>(host, port, id);  // Destroyed after the lock if rejected
+    if (!processor->initialise()) {
         std::cerr << "Failed to initialise auditory processor: " << id << std::endl;
+        return;
+    }
+    auto supervised = supervise(id, processor);
+    std::lock_guard<std::mutex> lock(processorMutex);
+    if (!auditoryProcessors.emplace(id, processor).second) {
+        std::cerr << "Auditory processor " << id << " is already registered; ignoring it." << std::endl;
+        return;
     }
+    supervisedAuditory.push_back(std::move(supervised));
 }
 
 void ProcessorManager::registerVisualProcessor(const std::string& id, const std::string& host, unsigned short port) {
-    auto processor = std::make_shared<VisualProcessor>(host, port, id);
-    if (processor->initialise()) {
+    {
         std::lock_guard<std::mutex> lock(processorMutex);
-        visualProcessors[id] = processor;
-    } else {
+        if (visualProcessors.count(id) != 0) {
+            std::cerr << "Visual processor " << id << " is already registered; ignoring it." << std::endl;
+            return;
+        }
+    }
+    auto processor = std::make_shared<VisualProcessor>(host, port, id);
+    if (!processor->initialise()) {
         std::cerr << "Failed to initialise visual processor: " << id << std::endl;
+        return;
     }
+    auto supervised = supervise(id, processor);
+    std::lock_guard<std::mutex> lock(processorMutex);
+    if (!visualProcessors.emplace(id, processor).second) {
+        std::cerr << "Visual processor " << id << " is already registered; ignoring it." << std::endl;
+        return;
+    }
+    supervisedVisual.push_back(std::move(supervised));
+}
+
+template <typename Processor>
+std::shared_ptr<ProcessorManager::Supervised> ProcessorManager::supervise(const std::string& id,
+                                                                          const std::shared_ptr<Processor>& processor) {
+    auto supervised = std::make_shared<Supervised>();
+    supervised->id = id;
+    supervised->isHealthy = [processor]() { return processor->isHealthy(); };
+    supervised->isConnected = [processor]() { return processor->isConnected(); };
+    supervised->metrics = [processor]() { return processor->getMetrics(); };
+    supervised->restart = [processor]() {
+        processor->stopProcessing();
+        if (!processor->initialise()) {
+            return false;
+        }
+        processor->startProcessing();
+        return true;
+    };
+    return supervised;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -130,11 +178,15 @@ void ProcessorManager::startAll() {
         processor->startProcessing();
     }
     monitoring = true;
-    healthMonitorThread = std::thread(&ProcessorManager::monitorHealth, this);
+    healthMonitorThread = std::thread(&ProcessorManager::superviseProcessors, this);
 }
 
 void ProcessorManager::stopAll() {
-    monitoring = false;
+    {
+        std::lock_guard<std::mutex> lock(monitorWakeMutex);
+        monitoring = false;
+    }
+    monitorWake.notify_all();
     if (healthMonitorThread.joinable()) {
         healthMonitorThread.join();
     }
@@ -147,39 +199,143 @@ void ProcessorManager::stopAll() {
     }
     auditoryProcessors.clear();
     visualProcessors.clear();
+    supervisedAuditory.clear();
+    supervisedVisual.clear();
 }
 
-void ProcessorManager::monitorHealth() {
+// Supervisor loop. Each tick it checks every processor's health and moves its state
+// machine on; restarts run as separate tasks, so a slow reconnect only delays that
+// processor. On shutdown it waits for the attempts still in flight, so stopAll() never
+// stops a processor while a restart is starting it.
+void ProcessorManager::superviseProcessors() {
+    std::vector<std::shared_ptr<Supervised>> supervised;
     while (monitoring.load()) {
         {
             std::lock_guard<std::mutex> lock(processorMutex);
-            for (auto& [id, processor] : auditoryProcessors) {
-                if (!processor->isHealthy()) {
-                    std::cerr << "[HealthCheck] Auditory processor " << id << " is unhealthy. Attempting restart..." << std::endl;
-                    processor->stopProcessing();
-                    if (processor->initialise()) {
-                        processor->startProcessing();
-                        std::cout << "[HealthCheck] Auditory processor " << id << " recovered." << std::endl;
-                    } else {
-                        std::cerr << "[HealthCheck] Auditory processor " << id << " failed to recover." << std::endl;
-                    }
+            supervised = supervisedAuditory;
+            supervised.insert(supervised.end(), supervisedVisual.begin(), supervisedVisual.end());
+        }
+        const auto now = std::chrono::steady_clock::now();
+        for (auto& processor : supervised) {
+            advance(*processor, now);
+        }
+
+        std::unique_lock<std::mutex> lock(monitorWakeMutex);
+        monitorWake.wait_for(lock, SUPERVISOR_TICK, [this]() { return !monitoring.load(); });
+    }
+
+    for (auto& processor : supervised) {
+        if (processor->attempt.valid()) {
+            processor->attempt.wait();
+        }
+    }
+}
+
+void ProcessorManager::advance(Supervised& processor, std::chrono::steady_clock::time_point now) {
+    using std::chrono::duration_cast;
+    using std::chrono::milliseconds;
+    const auto nowMillis = duration_cast<milliseconds>(now.time_since_epoch()).count();
+
+    switch (processor.state.load()) {
+        case ProcessorState::Running:
+            if (processor.isHealthy()) {
+                if (processor.consecutiveFailures.load() != 0 && nowMillis >= processor.stableAtMillis.load()) {
+                    processor.consecutiveFailures = 0;
                 }
+                return;
             }
-            for (auto& [id, processor] : visualProcessors) {
-                if (!processor->isHealthy()) {
-                    std::cerr << "[HealthCheck] Visual processor " << id << " is unhealthy. Attempting restart..." << std::endl;
-                    processor->stopProcessing();
-                    if (processor->initialise()) {
-                        processor->startProcessing();
-                        std::cout << "[HealthCheck] Visual processor " << id << " recovered." << std::endl;
-                    } else {
-                        std::cerr << "[HealthCheck] Visual processor " << id << " failed to recover." << std::endl;
-                    }
-                }
+            if (processor.consecutiveFailures.load() != 0) {
+                // Dropped again soon after recovering; back off rather than restart at once
+                retryLater(processor, nowMillis, "became unhealthy again");
+                return;
             }
+            std::cerr << "[HealthCheck] Processor " << processor.id << " is unhealthy. Attempting restart..." << std::endl;
+            break;
+
+        case ProcessorState::Restarting: {
+            if (processor.attempt.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+                return;
+            }
+            bool recovered = false;
+            try {
+                recovered = processor.attempt.get();
+            } catch (const std::exception& e) {
+                std::cerr << "[HealthCheck] Processor " << processor.id << " restart threw: " << e.what() << std::endl;
+            }
+            if (!recovered) {
+                retryLater(processor, nowMillis, "failed to restart");
+                return;
+            }
+            // initialise() only starts the connection; wait for it to be confirmed
+            processor.retryAtMillis = nowMillis + RESTART_CONFIRM_TIMEOUT.count();
+            processor.state = ProcessorState::Verifying;
+            return;
         }
-        std::this_thread::sleep_for(std::chrono::seconds(5));
+
+        case ProcessorState::Verifying:
+            if (processor.isConnected()) {
+                processor.restarts.fetch_add(1);
+                processor.stableAtMillis = nowMillis + RESTART_STABLE_PERIOD.count();
+                processor.state = ProcessorState::Running;
+                std::cout << "[HealthCheck] Processor " << processor.id << " recovered." << std::endl;
+            } else if (!processor.isHealthy()) {
+                retryLater(processor, nowMillis, "failed to connect");
+            } else if (nowMillis >= processor.retryAtMillis.load()) {
+                retryLater(processor, nowMillis, "did not connect in time");
+            }
+            return;
+
+        case ProcessorState::Backoff:
+            if (nowMillis < processor.retryAtMillis.load()) {
+                return;
+            }
+            break;
     }
+
+    processor.state = ProcessorState::Restarting;
+    processor.attempt = std::async(std::launch::async, processor.restart);
+}
+
+// Counts a failed attempt and schedules the next one after the backoff
+void ProcessorManager::retryLater(Supervised& processor, std::int64_t nowMillis, const char* reason) {
+    const std::uint32_t failures = processor.consecutiveFailures.fetch_add(1) + 1;
+    const std::chrono::milliseconds delay = backoffFor(failures);
+    processor.retryAtMillis = nowMillis + delay.count();
+    processor.state = ProcessorState::Backoff;
+    std::cerr << "[HealthCheck] Processor " << processor.id << " " << reason << " (attempt " << failures
+              << "); retrying in " << delay.count() << " ms." << std::endl;
+}
+
+std::chrono::milliseconds ProcessorManager::backoffFor(std::uint32_t failures) {
+    std::chrono::milliseconds delay = RESTART_BACKOFF_MAX;
+    if (failures <= 16) {
+        delay = std::min(RESTART_BACKOFF_BASE * (std::int64_t{1} << (failures - 1)), RESTART_BACKOFF_MAX);
+    }
+    // Equal jitter: half fixed, half random, so processors that failed together spread out
+    std::uniform_int_distribution<std::int64_t> spread(0, delay.count() / 2);
+    return std::chrono::milliseconds(delay.count() - delay.count() / 2 + spread(jitter));
+}
+
+boost::json::object ProcessorManager::statusOf(const Supervised& processor) {
+    boost::json::object entry;
+    entry["id"] = processor.id;
+    entry["healthy"] = processor.isHealthy();
+    const ProcessorState state = processor.state.load();
+    switch (state) {
+        case ProcessorState::Running: entry["state"] = "running"; break;
+        case ProcessorState::Restarting: entry["state"] = "restarting"; break;
+        case ProcessorState::Verifying: entry["state"] = "verifying"; break;
+        case ProcessorState::Backoff: entry["state"] = "backoff"; break;
+    }
+    entry["restarts"] = processor.restarts.load();
+    entry["consecutive_failures"] = processor.consecutiveFailures.load();
+    if (state == ProcessorState::Backoff) {
+        const auto nowMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+        entry["retry_in_ms"] = std::max<std::int64_t>(0, processor.retryAtMillis.load() - nowMillis);
+    }
+    entry["metrics"] = processor.metrics();
+    return entry;
 }
 
 // ------------------------------------------------------------------------------------------------
@@ -191,23 +347,17 @@ boost::json::object ProcessorManager::getProcessorStatuses() const {
 
     // Build an array of auditory statuses
     boost::json::array auditoryArray;
-    for (const auto& [id, processor] : auditoryProcessors) {
-        boost::json::object entry;
-        entry["id"] = id;
-        entry["healthy"] = processor->isHealthy();
-        auditoryArray.push_back(std::move(entry));
+    for (const auto& processor : supervisedAuditory) {
+        auditoryArray.push_back(statusOf(*processor));
     }
     result["auditory"] = std::move(auditoryArray);
 
     // Build an array of visual statuses
     boost::json::array visualArray;
-    for (const auto& [id, processor] : visualProcessors) {
-        boost::json::object entry;
-        entry["id"] = id;
-        entry["healthy"] = processor->isHealthy();
-        visualArray.push_back(std::move(entry));
+    for (const auto& processor : supervisedVisual) {
+        visualArray.push_back(statusOf(*processor));
     }
     result["visual"] = std::move(visualArray);
 
     return result;
-}
\ No newline at end of file
+}
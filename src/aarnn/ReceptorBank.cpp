@@ -0,0 +1,180 @@
+// ReceptorBank.cpp
+#include "ReceptorBank.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+namespace {
+    // Matches the external top-up NeuronalComponent::stepEnergy gives a parentless
+    // component that has run dry
+    constexpr double REFILL_ENERGY = 100.0;
+}
+
+const char* ingestPolicyName(IngestPolicy policy) {
+    switch (policy) {
+        case IngestPolicy::Latest: return "latest";
+        case IngestPolicy::DropOldest: return "drop_oldest";
+        default: return "sum";
+    }
+}
+
+bool parseIngestPolicy(const std::string& name, IngestPolicy& policy) {
+    for (auto candidate : {IngestPolicy::Sum, IngestPolicy::Latest, IngestPolicy::DropOldest}) {
+        if (name == ingestPolicyName(candidate)) {
+            policy = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+ReceptorBank::ReceptorBank(std::string name, std::vector<std::shared_ptr<SensoryReceptor>> bankReceptors,
+                           IngestPolicy ingestPolicy, std::size_t ingestDepth)
+    : name(std::move(name)), receptors(std::move(bankReceptors)),
+      pendingStimulus(new std::atomic<double>[receptors.size()]),
+      ingestPolicy(ingestPolicy), ingestDepth(std::max<std::size_t>(ingestDepth, 1)) {
+    const std::size_t count = receptors.size();
+    processingStimulus.assign(count, 0.0);
+    if (ingestPolicy == IngestPolicy::Latest) {
+        frameQueue.assign(count, 0.0);
+    } else if (ingestPolicy == IngestPolicy::DropOldest) {
+        frameQueue.assign(count * this->ingestDepth, 0.0);
+        frameCredits.assign(this->ingestDepth, 0);
+    }
+    threshold.reserve(count);
+    sensitivity.reserve(count);
+    energyLevel.reserve(count);
+    maxEnergyLevel.reserve(count);
+    energyConsumptionRate.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& receptor = receptors[i];
+        pendingStimulus[i].store(0.0, std::memory_order_relaxed);
+        threshold.push_back(receptor->getThreshold());
+        sensitivity.push_back(receptor->getSensitivity());
+        energyLevel.push_back(static_cast<state_t>(receptor->getEnergyLevel()));
+        maxEnergyLevel.push_back(static_cast<state_t>(receptor->getMaxEnergyLevel()));
+        energyConsumptionRate.push_back(static_cast<state_t>(receptor->getEnergyConsumptionRate()));
+    }
+}
+
+void ReceptorBank::stimulate(std::size_t index, double intensity) {
+    if (index < receptors.size()) {
+        atomic_add(pendingStimulus[index], intensity);
+    }
+}
+
+void ReceptorBank::stimulate(const double* values, std::size_t count, std::uint64_t creditTag) {
+    count = std::min(count, receptors.size());
+    framesReceived.fetch_add(1, std::memory_order_relaxed);
+
+    if (ingestPolicy == IngestPolicy::Sum) {
+        for (std::size_t i = 0; i < count; ++i) {
+            atomic_add(pendingStimulus[i], values[i]);
+        }
+        framesSinceUpdate.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    std::lock_guard<InstrumentedMutex> lock(ingestMutex);
+    std::size_t slot = 0;
+    if (ingestPolicy == IngestPolicy::Latest) {
+        if (queuedFrames > 0) {
+            framesCoalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+        queuedFrames = 1;
+    } else {
+        if (queuedFrames == ingestDepth) {
+            if (frameCredits[queueHead] != 0) {
+                releasedCredits.push_back(frameCredits[queueHead]);
+            }
+            queueHead = (queueHead + 1) % ingestDepth;
+            --queuedFrames;
+            framesDropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        slot = (queueHead + queuedFrames) % ingestDepth;
+        frameCredits[slot] = creditTag;
+        ++queuedFrames;
+    }
+    double* frame = frameQueue.data() + slot * receptors.size();
+    std::copy(values, values + count, frame);
+    std::fill(frame + count, frame + receptors.size(), 0.0);
+}
+
+IngestStatistics ReceptorBank::getIngestStatistics() const {
+    IngestStatistics statistics;
+    statistics.received = framesReceived.load(std::memory_order_relaxed);
+    statistics.applied = framesApplied.load(std::memory_order_relaxed);
+    statistics.coalesced = framesCoalesced.load(std::memory_order_relaxed);
+    statistics.dropped = framesDropped.load(std::memory_order_relaxed);
+    return statistics;
+}
+
+void ReceptorBank::takeReleasedCredits(std::vector<std::uint64_t>& released) {
+    if (ingestPolicy != IngestPolicy::DropOldest) {
+        return;
+    }
+    std::lock_guard<InstrumentedMutex> lock(ingestMutex);
+    released.insert(released.end(), releasedCredits.begin(), releasedCredits.end());
+    releasedCredits.clear();
+}
+
+// Moves the frame due this update into processingStimulus (all zeros beforehand)
+void ReceptorBank::takeQueuedFrame() {
+    if (ingestPolicy == IngestPolicy::Sum) {
+        const std::uint64_t frames = framesSinceUpdate.exchange(0, std::memory_order_relaxed);
+        if (frames > 0) {
+            framesApplied.fetch_add(1, std::memory_order_relaxed);
+            framesCoalesced.fetch_add(frames - 1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    std::lock_guard<InstrumentedMutex> lock(ingestMutex);
+    if (queuedFrames == 0) {
+        return;
+    }
+    const double* frame = frameQueue.data() + queueHead * receptors.size();
+    std::copy(frame, frame + receptors.size(), processingStimulus.begin());
+    if (ingestPolicy == IngestPolicy::DropOldest) {
+        if (frameCredits[queueHead] != 0) {
+            releasedCredits.push_back(frameCredits[queueHead]);
+        }
+        queueHead = (queueHead + 1) % ingestDepth;
+    } else {
+        queueHead = 0;
+    }
+    --queuedFrames;
+    framesApplied.fetch_add(1, std::memory_order_relaxed);
+}
+
+std::uint64_t ReceptorBank::update(double deltaTime) {
+    const long count = static_cast<long>(receptors.size());
+    takeQueuedFrame();
+    for (long i = 0; i < count; ++i) {
+        processingStimulus[i] += pendingStimulus[i].exchange(0.0, std::memory_order_relaxed);
+    }
+
+    // Same arithmetic as SensoryReceptor::update on a parentless receptor: maintenance
+    // drain, refill when empty, then the stimulus if it reaches the threshold. Written
+    // without early exits so the loop vectorises.
+    std::uint64_t changed = 0;
+#pragma omp parallel for simd reduction(+ : changed) if (receptors.size() >= PARALLEL_UPDATE_THRESHOLD)
+    for (long i = 0; i < count; ++i) {
+        const double before = energyLevel[i];
+        const double maximum = maxEnergyLevel[i];
+
+        double energy = std::clamp(before - energyConsumptionRate[i] * deltaTime, 0.0, maximum);
+        energy = energy == 0.0 ? std::min(REFILL_ENERGY, maximum) : energy;
+
+        const double stimulus = processingStimulus[i];
+        const double response = stimulus >= threshold[i] ? sensitivity[i] * stimulus : 0.0;
+        energy = std::clamp(energy + response, 0.0, maximum);
+
+        energyLevel[i] = static_cast<state_t>(energy);
+        processingStimulus[i] = 0.0;
+        changed += (energyLevel[i] != before || stimulus != 0.0) ? 1 : 0;
+    }
+    return changed;
+}
@@ -0,0 +1,253 @@
+// SensoryModalityRegistry.cpp
+#include "SensoryModalityRegistry.h"
+#include "Dendrite.h"
+#include "DendriteBouton.h"
+#include "DendriteBranch.h"
+#include "Soma.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iostream>
+#include <sstream>
+
+namespace {
+    struct BuiltInModality {
+        SensoryModalityConfig layout;
+        const char* legacyCountKey;
+        const char* legacyPointsKey;
+    };
+
+    // Layouts of the modalities that were wired by hand before the registry existed
+    const std::vector<BuiltInModality>& builtInModalities() {
+        static const std::vector<BuiltInModality> modalities = {
+            {{"Visual", 0, 10, -100.0, 0.0, -100.0, 200.0, 7}, "num_pixels", "pixel_points_per_layer"},
+            {{"Auditory", 0, 4, -150.0, 0.0, 0.0, 300.0, 11}, "num_phonels", "phonel_points_per_layer"},
+            {{"Olfactory", 0, 4, -20.0, -10.0, -10.0, 40.0, 13}, "num_scentels", "scentel_points_per_layer"},
+        };
+        return modalities;
+    }
+
+    const char* const DEFAULT_MODALITIES = "Visual,Auditory,Olfactory";
+
+    std::string trim(const std::string& text) {
+        auto begin = text.find_first_not_of(" \t");
+        if (begin == std::string::npos) {
+            return "";
+        }
+        auto end = text.find_last_not_of(" \t");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    std::string lowerCase(std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(),
+                       [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+        return text;
+    }
+
+    const std::string* findValue(const std::map<std::string, std::string>& config, const std::string& key) {
+        auto it = config.find(key);
+        return it == config.end() || it->second.empty() ? nullptr : &it->second;
+    }
+
+    template <typename T>
+    void readNumber(const std::map<std::string, std::string>& config, const std::string& key, T& value) {
+        const std::string* text = findValue(config, key);
+        if (!text) {
+            return;
+        }
+        std::istringstream stream(*text);
+        T parsed{};
+        if (stream >> parsed && (stream >> std::ws).eof()) {
+            value = parsed;
+        } else {
+            std::cerr << "[WARNING] Invalid " << key << "='" << *text << "'; using " << value << "." << std::endl;
+        }
+    }
+
+    void readOrigin(const std::map<std::string, std::string>& config, const std::string& key,
+                    SensoryModalityConfig& modality) {
+        const std::string* text = findValue(config, key);
+        if (!text) {
+            return;
+        }
+        std::string normalised = *text;
+        std::replace(normalised.begin(), normalised.end(), ',', ' ');
+        std::istringstream stream(normalised);
+        double x, y, z;
+        if (stream >> x >> y >> z && (stream >> std::ws).eof()) {
+            modality.originX = x;
+            modality.originY = y;
+            modality.originZ = z;
+        } else {
+            std::cerr << "[WARNING] Invalid " << key << "='" << *text << "'; expected x,y,z." << std::endl;
+        }
+    }
+}
+
+std::vector<SensoryModalityConfig> SensoryModalityRegistry::readConfig(const std::map<std::string, std::string>& config) {
+    const std::string* list = findValue(config, "sensory_modalities");
+    std::istringstream names(list ? *list : DEFAULT_MODALITIES);
+
+    std::vector<SensoryModalityConfig> modalities;
+    std::string name;
+    while (std::getline(names, name, ',')) {
+        name = trim(name);
+        if (name.empty()) {
+            continue;
+        }
+
+        SensoryModalityConfig modality;
+        modality.name = name;
+        const std::string prefix = lowerCase(name) + "_";
+
+        bool hasCount = findValue(config, prefix + "receptors") != nullptr;
+        for (const auto& builtIn : builtInModalities()) {
+            if (lowerCase(builtIn.layout.name) == lowerCase(name)) {
+                modality = builtIn.layout;
+                modality.name = name;
+                readNumber(config, builtIn.legacyCountKey, modality.receptorCount);
+                readNumber(config, builtIn.legacyPointsKey, modality.pointsPerLayer);
+                hasCount = hasCount || findValue(config, builtIn.legacyCountKey) != nullptr;
+                break;
+            }
+        }
+        if (!hasCount) {
+            std::cerr << "[WARNING] Sensory modality '" << name << "' has no " << prefix
+                      << "receptors setting; skipping it." << std::endl;
+            continue;
+        }
+
+        readNumber(config, prefix + "receptors", modality.receptorCount);
+        readNumber(config, prefix + "points_per_layer", modality.pointsPerLayer);
+        readOrigin(config, prefix + "origin", modality);
+        readNumber(config, prefix + "hemisphere_offset", modality.hemisphereOffset);
+        readNumber(config, prefix + "wiring_stride", modality.wiringStride);
+        readNumber(config, prefix + "ingest_depth", modality.ingestDepth);
+        if (const std::string* policy = findValue(config, prefix + "ingest_policy")) {
+            if (!parseIngestPolicy(trim(*policy), modality.ingestPolicy)) {
+                std::cerr << "[WARNING] Invalid " << prefix << "ingest_policy='" << *policy << "'; using "
+                          << ingestPolicyName(modality.ingestPolicy) << "." << std::endl;
+            }
+        }
+
+        if (modality.receptorCount < 0 || modality.pointsPerLayer <= 0 || modality.wiringStride < 0
+            || modality.ingestDepth <= 0) {
+            std::cerr << "[WARNING] Sensory modality '" << name
+                      << "' needs receptors >= 0, points_per_layer > 0, wiring_stride >= 0 and ingest_depth > 0;"
+                      << " skipping it." << std::endl;
+            continue;
+        }
+        modalities.push_back(modality);
+    }
+    return modalities;
+}
+
+void SensoryModalityRegistry::build(const std::vector<SensoryModalityConfig>& configs) {
+    for (const auto& config : configs) {
+        Modality modality;
+        modality.config = config;
+
+        const int perHemisphere = config.receptorCount / 2;
+        for (int j = 0; j < 2; ++j) {
+            std::vector<std::shared_ptr<SensoryReceptor>> receptors;
+            receptors.reserve(perHemisphere);
+            for (int i = 0; i < perHemisphere; ++i) {
+                auto coords = get_coordinates(i, config.receptorCount, config.pointsPerLayer);
+                Position receptorPosition(std::get<0>(coords) + config.originX + j * config.hemisphereOffset,
+                                          std::get<1>(coords) + config.originY,
+                                          std::get<2>(coords) + config.originZ);
+
+                auto receptor = std::make_shared<SensoryReceptor>(receptorPosition);
+                receptor->initialise();
+                receptors.push_back(std::move(receptor));
+            }
+            auto bank = std::make_shared<ReceptorBank>(config.name + (j == 0 ? "_Left" : "_Right"),
+                                                       std::move(receptors), config.ingestPolicy,
+                                                       static_cast<std::size_t>(config.ingestDepth));
+            modality.hemispheres.push_back(bank);
+            banks.push_back(std::move(bank));
+        }
+
+        std::cout << "Created " << 2 * perHemisphere << " " << config.name << " sensory receptors." << std::endl;
+        modalities.push_back(std::move(modality));
+    }
+}
+
+std::size_t SensoryModalityRegistry::wire(const std::vector<std::shared_ptr<Neuron>>& neurons,
+                                         double proximityThreshold) {
+    if (neurons.empty()) {
+        return 0;
+    }
+
+    struct Connection {
+        std::size_t neuronIndex;
+        SensoryReceptor* receptor;
+    };
+
+    // Serial plan in build order, then grouped by neuron so each group touches only
+    // its own neuron and receptors
+    std::vector<Connection> plan;
+    for (const auto& modality : modalities) {
+        const int stride = modality.config.wiringStride;
+        if (stride == 0) {
+            continue;
+        }
+        const int perHemisphere = modality.config.receptorCount / 2;
+        for (int j = 0; j < static_cast<int>(modality.hemispheres.size()); ++j) {
+            const auto& receptors = modality.hemispheres[j]->getReceptors();
+            for (int i = stride; i < static_cast<int>(receptors.size()); i += stride) {
+                std::size_t neuronIndex = static_cast<std::size_t>(i + perHemisphere * j) % neurons.size();
+                plan.push_back({neuronIndex, receptors[i].get()});
+            }
+        }
+    }
+    std::stable_sort(plan.begin(), plan.end(),
+                     [](const Connection& a, const Connection& b) { return a.neuronIndex < b.neuronIndex; });
+
+    std::vector<std::size_t> groupStarts;
+    for (std::size_t k = 0; k < plan.size(); ++k) {
+        if (k == 0 || plan[k].neuronIndex != plan[k - 1].neuronIndex) {
+            groupStarts.push_back(k);
+        }
+    }
+    groupStarts.push_back(plan.size());
+
+    std::size_t associated = 0;
+    const long groupCount = static_cast<long>(groupStarts.size()) - 1;
+#pragma omp parallel for schedule(dynamic) reduction(+ : associated)
+    for (long g = 0; g < groupCount; ++g) {
+        for (std::size_t k = groupStarts[g]; k < groupStarts[g + 1]; ++k) {
+            auto& neuron = *neurons[plan[k].neuronIndex];
+            auto& receptor = *plan[k].receptor;
+
+            // Move the first dendrite and its bouton next to the receptor's synaptic gap
+            const auto& firstDendrite = neuron.getSoma()->getDendriteBranches()[0]->getDendrites()[0];
+            const auto synapticGap = receptor.getSynapticGaps()[0];
+            firstDendrite->getDendriteBouton()->moveTo(synapticGap->getPosition().offsetBy(0.4, 0.4, 0.4));
+            firstDendrite->moveTo(synapticGap->getPosition().offsetBy(0.8, 0.8, 0.8));
+
+            associateSynapticGap(receptor, neuron, proximityThreshold);
+            if (synapticGap->isAssociated()) {
+                ++associated;
+            }
+        }
+    }
+    return associated;
+}
+
+std::uint64_t SensoryModalityRegistry::update(double deltaTime) {
+    std::uint64_t changed = 0;
+    for (const auto& bank : banks) {
+        changed += bank->update(deltaTime);
+    }
+    return changed;
+}
+
+std::size_t SensoryModalityRegistry::getReceptorCount() const {
+    std::size_t count = 0;
+    for (const auto& bank : banks) {
+        count += bank->size();
+    }
+    return count;
+}
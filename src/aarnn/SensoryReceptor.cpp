@@ -1,14 +1,16 @@
 #include "SensoryReceptor.h"
 #include "SynapticGap.h"
 #include "utils.h"
+#include "DeterministicRandom.h"
 
 #include <cmath>
 #include <ctime>
-#include <cstdlib>
 #include <algorithm>
 
-SensoryReceptor::SensoryReceptor(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
-        : NeuronalComponent(position, parent)
+std::atomic<int> SensoryReceptor::nextSensoryReceptorId{0};
+
+SensoryReceptor::SensoryReceptor(const Position& position, std::weak_ptr<NeuronalComponent> parent)
+        : NeuronalComponent(position, parent), sensoryReceptorID(nextSensoryReceptorId++)
 {
     // Additional initialization if needed
 }
@@ -19,26 +21,32 @@ void SensoryReceptor::initialise()
 
     if (!instanceInitialised)
     {
-        setAttack((35 - (rand() % 25)) / 100.0);
-        setDecay((35 - (rand() % 25)) / 100.0);
-        setSustain((35 - (rand() % 25)) / 100.0);
-        setRelease((35 - (rand() % 25)) / 100.0);
-        setFrequencyResponse(rand() % 44100);
-        setPhaseShift(rand() % 360);
+        RandomStream rng(DeterministicRandom::Stream::SensoryReceptor, static_cast<std::uint64_t>(sensoryReceptorID));
+        setAttack((35 - rng.below(25)) / 100.0);
+        setDecay((35 - rng.below(25)) / 100.0);
+        setSustain((35 - rng.below(25)) / 100.0);
+        setRelease((35 - rng.below(25)) / 100.0);
+        setFrequencyResponse(rng.below(44100));
+        setPhaseShift(rng.below(360));
         lastCallTime = 0.0;
 
-        auto positionPtr = std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1);
-        synapticGap = std::make_shared<SynapticGap>(positionPtr, std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+        auto gapPosition = position.offsetBy(1, 1, 1);
+        synapticGap = std::make_shared<SynapticGap>(gapPosition, std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         synapticGap->initialise();
         synapticGap->updateFromSensoryReceptor(std::static_pointer_cast<SensoryReceptor>(shared_from_this()));
         addSynapticGap(synapticGap);
 
-        minPropagationRate  = (35 - (rand() % 25)) / 100.0;
-        maxPropagationRate  = (65 + (rand() % 25)) / 100.0;
+        minPropagationRate  = (35 - rng.below(25)) / 100.0;
+        maxPropagationRate  = (65 + rng.below(25)) / 100.0;
         instanceInitialised = true;
     }
 }
 
+int SensoryReceptor::getSensoryReceptorId() const
+{
+    return sensoryReceptorID;
+}
+
 void SensoryReceptor::addSynapticGap(std::shared_ptr<SynapticGap> gap)
 {
     synapticGaps.emplace_back(std::move(gap));
@@ -138,24 +146,22 @@ void SensoryReceptor::updateComponent(double time, double energy)
 
     for (auto& synapticGap_id : synapticGaps)
     {
-        double propagationTime = position->calcPropagationTime(*synapticGap_id->getPosition(), propagationRate);
+        double propagationTime = position.calcPropagationTime(synapticGap_id->getPosition(), propagationRate);
         synapticGap_id->updateComponent(time + propagationTime, componentEnergyLevel);
     }
 
     componentEnergyLevel = 0;
 }
 
-void SensoryReceptor::update(double deltaTime) {
-    NeuronalComponent::updateEnergy(deltaTime);
+bool SensoryReceptor::update(double deltaTime) {
+    // Settled receptors are skipped until stimulate() wakes them
+    if (!beginUpdate()) {
+        return false;
+    }
 
-    double stimulusToProcess = 0.0;
+    bool changed = stepEnergy(deltaTime);
 
-    // Safely access accumulatedStimulus
-    {
-        std::lock_guard<std::mutex> lock(receptorMutex);
-        stimulusToProcess = accumulatedStimulus;
-        accumulatedStimulus = 0.0;
-    }
+    double stimulusToProcess = accumulatedStimulus.exchange(0.0, std::memory_order_relaxed);
 
     // Process the stimulus if it exceeds the threshold
     if (stimulusToProcess >= threshold) {
@@ -166,11 +172,14 @@ void SensoryReceptor::update(double deltaTime) {
     }
 
     // Additional updates if necessary
+
+    endUpdate(changed || stimulusToProcess != 0.0);
+    return true;
 }
 
 void SensoryReceptor::stimulate(double intensity) {
-    std::lock_guard<std::mutex> lock(receptorMutex);
-    accumulatedStimulus += intensity;
+    atomic_add(accumulatedStimulus, intensity);
+    wake();
 }
 
 void SensoryReceptor::setSensitivity(double newSensitivity) {
@@ -180,3 +189,11 @@ void SensoryReceptor::setSensitivity(double newSensitivity) {
 void SensoryReceptor::setThreshold(double newThreshold) {
     threshold = newThreshold;
 }
+
+double SensoryReceptor::getSensitivity() const {
+    return sensitivity;
+}
+
+double SensoryReceptor::getThreshold() const {
+    return threshold;
+}
@@ -1,42 +1,69 @@
 // SensoryReceptorServer.cpp
 
+#include <algorithm>
+#include <chrono>
 #include <cstdlib>
 #include <cerrno>
 #include <climits>
 #include <iostream>
 #include "SensoryReceptorServer.h"
+#include "StatsRegistry.h"
 #include "StimuliData.h" // Definition of stimuli data structure
 
 SensoryReceptorServer::SensoryReceptorServer() : running(false) {}
 
 SensoryReceptorServer::~SensoryReceptorServer() {
     stopServer();
+    if (datagramReceiver) {
+        StatsRegistry::instance().unregisterProvider("sensory_udp");
+    }
+    StatsRegistry::instance().unregisterProvider("sensory_shm");
+    StatsRegistry::instance().unregisterProvider("sensory_latency");
+    StatsRegistry::instance().unregisterProvider("sensory_alignment");
+    StatsRegistry::instance().unregisterProvider("sensory_io");
 }
 
-bool SensoryReceptorServer::initialise() {
-    const char* portStr = std::getenv("SENSORY_SERVER_PORT");
-    if (!portStr) {
-        std::cerr << "Environment variable SENSORY_SERVER_PORT is not set." << std::endl;
-        return false;
-    }
+namespace {
+    constexpr std::size_t RING_DRAIN_LIMIT = 256;   // Records per ring per pass, so one ring cannot starve the rest
+    constexpr unsigned RING_SPIN_PASSES = 64;       // Empty passes before the poller starts sleeping
+    constexpr auto RING_IDLE_SLEEP = std::chrono::microseconds(200);
+    const std::string RING_NAME_PREFIX = "/aarnn-";
 
-    char* endPtr = nullptr;
-    errno = 0;
-    long portLong = std::strtol(portStr, &endPtr, 10);
+    // Reads a TCP/UDP port from the environment; 0 if unset or invalid
+    int readPort(const char* variable) {
+        const char* portStr = std::getenv(variable);
+        if (!portStr) {
+            return 0;
+        }
 
-    if (errno != 0 || endPtr == portStr || *endPtr != '\0') {
-        std::cerr << "Invalid SENSORY_SERVER_PORT: '" << portStr << "' is not a valid number." << std::endl;
-        return false;
+        char* endPtr = nullptr;
+        errno = 0;
+        long portLong = std::strtol(portStr, &endPtr, 10);
+
+        if (errno != 0 || endPtr == portStr || *endPtr != '\0') {
+            std::cerr << "Invalid " << variable << ": '" << portStr << "' is not a valid number." << std::endl;
+            return 0;
+        }
+
+        if (portLong <= 0 || portLong > 65535) {
+            std::cerr << variable << " out of valid port range: " << portLong << std::endl;
+            return 0;
+        }
+        return static_cast<int>(portLong);
     }
+}
 
-    if (portLong <= 0 || portLong > 65535) {
-        std::cerr << "SENSORY_SERVER_PORT out of valid TCP port range: " << portLong << std::endl;
+bool SensoryReceptorServer::initialise() {
+    if (!std::getenv("SENSORY_SERVER_PORT")) {
+        std::cerr << "Environment variable SENSORY_SERVER_PORT is not set." << std::endl;
+        return false;
+    }
+    server_port = readPort("SENSORY_SERVER_PORT");
+    if (server_port == 0) {
         return false;
     }
 
-    server_port = static_cast<int>(portLong);
-
-    networkServer = std::make_unique<AsyncNetworkServer>(server_port);
+    networkServer = std::make_unique<AsyncNetworkServer>(server_port, ioPolicy.cpus.size());
     if (!networkServer->initialise()) {
         std::cerr << "Failed to initialise network server." << std::endl;
         server_initialised = false;
@@ -45,6 +72,13 @@ bool SensoryReceptorServer::initialise() {
         server_initialised = true;
     }
 
+    // Optional UDP ingestion, unicast or multicast
+    if (int udpPort = readPort("SENSORY_UDP_PORT")) {
+        const char* group = std::getenv("SENSORY_UDP_GROUP");
+        datagramReceiver = std::make_unique<DatagramReceiver>(static_cast<unsigned short>(udpPort),
+                                                              group ? group : "");
+    }
+
     return server_initialised;
 }
 
@@ -55,45 +89,580 @@ bool SensoryReceptorServer::startServer() {
         return false;
     }
 
-    networkServer->setOnMessage([this](int clientId, const std::string& message) {
-        processStimuliData(message);
+    networkServer->setOnMessage([this](int clientId, std::string_view message) {
+        processMessage(clientId, message);
     });
+    networkServer->setOnDisconnect([this](int clientId) { releaseChannels(clientId); });
+    const bool placed = !ioPolicy.cpus.empty() || ioPolicy.realtimePriority > 0;
+    if (placed) {
+        networkServer->setOnThreadStart([this](std::size_t index) {
+            if (ioPolicy.cpus.empty()) {
+                applyIoThreadPolicy({});
+            } else {
+                applyIoThreadPolicy({ioPolicy.cpus[index % ioPolicy.cpus.size()]});
+            }
+        });
+    }
 
     if (!networkServer->start()) {
         std::cerr << "Failed to start AsyncNetworkServer." << std::endl;
         return false;
     }
 
+    if (datagramReceiver) {
+        datagramReceiver->setOnDatagram([this](std::string_view datagram) { processDatagram(datagram); });
+        if (placed) {
+            datagramReceiver->setOnThreadStart([this]() { applyIoThreadPolicy(ioPolicy.cpus); });
+        }
+        if (datagramReceiver->start()) {
+            StatsRegistry::instance().registerProvider("sensory_udp", [this]() { return datagramStatistics(); });
+        } else {
+            std::cerr << "Failed to start UDP ingestion; continuing with TCP only." << std::endl;
+            datagramReceiver.reset();
+        }
+    }
+
     running = true;
+    ringThread = std::thread(&SensoryReceptorServer::pollRings, this);
+    StatsRegistry::instance().registerProvider("sensory_shm", [this]() {
+        boost::json::object shm;
+        {
+            std::lock_guard<InstrumentedMutex> lock(ringMutex);
+            shm["rings"] = rings.size();
+        }
+        shm["frames"] = ringFrames.load(std::memory_order_relaxed);
+        shm["malformed"] = ringMalformed.load(std::memory_order_relaxed);
+        return boost::json::value(std::move(shm));
+    });
+    StatsRegistry::instance().registerProvider("sensory_latency", [this]() {
+        return boost::json::value(ingestLatency.toJson());
+    });
+    if (latencyBudgetMicros != 0) {
+        StatsRegistry::instance().registerProvider("sensory_alignment", [this]() { return alignmentStatistics(); });
+    }
+    if (placed) {
+        StatsRegistry::instance().registerProvider("sensory_io", [this]() {
+            boost::json::object io;
+            io["cpus"] = formatCpuList(ioPolicy.cpus);
+            io["realtime_priority"] = ioPolicy.realtimePriority;
+            io["threads_pinned"] = ioThreadsPinned.load(std::memory_order_relaxed);
+            io["threads_realtime"] = ioThreadsRealtime.load(std::memory_order_relaxed);
+            io["failures"] = ioPolicyFailures.load(std::memory_order_relaxed);
+            return boost::json::value(std::move(io));
+        });
+    }
     return true;
 }
 
+// Runs at the start of each ingestion thread. Refusals are reported once per thread
+// and the thread carries on unplaced rather than failing ingestion.
+void SensoryReceptorServer::applyIoThreadPolicy(const std::vector<int>& cpus) {
+    if (!cpus.empty()) {
+        if (pinCurrentThread(cpus)) {
+            ioThreadsPinned.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ioPolicyFailures.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "Cannot pin a sensory ingestion thread to cpus " << formatCpuList(cpus) << "." << std::endl;
+        }
+    }
+    if (ioPolicy.realtimePriority > 0) {
+        if (makeCurrentThreadRealtime(ioPolicy.realtimePriority)) {
+            ioThreadsRealtime.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            ioPolicyFailures.fetch_add(1, std::memory_order_relaxed);
+            std::cerr << "Cannot run a sensory ingestion thread under SCHED_FIFO (needs CAP_SYS_NICE or an rtprio limit);"
+                         " using the normal scheduler." << std::endl;
+        }
+    }
+}
+
 void SensoryReceptorServer::stopServer() {
     running = false;
-    networkServer->stop();
+    if (ringThread.joinable()) {
+        ringThread.join();
+    }
+    if (datagramReceiver) {
+        datagramReceiver->stop();
+    }
+    if (networkServer) {
+        networkServer->stop();
+    }
+}
+
+void SensoryReceptorServer::registerBank(std::shared_ptr<ReceptorBank> bank) {
+    auto inserted = bankIds.emplace(bank->getName(), static_cast<std::uint32_t>(banks.size()));
+    if (inserted.second) {
+        banks.push_back(std::move(bank));
+    } else {
+        banks[inserted.first->second] = std::move(bank);
+    }
 }
 
-void SensoryReceptorServer::registerReceptors(const std::string& receptorType,
-                                              const std::vector<std::shared_ptr<SensoryReceptor>>& receptors) {
-    receptorMap[receptorType] = receptors;
+void SensoryReceptorServer::processMessage(int clientId, std::string_view message) {
+    if (isStimulusBatch(message)) {
+        processBatch(message, true);
+        return;
+    }
+
+    try {
+        boost::json::value jv = boost::json::parse(boost::json::string_view(message.data(), message.size()));
+        const auto& obj = jv.as_object();
+        if (const auto* channel = obj.if_contains("register")) {
+            std::vector<StimulusFormat> offered;
+            if (const auto* formats = obj.if_contains("formats")) {
+                for (const auto& name : formats->as_array()) {
+                    StimulusFormat format;
+                    if (name.is_string() && parseStimulusFormat(std::string(name.as_string()), format)) {
+                        offered.push_back(format);
+                    }
+                }
+            }
+            std::string ring;
+            if (const auto* ringName = obj.if_contains("ring")) {
+                ring = std::string(ringName->as_string());
+            }
+            registerChannel(clientId, std::string(channel->as_string()), offered, ring);
+        } else if (obj.if_contains("stats")) {
+            // Lets load generators and monitors read the runtime statistics remotely
+            boost::json::object reply;
+            reply["stats"] = StatsRegistry::instance().snapshot();
+            networkServer->send(clientId, boost::json::serialize(reply));
+        } else {
+            processStimuliData(message);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Malformed message from client " << clientId << ": " << e.what() << std::endl;
+    }
 }
 
-void SensoryReceptorServer::processStimuliData(const std::string& data) {
-    StimuliData stimuli = deserializeStimuliData(data);
-// Allow prefix matching: e.g., "Visual:LeftCamera" → "Visual"
-    std::string baseType = stimuli.receptorType;
-    auto colonPos = baseType.find(':');
-    if (colonPos != std::string::npos) {
-        baseType = baseType.substr(0, colonPos);
+void SensoryReceptorServer::processBatch(std::string_view frame, bool spendsCredit) {
+    StimulusBatchHeader header;
+    if (!parseStimulusBatchHeader(frame, header) || header.bankId >= banks.size()) {
+        std::cerr << "Discarding malformed stimulus batch." << std::endl;
+        return;
     }
 
-    auto it = receptorMap.find(baseType);
-    if (it != receptorMap.end()) {
-        auto& receptors = it->second;
-        for (size_t i = 0; i < receptors.size() && i < stimuli.values.size(); ++i) {
-            receptors[i]->stimulate(stimuli.values[i]);
+    // Widened straight from the receive buffer, then one pass into the bank. Each io
+    // thread keeps its own scratch, which stops allocating once it has seen the
+    // largest batch.
+    thread_local std::vector<double> batchValues;
+    batchValues.resize(header.valueCount);
+    decodeStimulusBatch(frame, header, batchValues.data());
+
+    std::uint64_t credit = 0;
+    if (spendsCredit) {
+        if (Channel* channel = findChannel(header.channelId, header.bankId)) {
+            credit = creditTag(header.channelId, channel->generation.load(std::memory_order_acquire));
         }
+    }
+    deliver(header.bankId, batchValues.data(), batchValues.size(), header.timestampMicros, credit);
+}
+
+void SensoryReceptorServer::stimulateBank(std::uint32_t bankId, const double* values, std::size_t count,
+                                          std::uint64_t credit) {
+    ReceptorBank& bank = *banks[bankId];
+    bank.stimulate(values, count, credit);
+    if (credit != 0 && bank.getIngestPolicy() != IngestPolicy::DropOldest) {
+        returnCredit(credit);
+    }
+}
+
+void SensoryReceptorServer::returnCredit(std::uint64_t credit) {
+    const auto channelId = static_cast<std::uint32_t>(credit);
+    if (channelId == 0 || channelId >= channelCount.load(std::memory_order_acquire)) {
+        return;
+    }
+    Channel& channel = channels[channelId];
+    if (channel.generation.load(std::memory_order_acquire) == static_cast<std::uint32_t>(credit >> 32)) {
+        channel.spent.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+namespace {
+    // Orders the jitter buffer as a min-heap on release time, then arrival
+    template <typename Frame>
+    bool releasesLater(const Frame& a, const Frame& b) {
+        return a.releaseMicros != b.releaseMicros ? a.releaseMicros > b.releaseMicros : a.arrival > b.arrival;
+    }
+}
+
+// Every path into the banks ends here. Without a latency budget, or without a
+// timestamp, the frame is applied at once; otherwise it waits in the jitter buffer.
+void SensoryReceptorServer::deliver(std::uint32_t bankId, const double* values, std::size_t count,
+                                    std::uint64_t timestampMicros, std::uint64_t credit) {
+    if (timestampMicros == 0) {
+        stimulateBank(bankId, values, count, credit);
+        return;
+    }
+    const std::uint64_t now = stimulusClockMicros();
+    ingestLatency.record(now > timestampMicros ? now - timestampMicros : 0);
+    if (latencyBudgetMicros == 0) {
+        stimulateBank(bankId, values, count, credit);
+        return;
+    }
+
+    std::uint64_t releaseMicros = timestampMicros + latencyBudgetMicros;
+    if (releaseMicros <= now) {
+        framesLate.fetch_add(1, std::memory_order_relaxed);
+        lateBy.record(now - releaseMicros);
+        stimulateBank(bankId, values, count, credit);
+        return;
+    }
+    if (timestampMicros > now) {
+        framesEarly.fetch_add(1, std::memory_order_relaxed);
+        releaseMicros = now + latencyBudgetMicros;
+    } else {
+        framesOnTime.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        std::lock_guard<InstrumentedMutex> lock(alignmentMutex);
+        if (alignedFrames.size() < MAX_ALIGNED_FRAMES) {
+            AlignedFrame frame{releaseMicros, alignedArrivals++, bankId, credit, {}};
+            if (!spareValues.empty()) {
+                frame.values = std::move(spareValues.back());
+                spareValues.pop_back();
+            }
+            frame.values.assign(values, values + count);
+            alignedFrames.push_back(std::move(frame));
+            std::push_heap(alignedFrames.begin(), alignedFrames.end(), releasesLater<AlignedFrame>);
+            return;
+        }
+    }
+    framesOverflowed.fetch_add(1, std::memory_order_relaxed);
+    stimulateBank(bankId, values, count, credit);
+}
+
+std::size_t SensoryReceptorServer::releaseAlignedFrames() {
+    if (latencyBudgetMicros == 0) {
+        return 0;
+    }
+    const std::uint64_t now = stimulusClockMicros();
+    {
+        std::lock_guard<InstrumentedMutex> lock(alignmentMutex);
+        while (!alignedFrames.empty() && alignedFrames.front().releaseMicros <= now) {
+            std::pop_heap(alignedFrames.begin(), alignedFrames.end(), releasesLater<AlignedFrame>);
+            releasing.push_back(std::move(alignedFrames.back()));
+            alignedFrames.pop_back();
+        }
+    }
+    if (releasing.empty()) {
+        return 0;
+    }
+
+    for (const auto& frame : releasing) {
+        stimulateBank(frame.bankId, frame.values.data(), frame.values.size(), frame.credit);
+    }
+    const std::size_t released = releasing.size();
+    std::lock_guard<InstrumentedMutex> lock(alignmentMutex);
+    for (auto& frame : releasing) {
+        spareValues.push_back(std::move(frame.values));
+    }
+    releasing.clear();
+    return released;
+}
+
+boost::json::value SensoryReceptorServer::alignmentStatistics() const {
+    boost::json::object alignment;
+    alignment["latency_budget_us"] = latencyBudgetMicros;
+    {
+        std::lock_guard<InstrumentedMutex> lock(alignmentMutex);
+        alignment["held"] = alignedFrames.size();
+    }
+    alignment["on_time"] = framesOnTime.load(std::memory_order_relaxed);
+    alignment["late"] = framesLate.load(std::memory_order_relaxed);
+    alignment["early"] = framesEarly.load(std::memory_order_relaxed);
+    alignment["overflow"] = framesOverflowed.load(std::memory_order_relaxed);
+    alignment["late_by"] = lateBy.toJson();
+    return boost::json::value(std::move(alignment));
+}
+
+SensoryReceptorServer::Channel* SensoryReceptorServer::findChannel(std::uint32_t channelId, std::uint32_t bankId) {
+    if (channelId == 0 || channelId >= channelCount.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    Channel& channel = channels[channelId];
+    return channel.bankId.load(std::memory_order_acquire) == bankId ? &channel : nullptr;
+}
+
+// Runs on the UDP receive thread only. Datagrams are routed exactly like TCP batches;
+// sequence numbers are tracked per channel, and a datagram older than the newest one
+// already applied is counted as late and discarded.
+void SensoryReceptorServer::processDatagram(std::string_view datagram) {
+    std::uint32_t sequence;
+    std::string_view frame;
+    StimulusBatchHeader header;
+    if (!parseStimulusDatagram(datagram, sequence, frame) || !parseStimulusBatchHeader(frame, header)) {
+        datagramsMalformed.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (Channel* channel = findChannel(header.channelId, header.bankId)) {
+        const bool sequenced = channel->sequenced.load(std::memory_order_relaxed);
+        const std::uint32_t ahead = sequence - channel->nextSequence.load(std::memory_order_relaxed);  // Wraps like the counter
+        if (sequenced && ahead >= 0x80000000u) {
+            channel->datagramsLate.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        if (sequenced) {
+            channel->datagramsLost.fetch_add(ahead, std::memory_order_relaxed);
+        }
+        channel->sequenced.store(true, std::memory_order_relaxed);
+        channel->nextSequence.store(sequence + 1, std::memory_order_relaxed);
+        channel->datagramsReceived.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        datagramsUnsequenced.fetch_add(1, std::memory_order_relaxed);
+    }
+    processBatch(frame, false);
+}
+
+boost::json::value SensoryReceptorServer::datagramStatistics() const {
+    boost::json::object udp;
+    udp["datagrams"] = datagramReceiver->getDatagramsReceived();
+    udp["receive_calls"] = datagramReceiver->getReceiveCalls();
+    udp["truncated"] = datagramReceiver->getTruncated();
+    udp["malformed"] = datagramsMalformed.load(std::memory_order_relaxed);
+    udp["unsequenced"] = datagramsUnsequenced.load(std::memory_order_relaxed);
+
+    boost::json::object perChannel;
+    const std::uint32_t count = channelCount.load(std::memory_order_acquire);
+    for (std::uint32_t id = 1; id < count; ++id) {
+        const Channel& channel = channels[id];
+        const std::uint32_t bankId = channel.bankId.load(std::memory_order_acquire);
+        const std::uint64_t received = channel.datagramsReceived.load(std::memory_order_relaxed);
+        if (received == 0 || bankId == FREE_CHANNEL) {
+            continue;
+        }
+        boost::json::object entry;
+        entry["bank"] = banks[bankId]->getName();
+        entry["received"] = received;
+        entry["lost"] = channel.datagramsLost.load(std::memory_order_relaxed);
+        entry["late"] = channel.datagramsLate.load(std::memory_order_relaxed);
+        perChannel[std::to_string(id)] = std::move(entry);
+    }
+    udp["channels"] = std::move(perChannel);
+    return boost::json::value(std::move(udp));
+}
+
+void SensoryReceptorServer::registerChannel(int clientId, const std::string& channel,
+                                            const std::vector<StimulusFormat>& offered, const std::string& ring) {
+    const std::int64_t bankId = resolveChannel(channel);
+    std::size_t receptorCount = 0;
+    if (bankId == UNREGISTERED_BANK) {
+        std::cerr << "No receptor bank for channel " << channel << std::endl;
+    } else {
+        receptorCount = banks[bankId]->size();
+    }
+
+    // Every binary format is understood, so the producer's first choice wins
+    StimulusFormat format = StimulusFormat::Json;
+    for (auto candidate : offered) {
+        if (stimulusValueSize(candidate) != 0) {
+            format = candidate;
+            break;
+        }
+    }
+
+    // One flow-control slot per (client, bank). A repeated registration reuses it and
+    // the reply restores the full window, so credits still outstanding are forgotten.
+    std::uint32_t channelId = 0;
+    std::uint32_t credits = 0;
+    if (bankId != UNREGISTERED_BANK && format != StimulusFormat::Json) {
+        std::lock_guard<InstrumentedMutex> lock(channelMutex);
+        const std::uint32_t count = channelCount.load(std::memory_order_relaxed);
+        std::uint32_t freeId = 0;
+        for (std::uint32_t id = 1; id < count; ++id) {
+            const std::uint32_t slotBank = channels[id].bankId.load(std::memory_order_relaxed);
+            if (slotBank == FREE_CHANNEL) {
+                freeId = freeId == 0 ? id : freeId;
+            } else if (channels[id].clientId.load(std::memory_order_relaxed) == clientId
+                       && slotBank == static_cast<std::uint32_t>(bankId)) {
+                channelId = id;
+                break;
+            }
+        }
+        if (channelId == 0 && freeId != 0) {
+            channelId = freeId;
+        } else if (channelId == 0 && count < MAX_CHANNELS) {
+            channelId = count;
+        }
+        if (channelId != 0) {
+            Channel& slot = channels[channelId];
+            slot.generation.fetch_add(1, std::memory_order_acq_rel);
+            slot.spent.store(0, std::memory_order_relaxed);
+            if (slot.bankId.load(std::memory_order_relaxed) == FREE_CHANNEL) {
+                slot.sequenced.store(false, std::memory_order_relaxed);
+                slot.datagramsReceived.store(0, std::memory_order_relaxed);
+                slot.datagramsLost.store(0, std::memory_order_relaxed);
+                slot.datagramsLate.store(0, std::memory_order_relaxed);
+                slot.clientId.store(clientId, std::memory_order_relaxed);
+                slot.bankId.store(static_cast<std::uint32_t>(bankId), std::memory_order_release);
+            }
+            if (channelId == count) {
+                channelCount.store(count + 1, std::memory_order_release);
+            }
+        }
+        credits = static_cast<std::uint32_t>(banks[bankId]->getIngestDepth());
+    }
+    const bool ringAttached = !ring.empty() && channelId != 0 && attachRing(ring);
+    networkServer->send(clientId, serializeChannelRegistrationReply(channel, bankId, receptorCount, format,
+                                                                    channelId, credits, ringAttached));
+}
+
+// Only rings following the producers' naming scheme are opened, and each only once
+bool SensoryReceptorServer::attachRing(const std::string& ringName) {
+    if (ringName.compare(0, RING_NAME_PREFIX.size(), RING_NAME_PREFIX) != 0
+        || ringName.find('/', 1) != std::string::npos) {
+        std::cerr << "Refusing shared-memory ring '" << ringName << "'." << std::endl;
+        return false;
+    }
+
+    std::lock_guard<InstrumentedMutex> lock(ringMutex);
+    for (const auto& attached : rings) {
+        if (attached->getName() == ringName) {
+            return true;
+        }
+    }
+    auto ring = std::make_shared<SharedMemoryRing>(ringName);
+    if (!ring->attach()) {
+        std::cerr << "Cannot attach shared-memory ring " << ringName << "; producer stays on TCP." << std::endl;
+        return false;
+    }
+    rings.push_back(std::move(ring));
+    ringsVersion.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+// Drains every attached ring in turn. Frames are processed in place, like TCP
+// batches but without spending credit. Spins briefly when all rings are empty, then
+// sleeps between passes; rings whose producer has gone are dropped once empty, and
+// corrupt rings are dropped at once.
+void SensoryReceptorServer::pollRings() {
+    std::vector<std::shared_ptr<SharedMemoryRing>> polled;
+    std::uint64_t polledVersion = 0;
+    unsigned emptyPasses = 0;
+    if (!ioPolicy.cpus.empty() || ioPolicy.realtimePriority > 0) {
+        applyIoThreadPolicy(ioPolicy.cpus);
+    }
+
+    while (running) {
+        const std::uint64_t version = ringsVersion.load(std::memory_order_acquire);
+        if (version != polledVersion) {
+            std::lock_guard<InstrumentedMutex> lock(ringMutex);
+            polled = rings;
+            polledVersion = version;
+        }
+
+        std::size_t drained = 0;
+        for (const auto& ring : polled) {
+            const std::size_t frames = ring->drain([this](std::string_view frame) {
+                if (isStimulusBatch(frame)) {
+                    processBatch(frame, false);
+                } else {
+                    ringMalformed.fetch_add(1, std::memory_order_relaxed);
+                }
+            }, RING_DRAIN_LIMIT);
+            drained += frames;
+
+            if (ring->isMalformed()) {
+                std::cerr << "Shared-memory ring " << ring->getName() << " is corrupt; detaching it." << std::endl;
+                ringMalformed.fetch_add(1, std::memory_order_relaxed);
+            }
+            if ((frames == 0 && ring->isClosed()) || ring->isMalformed()) {
+                std::lock_guard<InstrumentedMutex> lock(ringMutex);
+                rings.erase(std::remove(rings.begin(), rings.end(), ring), rings.end());
+                ringsVersion.fetch_add(1, std::memory_order_release);
+            }
+        }
+        ringFrames.fetch_add(drained, std::memory_order_relaxed);
+
+        if (drained != 0) {
+            emptyPasses = 0;
+        } else if (++emptyPasses < RING_SPIN_PASSES) {
+            std::this_thread::yield();
+        } else {
+            std::this_thread::sleep_for(RING_IDLE_SLEEP);
+        }
+    }
+}
+
+// Frames the DropOldest banks took off their queues (or evicted) since the last call
+// return their credits now; Sum and Latest banks returned theirs on arrival
+void SensoryReceptorServer::grantCredits() {
+    if (!running) {
+        return;
+    }
+    releasedCredits.clear();
+    for (const auto& bank : banks) {
+        bank->takeReleasedCredits(releasedCredits);
+    }
+    for (std::uint64_t credit : releasedCredits) {
+        returnCredit(credit);
+    }
+
+    const std::uint32_t count = channelCount.load(std::memory_order_acquire);
+    for (std::uint32_t id = 1; id < count; ++id) {
+        Channel& channel = channels[id];
+        const std::uint32_t spent = channel.spent.exchange(0, std::memory_order_relaxed);
+        const int clientId = channel.clientId.load(std::memory_order_relaxed);
+        if (spent > 0 && channel.bankId.load(std::memory_order_acquire) != FREE_CHANNEL) {
+            networkServer->send(clientId, serializeStimulusCredit(id, spent));
+        }
+    }
+}
+
+// Frees the client's channel slots for later registrations; credits of its frames
+// still queued in a bank are dropped with the slot's generation
+void SensoryReceptorServer::releaseChannels(int clientId) {
+    std::lock_guard<InstrumentedMutex> lock(channelMutex);
+    const std::uint32_t count = channelCount.load(std::memory_order_relaxed);
+    for (std::uint32_t id = 1; id < count; ++id) {
+        Channel& channel = channels[id];
+        if (channel.bankId.load(std::memory_order_relaxed) != FREE_CHANNEL
+            && channel.clientId.load(std::memory_order_relaxed) == clientId) {
+            channel.bankId.store(FREE_CHANNEL, std::memory_order_release);
+            channel.generation.fetch_add(1, std::memory_order_acq_rel);
+            channel.clientId.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+void SensoryReceptorServer::processStimuliData(std::string_view data) {
+    StimuliData stimuli = deserializeStimuliData(data);
+    const std::int64_t bankId = resolveChannel(stimuli.receptorType);
+    if (bankId != UNREGISTERED_BANK) {
+        deliver(static_cast<std::uint32_t>(bankId), stimuli.values.data(), stimuli.values.size(),
+                stimuli.timestampMicros);
     } else {
         std::cerr << "Unknown receptor type: " << stimuli.receptorType << std::endl;
     }
 }
+
+// Matches, in order: the bank name itself ("Auditory_Left"), the channel with ':' read
+// as '_' ("Auditory:Left"), then the first bank of the modality before the ':'
+// ("Auditory:mic0" -> "Auditory_Left")
+std::int64_t SensoryReceptorServer::resolveChannel(const std::string& channel) const {
+    auto it = bankIds.find(channel);
+    if (it != bankIds.end()) {
+        return it->second;
+    }
+
+    const auto colonPos = channel.find(':');
+    if (colonPos == std::string::npos) {
+        return UNREGISTERED_BANK;
+    }
+    std::string bankName = channel;
+    bankName[colonPos] = '_';
+    it = bankIds.find(bankName);
+    if (it != bankIds.end()) {
+        return it->second;
+    }
+
+    for (std::size_t id = 0; id < banks.size(); ++id) {
+        const std::string& name = banks[id]->getName();
+        if (name.size() > colonPos && name.compare(0, colonPos, channel, 0, colonPos) == 0 && name[colonPos] == '_') {
+            return static_cast<std::int64_t>(id);
+        }
+    }
+    return UNREGISTERED_BANK;
+}
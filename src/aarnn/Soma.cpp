@@ -5,7 +5,7 @@
 #include "utils.h"
 #include <iostream>
 
-Soma::Soma(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+Soma::Soma(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -23,7 +23,7 @@ void Soma::initialise()
         {
             std::cout << "Creating AxonHillock" << std::endl;
             onwardAxonHillock = std::make_shared<AxonHillock>(
-                    std::make_shared<Position>(position->x + 1, position->y + 1, position->z + 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+                    position.offsetBy(1, 1, 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         }
         std::cout << "Soma initialising AxonHillock" << std::endl;
         onwardAxonHillock->initialise();
@@ -32,7 +32,7 @@ void Soma::initialise()
 
         std::cout << "Creating DendriteBranch" << std::endl;
         auto dendriteBranch = std::make_shared<DendriteBranch>(
-                std::make_shared<Position>(position->x - 1, position->y - 1, position->z - 1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
+                position.offsetBy(-1, -1, -1), std::static_pointer_cast<NeuronalComponent>(shared_from_this()));
         addDendriteBranch(dendriteBranch);
 
         std::cout << "Soma initialising DendriteBranch" << std::endl;
@@ -45,24 +45,38 @@ void Soma::initialise()
     std::cout << "Soma initialised" << std::endl;
 }
 
-void Soma::update(double deltaTime)
+bool Soma::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Update the axon hillock
     if (onwardAxonHillock)
     {
-        onwardAxonHillock->update(deltaTime);
+        changed |= onwardAxonHillock->update(deltaTime);
     }
 
     // Update dendrite branches
     for (auto& onwardDendriteBranch : dendriteBranches)
     {
-        onwardDendriteBranch->update(deltaTime);
+        changed |= onwardDendriteBranch->update(deltaTime);
     }
 
     // Additional updates if necessary
+    return changed;
+}
+
+void Soma::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
+    if (onwardAxonHillock)
+    {
+        onwardAxonHillock->collectComponents(components);
+    }
+    for (auto& onwardDendriteBranch : dendriteBranches)
+    {
+        onwardDendriteBranch->collectComponents(components);
+    }
 }
 
 std::shared_ptr<AxonHillock> Soma::getAxonHillock() const
@@ -74,10 +88,9 @@ void Soma::addDendriteBranch(std::shared_ptr<DendriteBranch> dendriteBranch)
 {
     auto coords = get_coordinates(static_cast<int>(dendriteBranches.size() + 1),
                                   static_cast<int>(dendriteBranches.size() + 1), 5);
-    auto currentPosition = dendriteBranch->getPosition();
-    currentPosition->x += static_cast<double>(std::get<0>(coords));
-    currentPosition->y += static_cast<double>(std::get<1>(coords));
-    currentPosition->z += static_cast<double>(std::get<2>(coords));
+    dendriteBranch->translate(static_cast<double>(std::get<0>(coords)),
+                              static_cast<double>(std::get<1>(coords)),
+                              static_cast<double>(std::get<2>(coords)));
     dendriteBranches.emplace_back(std::move(dendriteBranch));
 }
 
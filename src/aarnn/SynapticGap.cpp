@@ -7,7 +7,7 @@
 #include <ctime>
 #include <cmath>
 
-SynapticGap::SynapticGap(const std::shared_ptr<Position>& position, std::weak_ptr<NeuronalComponent> parent)
+SynapticGap::SynapticGap(const Position& position, std::weak_ptr<NeuronalComponent> parent)
         : NeuronalComponent(position, parent)
 {
     // Additional initialization if needed
@@ -25,16 +25,22 @@ void SynapticGap::initialise()
     }
 }
 
-void SynapticGap::update(double deltaTime)
+bool SynapticGap::update(double deltaTime)
 {
     // Update energy levels
-    updateEnergy(deltaTime);
+    bool changed = stepEnergy(deltaTime);
 
     // Update component energy level
     // updateComponent(deltaTime, energyLevel);
 
     // Additional updates if necessary
     // Spike?
+    return changed;
+}
+
+void SynapticGap::collectComponents(std::vector<NeuronalComponent*>& components)
+{
+    components.push_back(this);
 }
 
 bool SynapticGap::isAssociated() const
@@ -70,6 +76,7 @@ void SynapticGap::updateFromDendriteBouton(std::shared_ptr<DendriteBouton> paren
 void SynapticGap::updateComponent(double time, double energy)
 {
     componentEnergyLevel = calculateEnergy(time, componentEnergyLevel + energy);  // Update the component energy level
+    wake(); // Input delivered: the owning neuron has to run again
 
     // Propagate energy or signal to connected components if necessary
 }
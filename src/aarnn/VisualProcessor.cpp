@@ -2,11 +2,13 @@
 #include "VisualProcessor.h"
 #include "StimuliData.h"
 #include <opencv2/opencv.hpp>
+#include <chrono>
 #include <iostream>
 
 VisualProcessor::VisualProcessor(const std::string& host, unsigned short port, const std::string& id)
         : id(id), processing(false), healthy(false) {
     networkClient = std::make_unique<AsyncNetworkClient>(host, port);
+    stimulusChannel = std::make_unique<StimulusChannel>(*networkClient, "Visual:" + id);
 }
 
 VisualProcessor::~VisualProcessor() {
@@ -14,7 +16,9 @@ VisualProcessor::~VisualProcessor() {
 }
 
 bool VisualProcessor::initialise() {
+    stimulusChannel->open();
     healthy = networkClient->connect();
+    metrics.connected(healthy);
     if (!healthy) {
         std::cerr << "VisualProcessor: Failed to connect to sensory receptor server." << std::endl;
     }
@@ -39,7 +43,15 @@ void VisualProcessor::stopProcessing() {
 }
 
 bool VisualProcessor::isHealthy() const {
-    return healthy.load();
+    return healthy.load() && !networkClient->hasFailed();
+}
+
+bool VisualProcessor::isConnected() const {
+    return networkClient->isConnected();
+}
+
+boost::json::object VisualProcessor::getMetrics() const {
+    return metrics.toJson(*stimulusChannel, *networkClient);
 }
 
 void VisualProcessor::setVisualReceptors(const std::vector<std::shared_ptr<SensoryReceptor>>& receptors) {
@@ -59,29 +71,29 @@ void VisualProcessor::captureVisualData() {
             continue;
         }
 
-        processVisualData(frame);
+        metrics.captured();
+        processVisualData(frame, stimulusClockMicros());
         std::this_thread::sleep_for(std::chrono::milliseconds(30));
     }
 }
 
-void VisualProcessor::processVisualData(cv::Mat& frame) {
+void VisualProcessor::processVisualData(cv::Mat& frame, std::uint64_t captureMicros) {
+    const auto started = std::chrono::steady_clock::now();
     cv::Mat gray;
     cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
 
     double averageIntensity = cv::mean(gray)[0];
     stimulateReceptors(averageIntensity);
+    metrics.processed(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count()));
 
-    StimuliData data;
-    data.receptorType = "Visual:" + id;
-    data.values = { averageIntensity };
-
-    std::string json = serializeStimuliData(data);
-    try {
-        networkClient->send(json);
-        healthy = true;
-    } catch (...) {
-        std::cerr << "VisualProcessor: Failed to send data. Marking as unhealthy." << std::endl;
-        healthy = false;
+    // As in AuditoryProcessor, health follows the transport and only frames refused by a
+    // failed connection count as send errors
+    const bool accepted = stimulusChannel->send({ averageIntensity }, captureMicros);
+    if (accepted || !networkClient->hasFailed()) {
+        metrics.sent(accepted, captureMicros);
+    } else {
+        metrics.sendFailed();
     }
 }
 
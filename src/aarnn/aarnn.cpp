@@ -21,21 +21,83 @@
 #include "Cluster.h"
 #include "SensoryReceptor.h"
 #include "Effector.h"
+#include "EffectorBank.h"
+#include "EffectorServer.h"
 #include "Neuron.h"
 #include "AuditoryManager.h"
 #include "SensoryReceptorServer.h"
+#include "ThreadPinning.h"
+#include "SensoryModalityRegistry.h"
+#include "StatsRegistry.h"
+#include "TickScheduler.h"
+#include "TripleBuffer.h"
+#include "DeterministicRandom.h"
+#include "ActivityCounter.h"
+#include <cstring>
+#include <numeric>
 
 
 //std::atomic<double> totalPropagationRate(0.0);
 std::mutex mtx;
 std::unordered_set<std::shared_ptr<Neuron>> changedNeurons;
 std::unordered_set<std::shared_ptr<Cluster>> changedClusters;
-std::mutex changedNeuronsMutex;
+InstrumentedMutex changedNeuronsMutex("changedNeuronsMutex");
 std::atomic<bool> running(true);
-std::condition_variable cv;
+std::condition_variable_any cv;
 std::atomic<bool> dbUpdateReady(false);
 std::mutex clustersMutex;
 
+// Step count used by --no-io when --steps is not given
+constexpr long long DEFAULT_BATCH_STEPS = 1000;
+
+// Rates of the simulation pipeline stages. Each stage runs on its own TickScheduler;
+// state flows from the neural stage to persistence through a TripleBuffer, so a slow
+// database never holds up neural updates. Receptors do not yet propagate into the
+// clusters, so there is no sensory-to-neural handoff. --no-io uses the sensory and
+// neural periods as fixed time steps.
+struct PipelineRates {
+    double sensoryHz = 10.0;     // Receptor updates (main thread)
+    double neuralHz = 4.0;       // Cluster updates
+    double persistenceHz = 2.0;  // Database writes
+};
+
+// Persistence progress, reported under "pipeline" in the runtime statistics
+std::atomic<std::uint64_t> publishedSnapshotVersion(0);
+std::atomic<std::uint64_t> persistedSnapshotVersion(0);
+std::atomic<std::uint64_t> skippedSnapshots(0);
+
+// Share of neurons and receptors actually updated per tick (the rest had settled),
+// reported under "activity" in the runtime statistics
+ActivityCounter neuronActivity;
+ActivityCounter receptorActivity;
+
+#ifdef AARNN_STATE_VALIDATION
+// Drift of stored component energies from the double reference after the latest
+// neural step, reported under "precision"
+std::mutex energyDriftMutex;
+EnergyDrift latestEnergyDrift;
+#endif
+
+TickScheduler::Clock::duration periodFromRate(double hz) {
+    return std::chrono::duration_cast<TickScheduler::Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+}
+
+double readRate(const std::map<std::string, std::string>& config, const std::string& key, double fallback) {
+    auto it = config.find(key);
+    if (it == config.end() || it->second.empty()) {
+        return fallback;
+    }
+    try {
+        double rate = std::stod(it->second);
+        if (rate > 0.0) {
+            return rate;
+        }
+    } catch (const std::exception&) {
+    }
+    std::cerr << "[WARNING] Invalid " << key << "='" << it->second << "'; using " << fallback << " Hz." << std::endl;
+    return fallback;
+}
+
 // Configuration and Logger Initialization
 
 // Function to simulate logging from multiple threads
@@ -63,6 +125,11 @@ void checkForQuit() {
                 // EOF, maybe also break
                 break;
             }
+            if (key == 's') {
+                // Dump runtime statistics (lock contention etc.) without stopping
+                std::cout << boost::json::serialize(StatsRegistry::instance().snapshot()) << std::endl;
+                continue;
+            }
             if (key == 'q') {
                 running = false;
                 dbUpdateReady = true;
@@ -87,48 +154,194 @@ double computePropagationRate(const std::shared_ptr<Neuron>& neuron) {
     neuron->setPropagationRate(propagationRate);
 
     //{
-    //    std::lock_guard<std::mutex> lock(changedNeuronsMutex);
+    //    std::lock_guard<InstrumentedMutex> lock(changedNeuronsMutex);
     //    changedNeurons.insert(neuron);
     //}
 
     return propagationRate;
 }
 
-void updateClusters(std::vector<std::shared_ptr<Cluster>>& clusters, std::atomic<bool>& clusterRunning) {
-    auto lastTime = std::chrono::steady_clock::now();
-    while (clusterRunning) {
-        auto currentTime = std::chrono::steady_clock::now();
-        std::chrono::duration<double> elapsedTime = currentTime - lastTime;
-        double deltaTime = elapsedTime.count();
-        lastTime = currentTime;
-
-        // Update each cluster with the new deltaTime
-        for (auto& cluster : clusters) {
-            if (cluster) {
-                cluster->update(deltaTime);
-            }
+// Advance every cluster by one step and record how many neurons were active or deferred
+void stepClusters(std::vector<std::shared_ptr<Cluster>>& clusters, double deltaTime) {
+    std::uint64_t active = 0;
+    std::uint64_t total = 0;
+    std::uint64_t deferred = 0;
+    for (auto& cluster : clusters) {
+        if (cluster) {
+            cluster->update(deltaTime);
+            active += cluster->getActiveNeuronCount();
+            total += cluster->getNeuronCount();
+            deferred += cluster->getDeferredNeuronCount();
         }
+    }
+    neuronActivity.record(active, total, deferred);
 
-        // Signal database update
-        {
-            std::lock_guard<std::mutex> lock(changedNeuronsMutex);
-            dbUpdateReady = true;
+#ifdef AARNN_STATE_VALIDATION
+    EnergyDrift drift;
+    for (auto& cluster : clusters) {
+        if (cluster) {
+            cluster->measureEnergyDrift(drift);
         }
-        cv.notify_one();
+    }
+    std::lock_guard<std::mutex> lock(energyDriftMutex);
+    latestEnergyDrift = drift;
+#endif
+}
+
+void updateClusters(std::vector<std::shared_ptr<Cluster>>& clusters, std::atomic<bool>& clusterRunning,
+                    const PipelineRates& rates, TripleBuffer<NetworkSnapshot>* snapshots, EffectorServer* effectors) {
+    TickScheduler scheduler("neural", periodFromRate(rates.neuralHz));
+
+    // Update each cluster with the time elapsed since its previous update
+    scheduler.addPhase({"cluster_update", [&clusters](double deltaTime) {
+        stepClusters(clusters, deltaTime);
+    }});
+
+    // Read the effectors out on this thread, while their synaptic gaps hold still, and
+    // push the result to subscribers
+    if (effectors) {
+        scheduler.addPhase({"effector_publish", [effectors, tick = std::uint64_t{0}](double) mutable {
+            effectors->publish(++tick);
+        }});
+    }
+
+    // Hand the latest state to the persistence stage. Only captured as often as it can
+    // be written, and sheddable: under load the database (and so the visualiser, which
+    // reads from it) is refreshed less often before neural updates slip.
+    if (snapshots) {
+        auto captureEvery = static_cast<unsigned>(std::max(1.0, std::round(rates.neuralHz / rates.persistenceHz)));
+        scheduler.addPhase({"snapshot_capture", [&clusters, snapshots](double) {
+            captureNetworkSnapshot(clusters, snapshots->writeBuffer());
+            snapshots->publish();
+            publishedSnapshotVersion = snapshots->publishedVersion();
+        }, captureEvery, true});
+    }
+
+    scheduler.run(clusterRunning);
+
+    // The final state, so persistence writes it before it shuts down
+    if (snapshots) {
+        captureNetworkSnapshot(clusters, snapshots->writeBuffer());
+        snapshots->publish();
+        publishedSnapshotVersion = snapshots->publishedVersion();
+    }
+}
 
-        // Sleep for 250 milliseconds
-        std::this_thread::sleep_for(std::chrono::milliseconds(250));
+// Writes the newest published snapshot, if any; older unwritten ones are skipped
+void flushLatestSnapshot(pqxx::connection& conn, TripleBuffer<NetworkSnapshot>& snapshots) {
+    if (!snapshots.acquire()) {
+        return;
+    }
+    std::uint64_t version = snapshots.readVersion();
+    std::uint64_t previous = persistedSnapshotVersion.load();
+    if (previous != 0 && version > previous + 1) {
+        skippedSnapshots += version - previous - 1;
     }
+    try {
+        flushNetworkSnapshot(conn, snapshots.readBuffer());
+        persistedSnapshotVersion = version;
+    } catch (const std::exception& e) {
+        std::cerr << "[DB UPDATE ERROR] " << e.what() << "\n";
+    }
+}
 
-    // Signal database thread to exit
-    {
-        std::lock_guard<std::mutex> lock(changedNeuronsMutex);
-        dbUpdateReady = true;
+// Runs until persisting is cleared, which the caller does only after the neural stage
+// has stopped and published its final snapshot; that snapshot is written on the way out
+void persistSnapshots(pqxx::connection& conn, TripleBuffer<NetworkSnapshot>& snapshots,
+                      const PipelineRates& rates, std::atomic<bool>& persisting) {
+    TickScheduler scheduler("persistence", periodFromRate(rates.persistenceHz));
+    scheduler.addPhase({"db_flush", [&conn, &snapshots](double) {
+        flushLatestSnapshot(conn, snapshots);
+    }});
+
+    scheduler.run(persisting);
+    flushLatestSnapshot(conn, snapshots);
+    std::cout << "[DB UPDATE] Shutting down persistence thread.\n";
+}
+
+// Advance every receptor bank by one step. Shared by the paced main loop and the
+// headless batch loop so both modes do identical work per step.
+void updateReceptors(SensoryModalityRegistry& modalities, double deltaTime) {
+    std::uint64_t active = modalities.update(deltaTime);
+    receptorActivity.record(active, modalities.getReceptorCount());
+}
+
+// FNV-1a over the bit patterns of the persisted network state and the receptor
+// energies. Two runs with the same seed and step count should print the same digest.
+std::uint64_t stateDigest(const std::vector<std::shared_ptr<Cluster>>& clusters,
+                          const SensoryModalityRegistry& modalities) {
+    std::uint64_t digest = 0xcbf29ce484222325ULL;
+    auto addValue = [&digest](double value) {
+        std::uint64_t valueBits;
+        std::memcpy(&valueBits, &value, sizeof(valueBits));
+        for (int byte = 0; byte < 8; ++byte) {
+            digest ^= (valueBits >> (byte * 8)) & 0xff;
+            digest *= 0x100000001b3ULL;
+        }
+    };
+
+    NetworkSnapshot snapshot;
+    captureNetworkSnapshot(clusters, snapshot);
+    for (const auto* table : {&snapshot.clusters, &snapshot.neurons, &snapshot.somas, &snapshot.axonHillocks,
+                              &snapshot.axons, &snapshot.axonBoutons, &snapshot.synapticGaps, &snapshot.axonBranches,
+                              &snapshot.dendriteBranches, &snapshot.dendrites, &snapshot.dendriteBoutons}) {
+        for (const auto& row : *table) {
+            addValue(row.x);
+            addValue(row.y);
+            addValue(row.z);
+            addValue(row.energyLevel);
+            addValue(row.propagationRate);
+        }
+    }
+    for (const auto& bank : modalities.getBanks()) {
+        for (std::size_t i = 0; i < bank->size(); ++i) {
+            addValue(bank->getEnergyLevel(i));
+        }
     }
-    cv.notify_one();
+    return digest;
 }
 
-int main() {
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [--steps N] [--no-io] [--seed N]\n"
+              << "  --steps N  Stop after N simulation steps (default: run until 'q')\n"
+              << "  --seed N   Run seed for all random draws (overrides random_seed in simulation.conf)\n"
+              << "  --no-io    Headless batch mode: no database, sensory server or input thread;\n"
+              << "             runs receptor and cluster updates back to back and reports steps/s" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    long long maxSteps = 0;  // 0 = unbounded
+    bool noIo = false;
+    std::string seedArgument;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--no-io") {
+            noIo = true;
+        } else if (arg == "--seed" && i + 1 < argc) {
+            seedArgument = argv[++i];
+        } else if (arg == "--steps" && i + 1 < argc) {
+            try {
+                maxSteps = std::stoll(argv[++i]);
+            } catch (const std::exception&) {
+                maxSteps = -1;
+            }
+            if (maxSteps <= 0) {
+                std::cerr << "[ERROR] --steps expects a positive integer." << std::endl;
+                return 1;
+            }
+        } else if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            std::cerr << "[ERROR] Unknown argument: " << arg << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (noIo && maxSteps == 0) {
+        maxSteps = DEFAULT_BATCH_STEPS;
+    }
+
     // Initialise Logger
     Logger logger("errors_aarnn.log");
     std::thread t1(logMessages, std::ref(logger), 1);
@@ -140,11 +353,29 @@ int main() {
     std::vector<std::string> config_filenames = {"simulation.conf"};
     auto config = read_config(config_filenames);
 
+    // Seed every random stream before any network component is created
+    if (seedArgument.empty()) {
+        seedArgument = config["random_seed"];
+    }
+    std::uint64_t runSeed = 0;
+    if (!seedArgument.empty()) {
+        try {
+            runSeed = std::stoull(seedArgument);
+        } catch (const std::exception&) {
+            std::cerr << "[ERROR] Invalid random seed: " << seedArgument << std::endl;
+            return 1;
+        }
+    }
+    DeterministicRandom::setRunSeed(runSeed);
+    std::cout << "Random seed: " << runSeed << std::endl;
+
     std::string connection_string;
     bool dbAvailable = false;
 
-    // Attempt to initialise database connection
-    if (!initialiseDatabaseConnection(connection_string)) {
+    // Attempt to initialise database connection (skipped entirely in --no-io mode)
+    if (noIo) {
+        std::cout << "Headless mode: database and sensory server disabled." << std::endl;
+    } else if (!initialiseDatabaseConnection(connection_string)) {
         std::cerr << "[WARNING] Failed to initialise database connection. Continuing without database." << std::endl;
     } else {
         try {
@@ -163,27 +394,97 @@ int main() {
 
     // Initialise SensoryReceptorServer
     SensoryReceptorServer receptorServer;
-    if (!receptorServer.initialise()) {
+
+    // Dedicated ingestion cores: the server's threads are pinned to them and this
+    // thread, and so every simulation thread and the OpenMP pool started from it,
+    // is kept off them
+    IoThreadPolicy ioPolicy;
+    if (!noIo && config.count("sensory_io_cpus") && !config["sensory_io_cpus"].empty()) {
+        if (!parseCpuList(config["sensory_io_cpus"], ioPolicy.cpus)) {
+            std::cerr << "[WARNING] Invalid sensory_io_cpus: " << config["sensory_io_cpus"] << "; not pinning." << std::endl;
+        } else if (!excludeCpusFromCurrentThread(ioPolicy.cpus)) {
+            std::cerr << "[WARNING] Cannot reserve cpus " << formatCpuList(ioPolicy.cpus)
+                      << " for sensory ingestion; not pinning." << std::endl;
+            ioPolicy.cpus.clear();
+        }
+    }
+    if (!noIo && config.count("sensory_io_realtime_priority") && !config["sensory_io_realtime_priority"].empty()) {
+        ioPolicy.realtimePriority = std::clamp(std::stoi(config["sensory_io_realtime_priority"]), 0, 99);
+    }
+    receptorServer.setIoThreadPolicy(ioPolicy);
+
+    if (!noIo && !receptorServer.initialise()) {
         std::cerr << "Failed to initialise Sensory Receptor Server." << std::endl;
     }
 
+    // Hold timestamped stimuli until capture time + budget so modalities line up; 0 = off
+    if (config.count("sensory_latency_budget_ms") && !config["sensory_latency_budget_ms"].empty()) {
+        const double budgetMs = std::stod(config["sensory_latency_budget_ms"]);
+        receptorServer.setLatencyBudget(static_cast<std::uint64_t>(std::max(0.0, budgetMs) * 1000.0));
+    }
+
+    // Effector output stream, only if EFFECTOR_SERVER_PORT is set
+    double effectorEpsilon = config.count("effector_delta_epsilon") ? std::stod(config["effector_delta_epsilon"]) : 1e-6;
+    int effectorKeyframeInterval = config.count("effector_keyframe_interval")
+                                   ? std::stoi(config["effector_keyframe_interval"]) : 100;
+    EffectorServer effectorServer(effectorEpsilon, static_cast<std::uint32_t>(std::max(effectorKeyframeInterval, 1)));
+    bool streamEffectors = !noIo && effectorServer.initialise();
+
     int num_clusters = std::stoi(config["num_clusters"]);
     int num_neurons = std::stoi(config["num_neurons"]);
-    int num_pixels = std::stoi(config["num_pixels"]);
-    int num_phonels = std::stoi(config["num_phonels"]);
-    int num_scentels = std::stoi(config["num_scentels"]);
     int num_vocels = std::stoi(config["num_vocels"]);
     int neuron_points_per_layer = std::stoi(config["neuron_points_per_layer"]);
-    int pixel_points_per_layer = std::stoi(config["pixel_points_per_layer"]);
-    int phonel_points_per_layer = std::stoi(config["phonel_points_per_layer"]);
-    int scentel_points_per_layer = std::stoi(config["scentel_points_per_layer"]);
     int vocel_points_per_layer = std::stoi(config["vocel_points_per_layer"]);
     double proximityThreshold = std::stod(config["proximity_threshold"]);
-    bool useDatabase = convertStringToBool(config["use_database"]);
+    bool useDatabase = !noIo && convertStringToBool(config["use_database"]);
+    bool lazyEnergy = config.count("lazy_energy") && convertStringToBool(config["lazy_energy"]);
+    PipelineRates rates;
+    rates.sensoryHz = readRate(config, "sensory_rate_hz", rates.sensoryHz);
+    rates.neuralHz = readRate(config, "neural_rate_hz", rates.neuralHz);
+    rates.persistenceHz = readRate(config, "persistence_rate_hz", rates.persistenceHz);
+    StatsRegistry::instance().registerProvider("pipeline", [rates]() {
+        boost::json::object pipeline;
+        pipeline["sensory_rate_hz"] = rates.sensoryHz;
+        pipeline["neural_rate_hz"] = rates.neuralHz;
+        pipeline["persistence_rate_hz"] = rates.persistenceHz;
+        std::uint64_t published = publishedSnapshotVersion.load();
+        std::uint64_t persisted = persistedSnapshotVersion.load();
+        pipeline["published_snapshot"] = published;
+        pipeline["persisted_snapshot"] = persisted;
+        pipeline["persistence_lag"] = published - std::min(published, persisted);
+        pipeline["skipped_snapshots"] = skippedSnapshots.load();
+        return boost::json::value(std::move(pipeline));
+    });
+    StatsRegistry::instance().registerProvider("activity", []() {
+        boost::json::object activity;
+        activity["neurons"] = neuronActivity.toJson();
+        activity["receptors"] = receptorActivity.toJson();
+        return boost::json::value(std::move(activity));
+    });
+    StatsRegistry::instance().registerProvider("precision", []() {
+        boost::json::object precision;
+        precision["state_storage"] = STATE_PRECISION_NAME;
+        precision["position_storage"] = POSITION_PRECISION_NAME;
+        precision["component_bytes"] = sizeof(NeuronalComponent);
+#ifdef AARNN_STATE_VALIDATION
+        EnergyDrift drift;
+        {
+            std::lock_guard<std::mutex> lock(energyDriftMutex);
+            drift = latestEnergyDrift;
+        }
+        boost::json::object energyDrift;
+        energyDrift["components"] = drift.components;
+        energyDrift["mean_abs"] = drift.components ? drift.sumAbsolute / static_cast<double>(drift.components) : 0.0;
+        energyDrift["max_abs"] = drift.maxAbsolute;
+        energyDrift["max_rel"] = drift.maxRelative;
+        precision["energy_drift"] = std::move(energyDrift);
+#endif
+        return boost::json::value(std::move(precision));
+    });
     double deltaTime = 0.01; // Time step in seconds (10 milliseconds)
 
     // If the user requested database but it's unavailable, log a warning
-    if (convertStringToBool(config["use_database"]) && !dbAvailable) {
+    if (useDatabase && !dbAvailable) {
         std::cerr << "[WARNING] Database operations are disabled; 'use_database' is true but connection failed." << std::endl;
     }
 
@@ -217,6 +518,7 @@ int main() {
         auto cluster = Cluster::createCluster(100.0);
         cluster->initialise(num_neurons, neuron_points_per_layer, proximityThreshold);
         cluster->setPropagationRate(1.0);
+        cluster->setLazyEnergy(lazyEnergy);
         clusters.emplace_back(cluster);
     }
 
@@ -229,186 +531,28 @@ int main() {
         allNeurons.insert(allNeurons.end(), neuronsInCluster.begin(), neuronsInCluster.end());
     }
 
-    // std::cout << "Debug Step 1." << std::endl;
-    // Create visual inputs
-    std::vector<std::vector<std::shared_ptr<SensoryReceptor>>> visualReceptors(2);
-    visualReceptors[0].reserve(num_pixels / 2);
-    visualReceptors[1].reserve(num_pixels / 2);
-
-    double shiftX, shiftY, shiftZ;
-    double newPositionX, newPositionY, newPositionZ;
-    // std::cout << "Debug Step 2." << std::endl;
-
-    for (int j = 0; j < 2; ++j) {
-        for (int i = 0; i < (num_pixels / 2); ++i) {
-            auto coords = get_coordinates(i, num_pixels, pixel_points_per_layer);
-
-            shiftX = std::get<0>(coords) - 100 + (j * 200);
-            shiftY = std::get<1>(coords);
-            shiftZ = std::get<2>(coords) - 100;
-
-            auto receptorPosition = std::make_shared<Position>(shiftX, shiftY, shiftZ);
-            auto receptor = std::make_shared<SensoryReceptor>(receptorPosition);
-            receptor->initialise();
-            visualReceptors[j].emplace_back(receptor);
-
-            // Connect the receptor to neurons across all clusters
-            if (i > 0 && i % 7 == 0) {
-                // Calculate the neuron index to connect to
-                int neuronIndex = (i + ((num_pixels / 2) * j)) % allNeurons.size();
-                auto neuron = allNeurons[neuronIndex];
-                // std::cout << "Debug Step 3." << std::endl;
-
-                // Adjust positions for connection
-                PositionPtr currentDendriteBoutonPosition = neuron->getSoma()->getDendriteBranches()[0]
-                        ->getDendrites()[0]->getDendriteBouton()->getPosition();
-                // std::cout << "Debug Step 3a." << std::endl;
-                PositionPtr currentSynapticGapPosition = receptor->getSynapticGaps()[0]->getPosition();
-
-                // std::cout << "Debug Step 4." << std::endl;
-                newPositionX = currentSynapticGapPosition->x + 0.4;
-                newPositionY = currentSynapticGapPosition->y + 0.4;
-                newPositionZ = currentSynapticGapPosition->z + 0.4;
-
-                currentDendriteBoutonPosition->x = newPositionX;
-                currentDendriteBoutonPosition->y = newPositionY;
-                currentDendriteBoutonPosition->z = newPositionZ;
-
-                PositionPtr currentDendritePosition = neuron->getSoma()->getDendriteBranches()[0]
-                        ->getDendrites()[0]->getPosition();
-
-                newPositionX += 0.4;
-                newPositionY += 0.4;
-                newPositionZ += 0.4;
-
-                currentDendritePosition->x = newPositionX;
-                currentDendritePosition->y = newPositionY;
-                currentDendritePosition->z = newPositionZ;
-                // std::cout << "Debug Step 5." << std::endl;
-
-                // Associate synaptic gap
-                associateSynapticGap(*receptor, *neuron, proximityThreshold);
-            }
-        }
-    }
-
-    std::cout << "Created " << (visualReceptors[0].size() + visualReceptors[1].size()) << " visual sensory receptors."
-              << std::endl;
-
-    // Create audio inputs (left/right “hemispheres”)
-    std::vector<std::vector<std::shared_ptr<SensoryReceptor>>> auditoryReceptors(2);
-    auditoryReceptors[0].reserve(num_phonels / 2);
-    auditoryReceptors[1].reserve(num_phonels / 2);
-
-    for (int j = 0; j < 2; ++j) {
-        for (int i = 0; i < (num_phonels / 2); ++i) {
-            auto coords = get_coordinates(i, num_phonels, phonel_points_per_layer);
-
-            shiftX = std::get<0>(coords) - 150 + (j * 300);
-            shiftY = std::get<1>(coords);
-            shiftZ = std::get<2>(coords);
-
-            auto receptorPosition = std::make_shared<Position>(shiftX, shiftY, shiftZ);
-            auto receptor = std::make_shared<SensoryReceptor>(receptorPosition);
-            receptor->initialise();
-            auditoryReceptors[j].push_back(receptor);
-
-            // Connect the receptor to neurons across all clusters
-            if (i > 0 && i % 11 == 0) {
-                // Calculate the neuron index to connect to
-                int neuronIndex = (i + ((num_phonels / 2) * j)) % allNeurons.size();
-                auto neuron = allNeurons[neuronIndex];
-
-                // Adjust positions for connection
-                PositionPtr currentDendriteBoutonPosition = neuron->getSoma()->getDendriteBranches()[0]
-                        ->getDendrites()[0]->getDendriteBouton()->getPosition();
-                PositionPtr currentSynapticGapPosition = receptor->getSynapticGaps()[0]->getPosition();
-
-                newPositionX = currentSynapticGapPosition->x + 0.4;
-                newPositionY = currentSynapticGapPosition->y + 0.4;
-                newPositionZ = currentSynapticGapPosition->z + 0.4;
-
-                currentDendriteBoutonPosition->x = newPositionX;
-                currentDendriteBoutonPosition->y = newPositionY;
-                currentDendriteBoutonPosition->z = newPositionZ;
-
-                PositionPtr currentDendritePosition = neuron->getSoma()->getDendriteBranches()[0]
-                        ->getDendrites()[0]->getPosition();
-
-                newPositionX += 0.4;
-                newPositionY += 0.4;
-                newPositionZ += 0.4;
-
-                currentDendritePosition->x = newPositionX;
-                currentDendritePosition->y = newPositionY;
-                currentDendritePosition->z = newPositionZ;
-
-                // Associate synaptic gap
-                associateSynapticGap(*receptor, *neuron, proximityThreshold);
-            }
-        }
-    }
-
-    std::cout << "Created "
-              << (auditoryReceptors[0].size() + auditoryReceptors[1].size())
-              << " audio sensory receptors." << std::endl;
-
-    // Create olfactory inputs
-    std::vector<std::vector<std::shared_ptr<SensoryReceptor>>> olfactoryReceptors(2);
-    olfactoryReceptors[0].reserve(num_scentels / 2);
-    olfactoryReceptors[1].reserve(num_scentels / 2);
-
-    for (int j = 0; j < 2; ++j) {
-        for (int i = 0; i < (num_scentels / 2); ++i) {
-            auto coords = get_coordinates(i, num_scentels, scentel_points_per_layer);
-
-            shiftX = std::get<0>(coords) - 20 + (j * 40);
-            shiftY = std::get<1>(coords) - 10;
-            shiftZ = std::get<2>(coords) - 10;
-
-            auto receptorPosition = std::make_shared<Position>(shiftX, shiftY, shiftZ);
-            auto receptor = std::make_shared<SensoryReceptor>(receptorPosition);
-            receptor->initialise();
-            olfactoryReceptors[j].push_back(receptor);
-
-            // Connect the receptor to neurons across all clusters
-            if (i > 0 && i % 13 == 0) {
-                // Calculate the neuron index to connect to
-                int neuronIndex = (i + ((num_scentels / 2) * j)) % allNeurons.size();
-                auto neuron = allNeurons[neuronIndex];
-
-                // Adjust positions for connection
-                PositionPtr currentDendriteBoutonPosition = neuron->getSoma()->getDendriteBranches()[0]
-                        ->getDendrites()[0]->getDendriteBouton()->getPosition();
-                PositionPtr currentSynapticGapPosition = receptor->getSynapticGaps()[0]->getPosition();
-
-                newPositionX = currentSynapticGapPosition->x + 0.4;
-                newPositionY = currentSynapticGapPosition->y + 0.4;
-                newPositionZ = currentSynapticGapPosition->z + 0.4;
-
-                currentDendriteBoutonPosition->x = newPositionX;
-                currentDendriteBoutonPosition->y = newPositionY;
-                currentDendriteBoutonPosition->z = newPositionZ;
-
-                PositionPtr currentDendritePosition = neuron->getSoma()->getDendriteBranches()[0]
-                        ->getDendrites()[0]->getPosition();
-
-                newPositionX += 0.4;
-                newPositionY += 0.4;
-                newPositionZ += 0.4;
-
-                currentDendritePosition->x = newPositionX;
-                currentDendritePosition->y = newPositionY;
-                currentDendritePosition->z = newPositionZ;
-
-                // Associate synaptic gap
-                associateSynapticGap(*receptor, *neuron, proximityThreshold);
-            }
+    // Create the sensory receptors of every configured modality and wire them to neurons
+    SensoryModalityRegistry sensoryModalities;
+    sensoryModalities.build(SensoryModalityRegistry::readConfig(config));
+    std::size_t wiredReceptors = sensoryModalities.wire(allNeurons, proximityThreshold);
+    std::cout << "Associated " << wiredReceptors << " receptor synaptic gaps with neurons." << std::endl;
+    StatsRegistry::instance().registerProvider("ingest", [banks = sensoryModalities.getBanks()]() {
+        boost::json::object ingest;
+        for (const auto& bank : banks) {
+            const IngestStatistics statistics = bank->getIngestStatistics();
+            boost::json::object entry;
+            entry["policy"] = ingestPolicyName(bank->getIngestPolicy());
+            entry["depth"] = bank->getIngestDepth();
+            entry["received"] = statistics.received;
+            entry["applied"] = statistics.applied;
+            entry["coalesced"] = statistics.coalesced;
+            entry["dropped"] = statistics.dropped;
+            ingest[bank->getName()] = std::move(entry);
         }
-    }
+        return boost::json::value(std::move(ingest));
+    });
 
-    std::cout << "Created " << (olfactoryReceptors[0].size() + olfactoryReceptors[1].size())
-              << " olfactory sensory receptors." << std::endl;
+    double shiftX, shiftY, shiftZ;
 
     // Create effectors
     std::vector<std::shared_ptr<Effector>> vocalOutputs;
@@ -421,8 +565,7 @@ int main() {
         shiftY = std::get<1>(coords) - 100;
         shiftZ = std::get<2>(coords) + 10;
 
-        auto effectorPosition = std::make_shared<Position>(shiftX, shiftY, shiftZ);
-        auto effector = std::make_shared<Effector>(effectorPosition);
+        auto effector = std::make_shared<Effector>(Position(shiftX, shiftY, shiftZ));
         effector->initialise();
         vocalOutputs.emplace_back(effector);
 
@@ -432,47 +575,30 @@ int main() {
             int neuronIndex = (i + num_vocels) % allNeurons.size();
             auto neuron = allNeurons[neuronIndex];
 
-            // Adjust positions for connection
-            PositionPtr currentSynapticGapPosition = neuron->getSoma()->getAxonHillock()->getAxon()
-                    ->getAxonBouton()->getSynapticGap()->getPosition();
-            PositionPtr currentEffectorPosition = effector->getPosition();
-
-            newPositionX = currentEffectorPosition->x - 0.4;
-            newPositionY = currentEffectorPosition->y - 0.4;
-            newPositionZ = currentEffectorPosition->z - 0.4;
-
-            currentSynapticGapPosition->x = newPositionX;
-            currentSynapticGapPosition->y = newPositionY;
-            currentSynapticGapPosition->z = newPositionZ;
-
-            PositionPtr currentAxonBoutonPosition = neuron->getSoma()->getAxonHillock()->getAxon()
-                    ->getAxonBouton()->getPosition();
+            // Move the axon, its bouton and its synaptic gap next to the effector
+            const auto& axon = neuron->getSoma()->getAxonHillock()->getAxon();
+            const Position& effectorPosition = effector->getPosition();
+            axon->getAxonBouton()->getSynapticGap()->moveTo(effectorPosition.offsetBy(-0.4, -0.4, -0.4));
+            axon->getAxonBouton()->moveTo(effectorPosition);
+            axon->moveTo(effectorPosition.offsetBy(0.4, 0.4, 0.4));
 
-            newPositionX += 0.4;
-            newPositionY += 0.4;
-            newPositionZ += 0.4;
-
-            currentAxonBoutonPosition->x = newPositionX;
-            currentAxonBoutonPosition->y = newPositionY;
-            currentAxonBoutonPosition->z = newPositionZ;
-
-            PositionPtr currentAxonPosition = neuron->getSoma()->getAxonHillock()->getAxon()->getPosition();
-
-            newPositionX += 0.4;
-            newPositionY += 0.4;
-            newPositionZ += 0.4;
-
-            currentAxonPosition->x = newPositionX;
-            currentAxonPosition->y = newPositionY;
-            currentAxonPosition->z = newPositionZ;
-
-            neuron->getSoma()->getAxonHillock()->getAxon()->getAxonBouton()->getSynapticGap()->setAsAssociated();
+            axon->getAxonBouton()->getSynapticGap()->setAsAssociated();
+            effector->addSynapticGap(axon->getAxonBouton()->getSynapticGap());
         }
     }
 
     std::cout << "Created " << vocalOutputs.size() << " effectors." << std::endl;
-
-    // Associate neurons between clusters
+    effectorServer.registerBank(std::make_shared<EffectorBank>("Vocal", vocalOutputs));
+
+    // Associate neurons between clusters. Candidates are found in parallel and connected
+    // serially in (cluster1, cluster2, neuron1, neuron2) order, so the wiring is the same
+    // for any thread count.
+    struct InterClusterCandidates {
+        std::shared_ptr<Neuron> neuron1;
+        std::shared_ptr<Neuron> neuron2;
+        std::vector<SynapseCandidate> found;
+    };
+    std::vector<std::vector<InterClusterCandidates>> interClusterCandidates(clusters.size());
 #pragma omp parallel for schedule(dynamic)
     for (size_t c1 = 0; c1 < clusters.size(); ++c1) {
         auto &cluster1 = clusters[c1];
@@ -481,19 +607,27 @@ int main() {
             // Associate neurons between clusters
             for (const auto &neuron1: cluster1->getNeurons()) {
                 for (const auto &neuron2: cluster2->getNeurons()) {
-                    associateSynapticGap(*neuron1, *neuron2, proximityThreshold);
+                    auto found = findSynapseCandidates(*neuron1, *neuron2, proximityThreshold);
+                    if (!found.empty()) {
+                        interClusterCandidates[c1].push_back({neuron1, neuron2, std::move(found)});
+                    }
                 }
             }
         }
     }
+    for (const auto &candidatesForCluster: interClusterCandidates) {
+        for (const auto &candidate: candidatesForCluster) {
+            applySynapseCandidates(*candidate.neuron1, *candidate.neuron2, candidate.found);
+        }
+    }
 
     // Prepare to compute propagation rates using threads
-    const size_t numThreads = std::thread::hardware_concurrency();
+    const size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
     std::vector<std::thread> threads(numThreads);
 
-// Declare a mutex and the totalPropagationRate variable
-    std::mutex totalPropagationRateMutex;
-    double totalPropagationRate = 0.0;
+// Each thread stores its neurons' rates; the total is summed afterwards in neuron order,
+// so it does not depend on the thread count or on which thread finishes first
+    std::vector<double> propagationRates(allNeurons.size(), 0.0);
 
 // Calculate the number of neurons per thread
     size_t totalNeurons = allNeurons.size();
@@ -504,16 +638,9 @@ int main() {
     size_t start = 0;
     for (size_t t = 0; t < numThreads; ++t) {
         size_t end = start + neuronsPerThread + (t < remainingNeurons ? 1 : 0);
-        threads[t] = std::thread([start, end, &allNeurons, &totalPropagationRate, &totalPropagationRateMutex]() {
-            double localSum = 0.0;
+        threads[t] = std::thread([start, end, &allNeurons, &propagationRates]() {
             for (size_t i = start; i < end; ++i) {
-                double propagationRate = computePropagationRate(allNeurons[i]);
-                localSum += propagationRate;
-            }
-            // Protect the addition with a mutex
-            {
-                std::lock_guard<std::mutex> lock(totalPropagationRateMutex);
-                totalPropagationRate += localSum;
+                propagationRates[i] = computePropagationRate(allNeurons[i]);
             }
         });
         start = end;
@@ -523,6 +650,7 @@ int main() {
     for (auto &t: threads) {
         t.join();
     }
+    double totalPropagationRate = std::accumulate(propagationRates.begin(), propagationRates.end(), 0.0);
 
     std::cout << "The total propagation rate is " << totalPropagationRate << std::endl;
 
@@ -546,175 +674,68 @@ int main() {
     }
 
     // Initialise and start the SensoryReceptorServer
-    receptorServer.registerReceptors("Auditory_Left", auditoryReceptors[0]);
-    receptorServer.registerReceptors("Auditory_Right", auditoryReceptors[1]);
-//    std::vector<std::shared_ptr<SensoryReceptor>> &bladderBowelReceptors;
-//    receptorServer.registerReceptors("BladderBowel", bladderBowelReceptors);
-//    receptorServer.registerReceptors("Chemoreception", chemoreceptionReceptors);
-//    receptorServer.registerReceptors("Electroception", electroceptionReceptors);
-//    receptorServer.registerReceptors("Gustatory", gustatoryReceptors);
-//    receptorServer.registerReceptors("HeartbeatRespiration", heartbeatRespirationReceptors);
-//    receptorServer.registerReceptors("HungerThirst", hungerThirstReceptors);
-//    receptorServer.registerReceptors("Interoceptive", interoceptiveReceptors);
-//    receptorServer.registerReceptors("Lust", lustReceptors);
-//    receptorServer.registerReceptors("Magnetoception", magnetoceptionReceptors);
-    receptorServer.registerReceptors("Olfactory_Left", olfactoryReceptors[0]);
-    receptorServer.registerReceptors("Olfactory_Right", olfactoryReceptors[1]);
-//    receptorServer.registerReceptors("Pressure", pressureReceptors);
-//    receptorServer.registerReceptors("Proprioceptive", proprioceptiveReceptors);
-//    receptorServer.registerReceptors("Pruriceptive", pruriceptiveReceptors);
-//    receptorServer.registerReceptors("Satiety", satietyReceptors);
-//    receptorServer.registerReceptors("Somatosensory", somatosensoryReceptors);
-//    receptorServer.registerReceptors("Stretch", stretchReceptors);
-//    receptorServer.registerReceptors("Thermoception", thermoceptionReceptors);
-    receptorServer.registerReceptors("Visual_Left", visualReceptors[0]);
-    receptorServer.registerReceptors("Visual_Right", visualReceptors[1]);
-
-    if (!receptorServer.startServer()) {
-        std::cerr << "[WARNING] Failed to start SensoryReceptor server. Continuing without sensory server." << std::endl;
+    for (const auto& bank : sensoryModalities.getBanks()) {
+        receptorServer.registerBank(bank);
     }
 
-    // Start threads for input and database updates (if applicable)
-    //std::thread nvThread(runInteractor, std::ref(neurons), std::ref(neuron_mutex), std::ref(emptyAuditoryQueue), 0);
-    //std::thread avThread(runInteractor, std::ref(emptyNeurons), std::ref(empty_neuron_mutex), std::ref(audioQueue), 1);
-    std::thread inputThread(checkForQuit);
-    std::thread clusterUpdateThread(updateClusters, std::ref(clusters), std::ref(running));
-    std::thread dbThread;
-    if (useDatabase && conn_ptr_updates) {
-        // Launch the database-update thread only if database is available
-        dbThread = std::thread(updateDatabase, std::ref(*conn_ptr_updates), std::ref(clusters));
+    if (!noIo && !receptorServer.startServer()) {
+        std::cerr << "[WARNING] Failed to start SensoryReceptor server. Continuing without sensory server." << std::endl;
+    }
+    if (streamEffectors && !effectorServer.startServer()) {
+        std::cerr << "[WARNING] Failed to start effector server. Continuing without effector output." << std::endl;
+        streamEffectors = false;
     }
 
-    // Main loop
-    while (running) {
-        /* compute delta time */
-        double deltaTime = 0.1; // Placeholder for actual delta time calculation
-
-#pragma omp parallel
-        {
-            // Auditory Receptors
-#pragma omp for collapse(2) nowait
-            for (size_t h = 0; h < auditoryReceptors.size(); ++h) {
-                for (size_t i = 0; i < auditoryReceptors[h].size(); ++i) {
-                    auditoryReceptors[h][i]->update(deltaTime);
-                }
-            }
-
-            // BladderBowel Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < bladderBowelReceptors.size(); ++i) {
-//                bladderBowelReceptors[i]->update(deltaTime);
-//            }
-
-            // Chemoreception Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < chemoreceptionReceptors.size(); ++i) {
-//                chemoreceptionReceptors[i]->update(deltaTime);
-//            }
-
-            // Electroception Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < electroceptionReceptors.size(); ++i) {
-//                electroceptionReceptors[i]->update(deltaTime);
-//            }
-
-            // Gustatory Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < gustatoryReceptors.size(); ++i) {
-//                gustatoryReceptors[i]->update(deltaTime);
-//            }
-
-            // HeartbeatRespiration Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < heartbeatRespirationReceptors.size(); ++i) {
-//                heartbeatRespirationReceptors[i]->update(deltaTime);
-//            }
-
-            // HungerThirst Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < hungerThirstReceptors.size(); ++i) {
-//                hungerThirstReceptors[i]->update(deltaTime);
-//            }
-
-            // Interoceptive Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < interoceptiveReceptors.size(); ++i) {
-//                interoceptiveReceptors[i]->update(deltaTime);
-//            }
-
-            // Lust Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < lustReceptors.size(); ++i) {
-//                lustReceptors[i]->update(deltaTime);
-//            }
-
-            // Magnetoception Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < magnetoceptionReceptors.size(); ++i) {
-//                magnetoceptionReceptors[i]->update(deltaTime);
-//            }
-
-            // Olfactory Receptors
-#pragma omp for collapse(2) nowait
-            for (size_t h = 0; h < olfactoryReceptors.size(); ++h) {
-                for (size_t i = 0; i < olfactoryReceptors[h].size(); ++i) {
-                    olfactoryReceptors[h][i]->update(deltaTime);
-                }
-            }
-
-            // Pressure Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < pressureReceptors.size(); ++i) {
-//                pressureReceptors[i]->update(deltaTime);
-//            }
-
-            // Propprioceptive Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < proprioceptiveReceptors.size(); ++i) {
-//                proprioceptiveReceptors[i]->update(deltaTime);
-//            }
-
-            // Pruriceptive Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < pruriceptiveReceptors.size(); ++i) {
-//                pruriceptiveReceptors[i]->update(deltaTime);
-//            }
-
-            // Satiety Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < satietyReceptors.size(); ++i) {
-//                satietyReceptors[i]->update(deltaTime);
-//            }
-
-            // Somatosensory Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < somatosensoryReceptors.size(); ++i) {
-//                somatosensoryReceptors[i]->update(deltaTime);
-//            }
-
-            // Stretch Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < stretchReceptors.size(); ++i) {
-//                stretchReceptors[i]->update(deltaTime);
-//            }
-
-            // Thermoception Receptors
-//#pragma omp for nowait
-//            for (size_t i = 0; i < thermoceptionReceptors.size(); ++i) {
-//                thermoceptionReceptors[i]->update(deltaTime);
-//            }
-
-            // Visual Receptors
-#pragma omp for collapse(2) nowait
-            for (size_t h = 0; h < visualReceptors.size(); ++h) {
-                for (size_t i = 0; i < visualReceptors[h].size(); ++i) {
-                    visualReceptors[h][i]->update(deltaTime);
-                }
-            }
-
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const double receptorDeltaTime = 1.0 / rates.sensoryHz;
+    const double clusterDeltaTime = 1.0 / rates.neuralHz;
+
+    if (noIo) {
+        // Headless batch run: receptor and cluster updates back to back, no sleeps, no I/O threads
+        std::cout << "Running " << maxSteps << " unpaced steps (--no-io)." << std::endl;
+        long long step = 0;
+        auto batchStart = std::chrono::steady_clock::now();
+        for (; step < maxSteps; ++step) {
+            updateReceptors(sensoryModalities, receptorDeltaTime);
+            stepClusters(clusters, clusterDeltaTime);
+        }
+        std::chrono::duration<double> batchElapsed = std::chrono::steady_clock::now() - batchStart;
+        double elapsedSeconds = batchElapsed.count();
+        std::cout << "Completed " << step << " steps in " << elapsedSeconds << " s ("
+                  << (elapsedSeconds > 0.0 ? static_cast<double>(step) / elapsedSeconds : 0.0)
+                  << " steps/s)." << std::endl;
+        std::cout << "State digest: " << std::hex << stateDigest(clusters, sensoryModalities)
+                  << std::dec << std::endl;
+    } else {
+        // Start threads for input and database updates (if applicable)
+        //std::thread nvThread(runInteractor, std::ref(neurons), std::ref(neuron_mutex), std::ref(emptyAuditoryQueue), 0);
+        //std::thread avThread(runInteractor, std::ref(emptyNeurons), std::ref(empty_neuron_mutex), std::ref(audioQueue), 1);
+        std::thread inputThread(checkForQuit);
+        TripleBuffer<NetworkSnapshot> snapshotBuffer;
+        bool persist = useDatabase && conn_ptr_updates;
+        std::thread clusterUpdateThread(updateClusters, std::ref(clusters), std::ref(running), std::cref(rates),
+                                        persist ? &snapshotBuffer : nullptr, streamEffectors ? &effectorServer : nullptr);
+        std::thread dbThread;
+        std::atomic<bool> persisting(true);
+        if (persist) {
+            // Launch the persistence stage only if database is available
+            dbThread = std::thread(persistSnapshots, std::ref(*conn_ptr_updates), std::ref(snapshotBuffer),
+                                   std::cref(rates), std::ref(persisting));
         }
 
+        // Main loop; --steps bounds the number of receptor ticks, otherwise run until 'q'
+        TickScheduler receptorScheduler("sensory", periodFromRate(rates.sensoryHz));
+        receptorScheduler.addPhase({"stimulus_release", [&](double) {
+            receptorServer.releaseAlignedFrames();
+        }});
+        receptorScheduler.addPhase({"receptor_update", [&](double tickDeltaTime) {
+            updateReceptors(sensoryModalities, tickDeltaTime);
+        }});
+        receptorScheduler.addPhase({"credit_grant", [&](double) {
+            receptorServer.grantCredits();
+        }});
+        receptorScheduler.run(running, static_cast<std::uint64_t>(maxSteps));
+        running = false;
+
         // Clean up
         //nvThread.join();
         //avThread.join();
@@ -727,18 +748,18 @@ int main() {
         if (clusterUpdateThread.joinable()) {
             clusterUpdateThread.join();
         }
+        persisting = false;  // Only now, so the final snapshot is written
         if (dbThread.joinable()) {
-            // Signal updateDatabase thread to exit if needed
-            {
-                std::lock_guard<std::mutex> lock(changedNeuronsMutex);
-                dbUpdateReady = true;
-                conn_ptr.reset(); // Reset connection pointer to close the connection
-                conn_ptr_updates.reset(); // Reset updates connection pointer
-            }
-            cv.notify_all();
             dbThread.join();
         }
+        conn_ptr.reset(); // Close the connections once nothing uses them
+        conn_ptr_updates.reset();
+    }
 
-        return 0;
+    if (t1.joinable()) {
+        t1.join();
     }
+
+    std::cout << "Runtime statistics: " << boost::json::serialize(StatsRegistry::instance().snapshot()) << std::endl;
+    return 0;
 }
\ No newline at end of file
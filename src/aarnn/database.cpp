@@ -26,8 +26,8 @@
 // Global atomic flags and mutexes, externed from main.cpp
 extern std::atomic<bool> running;
 extern std::atomic<bool> dbUpdateReady;
-extern std::mutex changedNeuronsMutex;
-extern std::condition_variable cv;
+extern InstrumentedMutex changedNeuronsMutex;
+extern std::condition_variable_any cv;
 
 // --- DDL and Schema Initialization ---
 
@@ -202,18 +202,149 @@ std::string make_execute(pqxx::transaction_base& txn, const char* name, Args con
     return os.str();
 }
 
+// --- Snapshot capture (runs on the simulation thread) ---
+
+namespace {
+    template<typename Component>
+    ComponentState makeState(const Component& component, int id, double propagationRate = 0.0) {
+        const auto& position = component->getPosition();
+        return ComponentState{id, position.x, position.y, position.z,
+                              component->getEnergyLevel(), component->getMaxEnergyLevel(), propagationRate};
+    }
+}
+
+void NetworkSnapshot::clear() {
+    for (auto* table : {&clusters, &neurons, &somas, &axonHillocks, &axons, &axonBoutons, &synapticGaps,
+                        &axonBranches, &dendriteBranches, &dendrites, &dendriteBoutons}) {
+        table->clear();
+    }
+}
+
+std::size_t NetworkSnapshot::size() const {
+    return clusters.size() + neurons.size() + somas.size() + axonHillocks.size() + axons.size()
+           + axonBoutons.size() + synapticGaps.size() + axonBranches.size() + dendriteBranches.size()
+           + dendrites.size() + dendriteBoutons.size();
+}
+
+/**
+ * @brief Copies the state written by the periodic database update into a snapshot.
+ *
+ * Walks the same components, to the same depth, as the original `updateDatabase`
+ * traversal: direct axon branches only, and dendrite branches one level below each
+ * dendrite. The snapshot's vectors are cleared but keep their capacity, so a reused
+ * snapshot does not allocate once it has grown to the network size.
+ *
+ * @param clusters A constant reference to the vector of top-level Cluster objects.
+ * @param snapshot The snapshot to overwrite.
+ */
+void captureNetworkSnapshot(const std::vector<std::shared_ptr<Cluster>>& clusters, NetworkSnapshot& snapshot) {
+    snapshot.clear();
+    for (auto const& c : clusters) {
+        if (!c) continue; // Skip null clusters
+        c->materialiseEnergy(); // Deferred neurons only hold their energies as of deferral
+        snapshot.clusters.push_back(makeState(c, c->getClusterId(), c->getPropagationRate()));
+
+        for (auto const& n : c->getNeurons()) {
+            if (!n) continue; // Skip null neurons
+            snapshot.neurons.push_back(makeState(n, n->getNeuronId(), n->getPropagationRate()));
+
+            auto s = n->getSoma();
+            if (!s) continue;
+            snapshot.somas.push_back(makeState(s, s->getSomaId()));
+
+            auto ah = s->getAxonHillock();
+            if (ah) {
+                snapshot.axonHillocks.push_back(makeState(ah, ah->getAxonHillockId()));
+                auto ax = ah->getAxon();
+                if (ax) {
+                    snapshot.axons.push_back(makeState(ax, ax->getAxonId()));
+                    auto btn = ax->getAxonBouton();
+                    if (btn) {
+                        snapshot.axonBoutons.push_back(makeState(btn, btn->getAxonBoutonId()));
+                        auto gap = btn->getSynapticGap();
+                        if (gap) {
+                            snapshot.synapticGaps.push_back(makeState(gap, gap->getSynapticGapId()));
+                        }
+                    }
+                    // Only the direct branches of the axon are updated
+                    for (auto const& br : ax->getAxonBranches()) {
+                        snapshot.axonBranches.push_back(makeState(br, br->getAxonBranchId()));
+                    }
+                }
+            }
+
+            for (auto const& br : s->getDendriteBranches()) {
+                snapshot.dendriteBranches.push_back(makeState(br, br->getDendriteBranchId()));
+                for (auto const& d : br->getDendrites()) {
+                    snapshot.dendrites.push_back(makeState(d, d->getDendriteId()));
+                    auto btn = d->getDendriteBouton();
+                    if (btn) {
+                        snapshot.dendriteBoutons.push_back(makeState(btn, btn->getDendriteBoutonId()));
+                    }
+                    // One level of sub-branches below each dendrite
+                    for (auto const& sub_br : d->getDendriteBranches()) {
+                        snapshot.dendriteBranches.push_back(makeState(sub_br, sub_br->getDendriteBranchId()));
+                    }
+                }
+            }
+        }
+    }
+}
+
 // --- Pipelined updates (Optimized using prepared statements and pipeline) ---
 
+/**
+ * @brief Writes a captured snapshot to the database in one pipelined transaction.
+ *
+ * Uses a `pqxx::pipeline` to send every `UPDATE` statement within a single
+ * transaction, which significantly reduces network round trips compared to
+ * individual `exec_params` calls. Only touches the snapshot, never the live
+ * network, so it can run on a thread of its own at its own rate.
+ *
+ * @param conn The active pqxx::connection to the PostgreSQL database.
+ * @param snapshot The snapshot to persist.
+ * @throws std::exception (from pqxx) if the transaction fails.
+ */
+void flushNetworkSnapshot(pqxx::connection& conn, const NetworkSnapshot& snapshot) {
+    pqxx::work txn{conn};
+    pqxx::pipeline pipe{txn};
+
+    auto insertRates = [&](const char* statement, const std::vector<ComponentState>& rows) {
+        for (auto const& row : rows) {
+            pipe.insert(make_execute(txn, statement, row.x, row.y, row.z, row.propagationRate,
+                                     row.energyLevel, row.maxEnergyLevel, row.id));
+        }
+    };
+    auto insertComponents = [&](const char* statement, const std::vector<ComponentState>& rows) {
+        for (auto const& row : rows) {
+            pipe.insert(make_execute(txn, statement, row.x, row.y, row.z,
+                                     row.energyLevel, row.maxEnergyLevel, row.id));
+        }
+    };
+
+    insertRates("update_cluster", snapshot.clusters);
+    insertRates("update_neuron", snapshot.neurons);
+    insertComponents("update_soma", snapshot.somas);
+    insertComponents("update_axonhillock", snapshot.axonHillocks);
+    insertComponents("update_axon", snapshot.axons);
+    insertComponents("update_axonbouton", snapshot.axonBoutons);
+    insertComponents("update_synapticgap", snapshot.synapticGaps);
+    insertComponents("update_axonbranch", snapshot.axonBranches);
+    insertComponents("update_dendritebranch", snapshot.dendriteBranches);
+    insertComponents("update_dendrite", snapshot.dendrites);
+    insertComponents("update_dendritebtn", snapshot.dendriteBoutons);
+
+    pipe.complete(); // Send all batched queries to the database
+    txn.commit();    // Commit the transaction to make changes permanent
+}
+
 /**
  * @brief Continuously updates neuron-related data in the database using a pipeline.
  *
  * This function runs in a separate thread (implied by `running` and `cv`).
  * It waits for a signal (`dbUpdateReady`) indicating that data is ready for update.
- * Once signaled, it acquires a lock, resets the flag, and then uses a `pqxx::pipeline`
- * to efficiently send multiple `UPDATE` statements to the database within a single
- * transaction. This significantly reduces network round trips compared to individual
- * `exec_params` calls. The pipeline uses the prepared statements defined in
- * `prepareAllStatements`.
+ * Once signaled, it resets the flag, captures a snapshot of the network and writes
+ * it with `flushNetworkSnapshot`.
  *
  * @param conn The active pqxx::connection to the PostgreSQL database.
  * @param clusters A constant reference to the vector of top-level Cluster objects.
@@ -222,9 +353,10 @@ void updateDatabase(pqxx::connection& conn,
                     const std::vector<std::shared_ptr<Cluster>>& clusters) {
     // `prepareAllStatements` must be called once at application startup.
     // Do not call it inside this loop, as it would be inefficient.
+    NetworkSnapshot snapshot;
 
     while (running) {
-        std::unique_lock<std::mutex> lk(changedNeuronsMutex);
+        std::unique_lock<InstrumentedMutex> lk(changedNeuronsMutex);
         // Wait for a signal that updates are ready, or if the application is shutting down.
         cv.wait(lk, []{ return dbUpdateReady.load() || !running.load(); });
 
@@ -238,174 +370,8 @@ void updateDatabase(pqxx::connection& conn,
         lk.unlock(); // Release lock before performing database operations to avoid blocking other threads.
 
         try {
-            pqxx::work txn{conn};
-            pqxx::pipeline pipe{txn};
-
-            // Recursively add all entities' update statements to the pipeline
-            for (auto const& c : clusters) {
-                if (!c) continue; // Skip null clusters
-
-                // Cluster Update
-                pipe.insert(make_execute(txn, "update_cluster",
-                                         c->getPosition()->x,
-                                         c->getPosition()->y,
-                                         c->getPosition()->z,
-                                         c->getPropagationRate(),
-                                         c->getEnergyLevel(),
-                                         c->getMaxEnergyLevel(),
-                                         c->getClusterId()));
-
-                // Iterate through Neurons and their components
-                for (auto const& n : c->getNeurons()) {
-                    if (!n) continue; // Skip null neurons
-
-                    // Neuron Update
-                    pipe.insert(make_execute(txn, "update_neuron",
-                                             n->getPosition()->x,
-                                             n->getPosition()->y,
-                                             n->getPosition()->z,
-                                             n->getPropagationRate(),
-                                             n->getEnergyLevel(),
-                                             n->getMaxEnergyLevel(),
-                                             n->getNeuronId()));
-                    auto s = n->getSoma();
-                    if (s) {
-                        // Soma Update
-                        pipe.insert(make_execute(txn, "update_soma",
-                                                 s->getPosition()->x,
-                                                 s->getPosition()->y,
-                                                 s->getPosition()->z,
-                                                 s->getEnergyLevel(),
-                                                 s->getMaxEnergyLevel(),
-                                                 s->getSomaId()));
-                        auto ah = s->getAxonHillock();
-                        if (ah) {
-                            // AxonHillock Update
-                            pipe.insert(make_execute(txn, "update_axonhillock",
-                                                     ah->getPosition()->x,
-                                                     ah->getPosition()->y,
-                                                     ah->getPosition()->z,
-                                                     ah->getEnergyLevel(),
-                                                     ah->getMaxEnergyLevel(),
-                                                     ah->getAxonHillockId()));
-                            auto ax = ah->getAxon();
-                            if (ax) {
-                                // Axon Update
-                                pipe.insert(make_execute(txn, "update_axon",
-                                                         ax->getPosition()->x,
-                                                         ax->getPosition()->y,
-                                                         ax->getPosition()->z,
-                                                         ax->getEnergyLevel(),
-                                                         ax->getMaxEnergyLevel(),
-                                                         ax->getAxonId()));
-                                auto btn = ax->getAxonBouton();
-                                if (btn) {
-                                    // AxonBouton Update
-                                    pipe.insert(make_execute(txn, "update_axonbouton",
-                                                             btn->getPosition()->x,
-                                                             btn->getPosition()->y,
-                                                             btn->getPosition()->z,
-                                                             btn->getEnergyLevel(),
-                                                             btn->getMaxEnergyLevel(),
-                                                             btn->getAxonBoutonId()));
-                                    auto gap = btn->getSynapticGap();
-                                    if (gap) {
-                                        // SynapticGap Update
-                                        pipe.insert(make_execute(txn, "update_synapticgap",
-                                                                 gap->getPosition()->x,
-                                                                 gap->getPosition()->y,
-                                                                 gap->getPosition()->z,
-                                                                 gap->getEnergyLevel(),
-                                                                 gap->getMaxEnergyLevel(),
-                                                                 gap->getSynapticGapId()));
-                                    }
-                                }
-                                // Iterate and update AxonBranches recursively
-                                // Note: For updates, the recursive functions are not called here
-                                // as they are designed for initial *insertion*.
-                                // Instead, we directly pipeline updates for all collected branches.
-                                // This requires a flattened list of all branches to update.
-                                // For simplicity and to match the original structure, I'll iterate through branches.
-                                for (auto const& br : ax->getAxonBranches()) {
-                                    // AxonBranch Update
-                                    pipe.insert(make_execute(txn, "update_axonbranch",
-                                                             br->getPosition()->x,
-                                                             br->getPosition()->y,
-                                                             br->getPosition()->z,
-                                                             br->getEnergyLevel(),
-                                                             br->getMaxEnergyLevel(),
-                                                             br->getAxonBranchId()));
-                                    // Recursively add updates for sub-branches within the axon branches.
-                                    // This part of the update loop structure is implied by the original
-                                    // insertion recursion, but requires traversing the C++ object graph
-                                    // to find all existing axon branches to update.
-                                    // The original `updateDatabase` only iterated the top-level branches
-                                    // from axon. It didn't explicitly recurse for updates on sub-branches.
-                                    // To maintain consistency, I'll update only the direct branches.
-                                    // A full recursive update would involve more complex traversal here.
-                                    // If sub-branches can change position/energy, they also need to be updated.
-                                    // Assuming getAxons() on AxonBranch provides further elements for traversal:
-                                    // (This is a simplified approach, a more robust solution might pre-collect all updatable objects)
-                                    for (auto const& sub_ax : br->getAxons()) {
-                                        // If these 'sub_ax' are also stored in DB, they'd need updates.
-                                        // For now, only the branch itself is updated.
-                                        // If `sub_ax->getAxonBranches()` means more levels, those need to be updated.
-                                        // To truly match original update depth, a recursive update helper is needed.
-                                        // For now, sticking to the single level of branch update in original `updateDatabase`.
-                                    }
-                                }
-                            }
-                        }
-                        // Iterate and update DendriteBranches recursively
-                        for (auto const& br : s->getDendriteBranches()) {
-                            // DendriteBranch Update
-                            pipe.insert(make_execute(txn, "update_dendritebranch",
-                                                     br->getPosition()->x,
-                                                     br->getPosition()->y,
-                                                     br->getPosition()->z,
-                                                     br->getEnergyLevel(),
-                                                     br->getMaxEnergyLevel(),
-                                                     br->getDendriteBranchId()));
-                            // Iterate and update Dendrites within the branch
-                            for (auto const& d : br->getDendrites()) {
-                                // Dendrite Update
-                                pipe.insert(make_execute(txn, "update_dendrite",
-                                                         d->getPosition()->x,
-                                                         d->getPosition()->y,
-                                                         d->getPosition()->z,
-                                                         d->getEnergyLevel(),
-                                                         d->getMaxEnergyLevel(),
-                                                         d->getDendriteId()));
-                                auto btn = d->getDendriteBouton();
-                                if (btn) {
-                                    // DendriteBouton Update
-                                    pipe.insert(make_execute(txn, "update_dendritebtn",
-                                                             btn->getPosition()->x,
-                                                             btn->getPosition()->y,
-                                                             btn->getPosition()->z,
-                                                             btn->getEnergyLevel(),
-                                                             btn->getMaxEnergyLevel(),
-                                                             btn->getDendriteBoutonId()));
-                                }
-                                // Similar to AxonBranches, if sub-dendrite branches exist, they need update.
-                                // Original `updateDatabase` loop only went one level deep for DendriteBranches.
-                                // Assuming for updates, direct children are sufficient.
-                                for (auto const& sub_br : d->getDendriteBranches()) {
-                                    pipe.insert(make_execute(txn, "update_dendritebranch",
-                                                             sub_br->getPosition()->x,
-                                                             sub_br->getPosition()->y,
-                                                             sub_br->getPosition()->z,
-                                                             sub_br->getEnergyLevel(),
-                                                             sub_br->getMaxEnergyLevel(),
-                                                             sub_br->getDendriteBranchId()));
-                                }
-                            }
-                        }
-                    }
-                }
-            }
-            pipe.complete(); // Send all batched queries to the database
-            txn.commit();    // Commit the transaction to make changes permanent
+            captureNetworkSnapshot(clusters, snapshot);
+            flushNetworkSnapshot(conn, snapshot);
             std::cout << "[DB UPDATE] Pipeline executed and transaction committed.\n";
         } catch (const std::exception& e) {
             std::cerr << "[DB UPDATE ERROR] " << e.what() << "\n";
@@ -440,7 +406,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
         // Insert Cluster
         // Using prepared statement "insert_cluster" defined in prepareAllStatements
         auto cr = txn.exec_prepared("insert_cluster",
-                                    c->getPosition()->x, c->getPosition()->y, c->getPosition()->z,
+                                    c->getPosition().x, c->getPosition().y, c->getPosition().z,
                                     c->getPropagationRate(), c->getClusterType(), // Assuming getClusterType returns int
                                     c->getEnergyLevel(), c->getMaxEnergyLevel());
         int cid = cr[0][0].as<int>(); // Retrieve the generated cluster_id
@@ -456,7 +422,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
             // Insert Neuron
             // Using prepared statement "insert_neuron"
             auto nr = txn.exec_prepared("insert_neuron",
-                                        cid, n->getPosition()->x, n->getPosition()->y, n->getPosition()->z,
+                                        cid, n->getPosition().x, n->getPosition().y, n->getPosition().z,
                                         n->getPropagationRate(), n->getNeuronType(), // Assuming NeuronType is integer
                                         n->getEnergyLevel(), n->getMaxEnergyLevel());
             int nid = nr[0][0].as<int>(); // Retrieve generated neuron_id
@@ -466,7 +432,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
             // Insert Soma
             // Using prepared statement "insert_soma"
             auto sr = txn.exec_prepared("insert_soma",
-                                        nid, s->getPosition()->x, s->getPosition()->y, s->getPosition()->z,
+                                        nid, s->getPosition().x, s->getPosition().y, s->getPosition().z,
                                         s->getEnergyLevel(), s->getMaxEnergyLevel());
             int sid = sr[0][0].as<int>(); // Retrieve generated soma_id
             s->setSomaId(sid); // Set the ID back into the C++ object
@@ -477,7 +443,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
                 // Insert AxonHillock
                 // Using prepared statement "insert_axonhillock"
                 auto ahr = txn.exec_prepared("insert_axonhillock",
-                                             sid, ah->getPosition()->x, ah->getPosition()->y, ah->getPosition()->z,
+                                             sid, ah->getPosition().x, ah->getPosition().y, ah->getPosition().z,
                                              ah->getEnergyLevel(), ah->getMaxEnergyLevel());
                 int ahid = ahr[0][0].as<int>(); // Retrieve generated axon_hillock_id
                 ah->setAxonHillockId(ahid); // Set the ID back into the C++ object
@@ -489,7 +455,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
                     auto axr = txn.exec_prepared("insert_axon",
                                                  ahid,
                                                  std::optional<int>{}, // Corrected: use an empty std::optional for NULL int
-                                                 ax->getPosition()->x, ax->getPosition()->y, ax->getPosition()->z,
+                                                 ax->getPosition().x, ax->getPosition().y, ax->getPosition().z,
                                                  ax->getEnergyLevel(), ax->getMaxEnergyLevel());
                     int axid = axr[0][0].as<int>(); // Retrieve generated axon_id
                     ax->setAxonId(axid); // Set the ID back into the C++ object
@@ -500,7 +466,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
                         // Using prepared statement "insert_axonbouton"
                         auto btr = txn.exec_prepared("insert_axonbouton",
                                                      axid,
-                                                     btn->getPosition()->x, btn->getPosition()->y, btn->getPosition()->z,
+                                                     btn->getPosition().x, btn->getPosition().y, btn->getPosition().z,
                                                      btn->getEnergyLevel(), btn->getMaxEnergyLevel());
                         btn->setAxonBoutonId(btr[0][0].as<int>()); // Set generated axon_bouton_id
 
@@ -510,7 +476,7 @@ void batch_insert_clusters(pqxx::transaction_base& txn,
                             // Using prepared statement "insert_synapticgap"
                             auto sgr = txn.exec_prepared("insert_synapticgap",
                                                          btn->getAxonBoutonId(), // Foreign key to axon_bouton_id
-                                                         gap->getPosition()->x, gap->getPosition()->y, gap->getPosition()->z,
+                                                         gap->getPosition().x, gap->getPosition().y, gap->getPosition().z,
                                                          gap->getEnergyLevel(), gap->getMaxEnergyLevel());
                             gap->setSynapticGapId(sgr[0][0].as<int>()); // Set generated synaptic_gap_id
                         }
@@ -564,18 +530,18 @@ void insertAxonBranches(
         // Parent is an Axon: use parent_axon_id, parent_axon_branch_id is NULL
         r = txn.exec_prepared("insert_axonbranch_from_axon",
                               parentId, // parent_axon_id
-                              branch->getPosition()->x,
-                              branch->getPosition()->y,
-                              branch->getPosition()->z,
+                              branch->getPosition().x,
+                              branch->getPosition().y,
+                              branch->getPosition().z,
                               branch->getEnergyLevel(),
                               branch->getMaxEnergyLevel());
     } else {
         // Parent is another AxonBranch: use parent_axon_branch_id, parent_axon_id is NULL
         r = txn.exec_prepared("insert_axonbranch_from_branch",
                               parentId, // parent_axon_branch_id
-                              branch->getPosition()->x,
-                              branch->getPosition()->y,
-                              branch->getPosition()->z,
+                              branch->getPosition().x,
+                              branch->getPosition().y,
+                              branch->getPosition().z,
                               branch->getEnergyLevel(),
                               branch->getMaxEnergyLevel());
     }
@@ -665,18 +631,18 @@ void insertDendriteBranches(
         // Parent is a Soma: use soma_id, parent_dendrite_id is NULL
         r_branch = txn.exec_prepared("insert_dendritebranch_from_soma",
                                      parentId, // soma_id
-                                     branch->getPosition()->x,
-                                     branch->getPosition()->y,
-                                     branch->getPosition()->z,
+                                     branch->getPosition().x,
+                                     branch->getPosition().y,
+                                     branch->getPosition().z,
                                      branch->getEnergyLevel(),
                                      branch->getMaxEnergyLevel());
     } else {
         // Parent is a Dendrite: use parent_dendrite_id, soma_id is NULL
         r_branch = txn.exec_prepared("insert_dendritebranch_from_dendrite",
                                      parentId, // parent_dendrite_id
-                                     branch->getPosition()->x,
-                                     branch->getPosition()->y,
-                                     branch->getPosition()->z,
+                                     branch->getPosition().x,
+                                     branch->getPosition().y,
+                                     branch->getPosition().z,
                                      branch->getEnergyLevel(),
                                      branch->getMaxEnergyLevel());
     }
@@ -693,9 +659,9 @@ void insertDendriteBranches(
         pqxx::result r_dendrite = txn.exec_prepared(
                 "insert_dendrite",
                 bid, // dendrite_branch_id (foreign key to this branch's ID)
-                d->getPosition()->x,
-                d->getPosition()->y,
-                d->getPosition()->z,
+                d->getPosition().x,
+                d->getPosition().y,
+                d->getPosition().z,
                 d->getEnergyLevel(),
                 d->getMaxEnergyLevel());
         did = r_dendrite[0][0].as<int>(); // Retrieve generated dendrite_id
@@ -709,9 +675,9 @@ void insertDendriteBranches(
             pqxx::result r_bouton = txn.exec_prepared(
                     "insert_dendritebouton",
                     did, // dendrite_id (foreign key to this dendrite's ID)
-                    btn->getPosition()->x,
-                    btn->getPosition()->y,
-                    btn->getPosition()->z,
+                    btn->getPosition().x,
+                    btn->getPosition().y,
+                    btn->getPosition().z,
                     btn->getEnergyLevel(),
                     btn->getMaxEnergyLevel());
             btn->setDendriteBoutonId(r_bouton[0][0].as<int>()); // Set generated dendrite_bouton_id
@@ -4,10 +4,14 @@
 #include <cmath>
 #include <iostream>
 #include <algorithm>
+#include <deque>
+#include <utility>
 
 AuditoryProcessor::AuditoryProcessor(const std::string& host, unsigned short port, const std::string& sourceId)
         : sourceId(sourceId) {
     networkClient = std::make_unique<AsyncNetworkClient>(host, port);
+    // Magnitudes are normalised to [0, 1], well within half precision
+    stimulusChannel = std::make_unique<StimulusChannel>(*networkClient, "Auditory:" + sourceId, StimulusFormat::Float16);
 }
 
 AuditoryProcessor::~AuditoryProcessor() {
@@ -15,7 +19,9 @@ AuditoryProcessor::~AuditoryProcessor() {
 }
 
 bool AuditoryProcessor::initialise() {
+    stimulusChannel->open();
     healthy = networkClient->connect();
+    metrics.connected(healthy);
     if (!healthy) {
         std::cerr << "AuditoryProcessor: Failed to connect to SensoryReceptor server." << std::endl;
     }
@@ -38,35 +44,58 @@ void AuditoryProcessor::stopProcessing() {
 }
 
 bool AuditoryProcessor::isHealthy() const {
-    return healthy.load();
+    return healthy.load() && !networkClient->hasFailed();
+}
+
+bool AuditoryProcessor::isConnected() const {
+    return networkClient->isConnected();
+}
+
+boost::json::object AuditoryProcessor::getMetrics() const {
+    return metrics.toJson(*stimulusChannel, *networkClient);
 }
 
 void AuditoryProcessor::receiveAudioData(const std::vector<double>& audioData) {
-    audioDataQueue.push(audioData);
+    metrics.captured();
+    metrics.enqueued();
+    audioDataQueue.push(AudioChunk{audioData, stimulusClockMicros()});
 }
 
 void AuditoryProcessor::processAudioDataLoop() {
     std::vector<double> audioBuffer;
     audioBuffer.reserve(FFT_SIZE);
+    // Where each buffered chunk starts, counted in samples since the loop began, so each
+    // FFT window is stamped with the capture time of the chunk holding its first sample
+    std::deque<std::pair<std::uint64_t, std::uint64_t>> chunkStarts;
+    std::uint64_t samplesAppended = 0;
+    std::uint64_t samplesConsumed = 0;
 
     while (processing.load()) {
-        std::vector<double> audioData;
-        if (!audioDataQueue.pop(audioData)) {
+        AudioChunk chunk;
+        if (!audioDataQueue.pop(chunk)) {
             std::this_thread::sleep_for(std::chrono::milliseconds(1));
             continue;
         }
+        metrics.dequeued();
 
-        audioBuffer.insert(audioBuffer.end(), audioData.begin(), audioData.end());
+        chunkStarts.emplace_back(samplesAppended, chunk.captureMicros);
+        samplesAppended += chunk.samples.size();
+        audioBuffer.insert(audioBuffer.end(), chunk.samples.begin(), chunk.samples.end());
 
         while (audioBuffer.size() >= FFT_SIZE) {
+            while (chunkStarts.size() > 1 && chunkStarts[1].first <= samplesConsumed) {
+                chunkStarts.pop_front();
+            }
             std::vector<double> fftInput(audioBuffer.begin(), audioBuffer.begin() + FFT_SIZE);
-            performFFTAndSend(fftInput);
+            performFFTAndSend(fftInput, chunkStarts.front().second);
             audioBuffer.erase(audioBuffer.begin(), audioBuffer.begin() + FFT_SIZE);
+            samplesConsumed += FFT_SIZE;
         }
     }
 }
 
-void AuditoryProcessor::performFFTAndSend(const std::vector<double>& audioBuffer) {
+void AuditoryProcessor::performFFTAndSend(const std::vector<double>& audioBuffer, std::uint64_t captureMicros) {
+    const auto started = std::chrono::steady_clock::now();
     fftw_complex* out = (fftw_complex*) fftw_malloc(sizeof(fftw_complex) * (FFT_SIZE / 2 + 1));
     fftw_plan p = fftw_plan_dft_r2c_1d(FFT_SIZE, const_cast<double*>(audioBuffer.data()), out, FFTW_ESTIMATE);
     fftw_execute(p);
@@ -83,17 +112,16 @@ void AuditoryProcessor::performFFTAndSend(const std::vector<double>& audioBuffer
         }
     }
 
-    StimuliData data;
-    data.receptorType = "Auditory:" + sourceId;
-    data.values = magnitudes;
-
-    std::string serializedData = serializeStimuliData(data);
-    try {
-        networkClient->send(serializedData);
-        healthy = true;
-    } catch (...) {
-        std::cerr << "AuditoryProcessor: send failed. Marking as unhealthy." << std::endl;
-        healthy = false;
+    metrics.processed(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started).count()));
+
+    // Health follows the transport (isHealthy()); a refused frame is an error only if
+    // the connection has failed, otherwise it was throttled
+    const bool accepted = stimulusChannel->send(magnitudes, captureMicros);
+    if (accepted || !networkClient->hasFailed()) {
+        metrics.sent(accepted, captureMicros);
+    } else {
+        metrics.sendFailed();
     }
 
     fftw_destroy_plan(p);
@@ -3,15 +3,31 @@
 #include <iostream>
 #include <netinet/in.h>
 #include <cstring>
+#include <mutex>
+#include <utility>
 
-AsyncNetworkClient::AsyncNetworkClient(const std::string& host, unsigned short port)
-        : host(host), port(port) {}
+AsyncNetworkClient::AsyncNetworkClient(const std::string& host, unsigned short port, std::size_t maxQueuedBytes)
+        : host(host), port(port), maxQueuedBytes(maxQueuedBytes) {}
 
 AsyncNetworkClient::~AsyncNetworkClient() {
     disconnect();
 }
 
+// Frames queued since the last disconnect() are held for the new connection; a batch
+// cut off mid-write by the disconnect is dropped
 bool AsyncNetworkClient::connect() {
+    disconnect();
+    {
+        std::lock_guard<InstrumentedMutex> lock(writeMutex);
+        framesDropped.fetch_add(writingFrames.size(), std::memory_order_relaxed);
+        writingFrames.clear();
+        writingHeaders.clear();
+        inFlightBytes = 0;
+        writeInFlight = false;
+        connectionFailed = false;
+    }
+    ioContext.restart();
+
     try {
         resolver = std::make_unique<boost::asio::ip::tcp::resolver>(ioContext);
         socket = std::make_unique<boost::asio::ip::tcp::socket>(ioContext);
@@ -21,6 +37,7 @@ bool AsyncNetworkClient::connect() {
         return true;
     } catch (const std::exception& e) {
         std::cerr << "AsyncNetworkClient::connect - Exception: " << e.what() << std::endl;
+        connectionFailed = true;
         return false;
     }
 }
@@ -35,15 +52,51 @@ void AsyncNetworkClient::disconnect() {
         socket->shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
         socket->close(ec);
     }
+    std::lock_guard<InstrumentedMutex> lock(writeMutex);
+    connected = false;
 }
 
 void AsyncNetworkClient::setOnMessage(std::function<void(const std::string&)> callback) {
     onMessage = std::move(callback);
 }
 
-void AsyncNetworkClient::send(const std::string& message) {
-    std::lock_guard<std::mutex> lock(writeMutex);
-    doWrite(message);
+bool AsyncNetworkClient::send(std::string message) {
+    const std::size_t frameBytes = sizeof(uint32_t) + message.size();
+    bool start = false;
+    {
+        std::lock_guard<InstrumentedMutex> lock(writeMutex);
+        const std::size_t queuedBytes = pendingBytes + inFlightBytes + frameBytes;
+        if (connectionFailed || queuedBytes > maxQueuedBytes) {
+            framesDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        pendingHeaders.push_back(htonl(static_cast<uint32_t>(message.size())));
+        pendingFrames.push_back(std::move(message));
+        pendingBytes += frameBytes;
+        if (queuedBytes > queuedBytesHighWater.load(std::memory_order_relaxed)) {
+            queuedBytesHighWater.store(queuedBytes, std::memory_order_relaxed);
+        }
+        if (connected && !writeInFlight) {
+            writeInFlight = true;
+            start = true;
+        }
+    }
+    framesQueued.fetch_add(1, std::memory_order_relaxed);
+    if (start) {
+        boost::asio::post(ioContext, [this]() { doWrite(); });
+    }
+    return true;
+}
+
+ClientWriteStatistics AsyncNetworkClient::getWriteStatistics() const {
+    ClientWriteStatistics statistics;
+    statistics.framesQueued = framesQueued.load(std::memory_order_relaxed);
+    statistics.framesSent = framesSent.load(std::memory_order_relaxed);
+    statistics.bytesSent = bytesSent.load(std::memory_order_relaxed);
+    statistics.writes = writes.load(std::memory_order_relaxed);
+    statistics.framesDropped = framesDropped.load(std::memory_order_relaxed);
+    statistics.queuedBytesHighWater = queuedBytesHighWater.load(std::memory_order_relaxed);
+    return statistics;
 }
 
 void AsyncNetworkClient::doConnect() {
@@ -51,9 +104,10 @@ void AsyncNetworkClient::doConnect() {
     boost::asio::async_connect(*socket, endpoints,
                                [this](const boost::system::error_code& ec, const boost::asio::ip::tcp::endpoint&) {
                                    if (!ec) {
+                                       startWrite();
                                        doReadHeader();
                                    } else {
-                                       std::cerr << "AsyncNetworkClient::doConnect - Failed: " << ec.message() << std::endl;
+                                       failConnection("doConnect", ec);
                                    }
                                });
 }
@@ -62,7 +116,10 @@ void AsyncNetworkClient::doReadHeader() {
     readBuffer.resize(sizeof(uint32_t));
     boost::asio::async_read(*socket, boost::asio::buffer(readBuffer),
                             [this](const boost::system::error_code& ec, std::size_t) {
-                                if (ec) return;
+                                if (ec) {
+                                    failConnection("doReadHeader", ec);
+                                    return;
+                                }
 
                                 uint32_t length;
                                 std::memcpy(&length, readBuffer.data(), sizeof(uint32_t));
@@ -79,21 +136,74 @@ void AsyncNetworkClient::doReadBody(std::size_t length) {
                                     std::string message(readBuffer.begin(), readBuffer.end());
                                     if (onMessage) onMessage(message);
                                     doReadHeader(); // Keep reading
+                                } else {
+                                    failConnection("doReadBody", ec);
                                 }
                             });
 }
 
-void AsyncNetworkClient::doWrite(const std::string& message) {
-    uint32_t len = htonl(static_cast<uint32_t>(message.size()));
-    std::vector<boost::asio::const_buffer> buffers = {
-            boost::asio::buffer(&len, sizeof(len)),
-            boost::asio::buffer(message)
-    };
+// On the io thread once connected: flushes whatever was queued before the connection
+void AsyncNetworkClient::startWrite() {
+    {
+        std::lock_guard<InstrumentedMutex> lock(writeMutex);
+        connected = true;
+        if (writeInFlight || pendingFrames.empty()) {
+            return;
+        }
+        writeInFlight = true;
+    }
+    doWrite();
+}
+
+// Takes every pending frame and writes the batch with one gather-write; its completion
+// starts the next batch or clears writeInFlight. Only one doWrite runs at a time.
+void AsyncNetworkClient::doWrite() {
+    {
+        std::lock_guard<InstrumentedMutex> lock(writeMutex);
+        inFlightBytes = 0;
+        if (pendingFrames.empty()) {
+            writeInFlight = false;
+            return;
+        }
+        writingFrames.swap(pendingFrames);
+        writingHeaders.swap(pendingHeaders);
+        inFlightBytes = pendingBytes;
+        pendingBytes = 0;
+    }
 
-    boost::asio::async_write(*socket, buffers,
-                             [](const boost::system::error_code& ec, std::size_t) {
+    writeBuffers.clear();
+    for (std::size_t i = 0; i < writingFrames.size(); ++i) {
+        writeBuffers.push_back(boost::asio::buffer(&writingHeaders[i], sizeof(uint32_t)));
+        writeBuffers.push_back(boost::asio::buffer(writingFrames[i]));
+    }
+    writes.fetch_add(1, std::memory_order_relaxed);
+    boost::asio::async_write(*socket, writeBuffers,
+                             [this](const boost::system::error_code& ec, std::size_t bytes) {
+                                 const std::size_t frames = writingFrames.size();
+                                 writingFrames.clear();
+                                 writingHeaders.clear();
                                  if (ec) {
-                                     std::cerr << "AsyncNetworkClient::doWrite - Write failed: " << ec.message() << std::endl;
+                                     framesDropped.fetch_add(frames, std::memory_order_relaxed);
+                                     failConnection("doWrite", ec);
+                                     return;
                                  }
+                                 framesSent.fetch_add(frames, std::memory_order_relaxed);
+                                 bytesSent.fetch_add(bytes, std::memory_order_relaxed);
+                                 doWrite();
                              });
 }
+
+// On the io thread: drops everything queued and refuses further sends until the next
+// connect(). The in-flight write, if any, completes with an error and ends there.
+void AsyncNetworkClient::failConnection(const char* where, const boost::system::error_code& ec) {
+    if (ec == boost::asio::error::operation_aborted || connectionFailed) {
+        return;  // disconnect() closed the socket, or already reported
+    }
+    std::cerr << "AsyncNetworkClient::" << where << " - Connection failed: " << ec.message() << std::endl;
+    std::lock_guard<InstrumentedMutex> lock(writeMutex);
+    framesDropped.fetch_add(pendingFrames.size(), std::memory_order_relaxed);
+    pendingFrames.clear();
+    pendingHeaders.clear();
+    pendingBytes = 0;
+    connectionFailed = true;
+}
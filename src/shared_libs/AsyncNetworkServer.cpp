@@ -1,10 +1,126 @@
 // AsyncNetworkServer.cpp
 #include "AsyncNetworkServer.h"
+#include <algorithm>
+#include <array>
+#include <deque>
 #include <iostream>
 #include <netinet/in.h>
 #include <cstring>
 
-AsyncNetworkServer::AsyncNetworkServer(int port) : port(port) {}
+// One connection. Everything except the public calls runs on the thread of the
+// io_context that owns the socket; those post onto it.
+class AsyncNetworkServer::Session : public std::enable_shared_from_this<Session> {
+public:
+    Session(AsyncNetworkServer& server, int clientId, boost::asio::ip::tcp::socket socket)
+            : server(server), clientId(clientId), socket(std::move(socket)) {}
+
+    void start() {
+        boost::asio::post(socket.get_executor(), [self = shared_from_this()]() { self->readHeader(); });
+    }
+
+    // Thread-safe: the frame is queued on the session's own thread. queuedBytes is
+    // reserved here, so the bound holds before the post runs.
+    bool send(const std::string& message, std::size_t maxQueuedBytes) {
+        const std::size_t frameBytes = sizeof(uint32_t) + message.size();
+        const std::size_t queued = queuedBytes.fetch_add(frameBytes, std::memory_order_relaxed) + frameBytes;
+        if (maxQueuedBytes != 0 && queued > maxQueuedBytes) {
+            queuedBytes.fetch_sub(frameBytes, std::memory_order_relaxed);
+            return false;
+        }
+        auto frame = std::make_shared<std::string>(frameBytes, '\0');
+        uint32_t len = htonl(static_cast<uint32_t>(message.size()));
+        std::memcpy(&(*frame)[0], &len, sizeof(len));
+        std::memcpy(&(*frame)[sizeof(len)], message.data(), message.size());
+
+        boost::asio::post(socket.get_executor(), [self = shared_from_this(), frame]() {
+            self->writeQueue.push_back(std::move(*frame));
+            if (self->writeQueue.size() == 1) {
+                self->writeNext();
+            }
+        });
+        return true;
+    }
+
+    void close() {
+        boost::asio::post(socket.get_executor(), [self = shared_from_this()]() {
+            boost::system::error_code ec;
+            self->socket.shutdown(boost::asio::ip::tcp::socket::shutdown_both, ec);
+            self->socket.close(ec);
+        });
+    }
+
+private:
+    void readHeader() {
+        boost::asio::async_read(socket, boost::asio::buffer(header),
+                                [self = shared_from_this()](const boost::system::error_code& ec, std::size_t) {
+                                    if (ec) {
+                                        self->server.closeClient(self->clientId);
+                                        return;
+                                    }
+
+                                    uint32_t length;
+                                    std::memcpy(&length, self->header.data(), sizeof(length));
+                                    length = ntohl(length);
+                                    if (length > MAX_MESSAGE_SIZE) {
+                                        std::cerr << "Client " << self->clientId << " sent a " << length
+                                                  << "-byte message; closing." << std::endl;
+                                        self->server.closeClient(self->clientId);
+                                        return;
+                                    }
+                                    self->readBody(length);
+                                });
+    }
+
+    void readBody(uint32_t length) {
+        // Grows to the largest message seen and is reused after that
+        if (body.size() < length) {
+            body.resize(length);
+        }
+        boost::asio::async_read(socket, boost::asio::buffer(body.data(), length),
+                                [self = shared_from_this(), length](const boost::system::error_code& ec, std::size_t) {
+                                    if (ec) {
+                                        self->server.closeClient(self->clientId);
+                                        return;
+                                    }
+
+                                    if (self->server.onMessage) {
+                                        self->server.onMessage(self->clientId, std::string_view(self->body.data(), length));
+                                    }
+                                    self->readHeader(); // Wait for next message
+                                });
+    }
+
+    void writeNext() {
+        boost::asio::async_write(socket, boost::asio::buffer(writeQueue.front()),
+                                 [self = shared_from_this()](const boost::system::error_code& ec, std::size_t) {
+                                     if (ec) {
+                                         std::cerr << "Write failed for client " << self->clientId << ": " << ec.message() << std::endl;
+                                         for (const auto& dropped : self->writeQueue) {
+                                             self->queuedBytes.fetch_sub(dropped.size(), std::memory_order_relaxed);
+                                         }
+                                         self->writeQueue.clear();
+                                         return;
+                                     }
+                                     self->queuedBytes.fetch_sub(self->writeQueue.front().size(), std::memory_order_relaxed);
+                                     self->writeQueue.pop_front();
+                                     if (!self->writeQueue.empty()) {
+                                         self->writeNext();
+                                     }
+                                 });
+    }
+
+    AsyncNetworkServer& server;
+    int clientId;
+    boost::asio::ip::tcp::socket socket;
+    std::array<char, sizeof(uint32_t)> header{};
+    std::vector<char> body;
+    std::deque<std::string> writeQueue;  // Front is being written
+    std::atomic<std::size_t> queuedBytes{0};  // writeQueue plus frames posted but not yet queued
+};
+
+AsyncNetworkServer::AsyncNetworkServer(int port, std::size_t threadCount)
+        : port(port),
+          threadCount(threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency())) {}
 
 AsyncNetworkServer::~AsyncNetworkServer() {
     stop();
@@ -12,7 +128,11 @@ AsyncNetworkServer::~AsyncNetworkServer() {
 
 bool AsyncNetworkServer::initialise() {
     try {
-        acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(ioContext);
+        contexts.clear();
+        for (std::size_t i = 0; i < threadCount; ++i) {
+            contexts.push_back(std::make_unique<boost::asio::io_context>(1));
+        }
+        acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(*contexts[0]);
         return true;
     } catch (const std::exception& e) {
         std::cerr << "AsyncNetworkServer::initialise - Exception: " << e.what() << std::endl;
@@ -23,14 +143,22 @@ bool AsyncNetworkServer::initialise() {
 bool AsyncNetworkServer::start() {
     try {
         acceptor = std::make_unique<boost::asio::ip::tcp::acceptor>(
-                ioContext,
+                *contexts[0],
                 boost::asio::ip::tcp::endpoint(boost::asio::ip::tcp::v4(), port)
         );
 
         running = true;
         doAccept();
 
-        ioThread = std::thread([this]() { ioContext.run(); });
+        for (std::size_t i = 0; i < contexts.size(); ++i) {
+            workGuards.push_back(boost::asio::make_work_guard(*contexts[i]));
+            ioThreads.emplace_back([this, i]() {
+                if (onThreadStart) {
+                    onThreadStart(i);
+                }
+                contexts[i]->run();
+            });
+        }
         return true;
     } catch (const std::exception& e) {
         std::cerr << "AsyncNetworkServer::start - Exception: " << e.what() << std::endl;
@@ -40,34 +168,58 @@ bool AsyncNetworkServer::start() {
 
 void AsyncNetworkServer::stop() {
     running = false;
-    ioContext.stop();
-    if (ioThread.joinable()) {
-        ioThread.join();
+    workGuards.clear();
+    for (auto& context : contexts) {
+        context->stop();
+    }
+    for (auto& thread : ioThreads) {
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
+    ioThreads.clear();
 
-    std::lock_guard<std::mutex> lock(clientMutex);
+    std::lock_guard<InstrumentedMutex> lock(clientMutex);
     clients.clear();
 }
 
-void AsyncNetworkServer::setOnMessage(std::function<void(int, const std::string&)> callback) {
+void AsyncNetworkServer::setOnMessage(std::function<void(int, std::string_view)> callback) {
     onMessage = std::move(callback);
 }
 
+void AsyncNetworkServer::setOnDisconnect(std::function<void(int)> callback) {
+    onDisconnect = std::move(callback);
+}
+
+void AsyncNetworkServer::setOnThreadStart(std::function<void(std::size_t)> callback) {
+    onThreadStart = std::move(callback);
+}
+
+bool AsyncNetworkServer::send(int clientId, const std::string& message, std::size_t maxQueuedBytes) {
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<InstrumentedMutex> lock(clientMutex);
+        auto it = clients.find(clientId);
+        if (it == clients.end()) return false;
+        session = it->second;
+    }
+    return session->send(message, maxQueuedBytes);
+}
+
 void AsyncNetworkServer::doAccept() {
-    auto socket = std::make_shared<boost::asio::ip::tcp::socket>(ioContext);
-    acceptor->async_accept(*socket, [this, socket](const boost::system::error_code& ec) {
+    // Each connection goes to the next io_context in turn
+    auto& context = *contexts[nextContext];
+    nextContext = (nextContext + 1) % contexts.size();
+
+    acceptor->async_accept(context, [this](const boost::system::error_code& ec, boost::asio::ip::tcp::socket socket) {
         if (!ec && running) {
             int clientId = nextClientId++;
-            ClientSession session;
-            session.socket = socket;
-            session.buffer.resize(sizeof(uint32_t));
-
+            auto session = std::make_shared<Session>(*this, clientId, std::move(socket));
             {
-                std::lock_guard<std::mutex> lock(clientMutex);
+                std::lock_guard<InstrumentedMutex> lock(clientMutex);
                 clients[clientId] = session;
             }
-
-            doRead(clientId);
+            session->start();
         }
 
         if (running) {
@@ -76,66 +228,18 @@ void AsyncNetworkServer::doAccept() {
     });
 }
 
-void AsyncNetworkServer::doRead(int clientId) {
-    std::lock_guard<std::mutex> lock(clientMutex);
-    auto it = clients.find(clientId);
-    if (it == clients.end()) return;
-
-    auto& session = it->second;
-    auto socket = session.socket;
-
-    // Step 1: Read message length (4 bytes)
-    boost::asio::async_read(*socket, boost::asio::buffer(session.buffer.data(), sizeof(uint32_t)),
-                            [this, clientId](const boost::system::error_code& ec, std::size_t) {
-                                if (ec) {
-                                    closeClient(clientId);
-                                    return;
-                                }
-
-                                std::lock_guard<std::mutex> lock(clientMutex);
-                                auto& session = clients[clientId];
-                                std::memcpy(&session.expectedLength, session.buffer.data(), sizeof(uint32_t));
-                                session.expectedLength = ntohl(session.expectedLength);
-                                session.buffer.resize(session.expectedLength);
-
-                                // Step 2: Read message body
-                                boost::asio::async_read(*session.socket, boost::asio::buffer(session.buffer.data(), session.expectedLength),
-                                                        [this, clientId](const boost::system::error_code& ec, std::size_t) {
-                                                            if (ec) {
-                                                                closeClient(clientId);
-                                                                return;
-                                                            }
-
-                                                            std::string message(clients[clientId].buffer.begin(), clients[clientId].buffer.end());
-                                                            if (onMessage) onMessage(clientId, message);
-
-                                                            doRead(clientId); // Wait for next message
-                                                        });
-                            });
-}
-
-void AsyncNetworkServer::doWrite(int clientId, const std::string& message) {
-    std::lock_guard<std::mutex> lock(clientMutex);
-    auto it = clients.find(clientId);
-    if (it == clients.end()) return;
-
-    auto socket = it->second.socket;
-    uint32_t len = htonl(static_cast<uint32_t>(message.size()));
-    std::vector<boost::asio::const_buffer> buffers = {
-            boost::asio::buffer(&len, sizeof(len)),
-            boost::asio::buffer(message)
-    };
-
-    boost::asio::async_write(*socket, buffers,
-                             [clientId](const boost::system::error_code& ec, std::size_t) {
-                                 if (ec) {
-                                     std::cerr << "Write failed for client " << clientId << ": " << ec.message() << std::endl;
-                                 }
-                             });
-}
-
 void AsyncNetworkServer::closeClient(int clientId) {
-    std::lock_guard<std::mutex> lock(clientMutex);
-    clients.erase(clientId);
+    std::shared_ptr<Session> session;
+    {
+        std::lock_guard<InstrumentedMutex> lock(clientMutex);
+        auto it = clients.find(clientId);
+        if (it == clients.end()) return;
+        session = std::move(it->second);
+        clients.erase(it);
+    }
+    session->close();
+    if (onDisconnect) {
+        onDisconnect(clientId);
+    }
     std::cout << "Client " << clientId << " disconnected." << std::endl;
 }
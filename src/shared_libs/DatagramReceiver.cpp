@@ -0,0 +1,127 @@
+// DatagramReceiver.cpp
+#include "DatagramReceiver.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    constexpr int POLL_TIMEOUT_MS = 100;        // How quickly stop() is noticed
+    constexpr int RECEIVE_BUFFER_BYTES = 4 << 20;
+}
+
+DatagramReceiver::DatagramReceiver(unsigned short port, std::string multicastGroup)
+        : port(port), multicastGroup(std::move(multicastGroup)) {}
+
+DatagramReceiver::~DatagramReceiver() {
+    stop();
+}
+
+void DatagramReceiver::setOnDatagram(std::function<void(std::string_view)> callback) {
+    onDatagram = std::move(callback);
+}
+
+void DatagramReceiver::setOnThreadStart(std::function<void()> callback) {
+    onThreadStart = std::move(callback);
+}
+
+bool DatagramReceiver::start() {
+    socketFd = ::socket(AF_INET, SOCK_DGRAM, 0);
+    if (socketFd < 0) {
+        std::cerr << "DatagramReceiver: socket failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int enable = 1;
+    ::setsockopt(socketFd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    int receiveBuffer = RECEIVE_BUFFER_BYTES;
+    ::setsockopt(socketFd, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    sockaddr_in address{};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(port);
+    if (::bind(socketFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "DatagramReceiver: bind to port " << port << " failed: " << std::strerror(errno) << std::endl;
+        ::close(socketFd);
+        socketFd = -1;
+        return false;
+    }
+
+    if (!multicastGroup.empty()) {
+        ip_mreq membership{};
+        if (::inet_pton(AF_INET, multicastGroup.c_str(), &membership.imr_multiaddr) != 1
+            || ::setsockopt(socketFd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+            std::cerr << "DatagramReceiver: cannot join multicast group " << multicastGroup << std::endl;
+            ::close(socketFd);
+            socketFd = -1;
+            return false;
+        }
+    }
+
+    buffers.assign(BATCH_SIZE * MAX_DATAGRAM_SIZE, 0);
+    running = true;
+    receiveThread = std::thread(&DatagramReceiver::receiveLoop, this);
+    return true;
+}
+
+void DatagramReceiver::stop() {
+    running = false;
+    if (receiveThread.joinable()) {
+        receiveThread.join();
+    }
+    if (socketFd >= 0) {
+        ::close(socketFd);
+        socketFd = -1;
+    }
+}
+
+void DatagramReceiver::receiveLoop() {
+    if (onThreadStart) {
+        onThreadStart();
+    }
+    mmsghdr messages[BATCH_SIZE];
+    iovec slots[BATCH_SIZE];
+    for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+        slots[i].iov_base = buffers.data() + i * MAX_DATAGRAM_SIZE;
+        slots[i].iov_len = MAX_DATAGRAM_SIZE;
+    }
+
+    pollfd readable{socketFd, POLLIN, 0};
+    while (running) {
+        int ready = ::poll(&readable, 1, POLL_TIMEOUT_MS);
+        if (ready <= 0) {
+            continue;
+        }
+
+        // Headers are reset each call because the kernel writes lengths and flags into them
+        std::memset(messages, 0, sizeof(messages));
+        for (std::size_t i = 0; i < BATCH_SIZE; ++i) {
+            messages[i].msg_hdr.msg_iov = &slots[i];
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int received = ::recvmmsg(socketFd, messages, BATCH_SIZE, MSG_DONTWAIT, nullptr);
+        if (received <= 0) {
+            if (received < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "DatagramReceiver: recvmmsg failed: " << std::strerror(errno) << std::endl;
+            }
+            continue;
+        }
+
+        receiveCalls.fetch_add(1, std::memory_order_relaxed);
+        datagramsReceived.fetch_add(static_cast<std::uint64_t>(received), std::memory_order_relaxed);
+        for (int i = 0; i < received; ++i) {
+            if (messages[i].msg_hdr.msg_flags & MSG_TRUNC) {
+                truncated.fetch_add(1, std::memory_order_relaxed);
+                continue;
+            }
+            if (onDatagram) {
+                onDatagram(std::string_view(static_cast<const char*>(slots[i].iov_base), messages[i].msg_len));
+            }
+        }
+    }
+}
@@ -0,0 +1,113 @@
+// InstrumentedMutex.cpp
+#include "InstrumentedMutex.h"
+#include "StatsRegistry.h"
+
+// ------------------------------------------------------------------------------------------------
+// LockStatistics
+// ------------------------------------------------------------------------------------------------
+void LockStatistics::recordUncontended() {
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+}
+
+void LockStatistics::recordContended(std::chrono::nanoseconds waited) {
+    auto waitNs = static_cast<std::uint64_t>(waited.count() > 0 ? waited.count() : 0);
+
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+    contended.fetch_add(1, std::memory_order_relaxed);
+    totalWaitNs.fetch_add(waitNs, std::memory_order_relaxed);
+
+    std::uint64_t previousMax = maxWaitNs.load(std::memory_order_relaxed);
+    while (waitNs > previousMax
+           && !maxWaitNs.compare_exchange_weak(previousMax, waitNs, std::memory_order_relaxed)) {}
+
+    std::size_t bucket = 0;
+    while (bucket + 1 < HISTOGRAM_BUCKETS && (waitNs >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+    waitHistogram[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+void LockStatistics::reset() {
+    acquisitions = 0;
+    contended = 0;
+    totalWaitNs = 0;
+    maxWaitNs = 0;
+    for (auto& bucket : waitHistogram) {
+        bucket = 0;
+    }
+}
+
+boost::json::object LockStatistics::toJson() const {
+    boost::json::object entry;
+    std::uint64_t acquired = acquisitions.load(std::memory_order_relaxed);
+    std::uint64_t waited = contended.load(std::memory_order_relaxed);
+    std::uint64_t waitNs = totalWaitNs.load(std::memory_order_relaxed);
+
+    entry["acquisitions"] = acquired;
+    entry["contended"] = waited;
+    entry["contention_ratio"] = acquired ? static_cast<double>(waited) / static_cast<double>(acquired) : 0.0;
+    entry["total_wait_ns"] = waitNs;
+    entry["mean_wait_ns"] = waited ? static_cast<double>(waitNs) / static_cast<double>(waited) : 0.0;
+    entry["max_wait_ns"] = maxWaitNs.load(std::memory_order_relaxed);
+
+    // Only emit populated buckets; "le_ns" is the exclusive upper bound of the bucket
+    boost::json::array histogram;
+    for (std::size_t i = 0; i < HISTOGRAM_BUCKETS; ++i) {
+        std::uint64_t count = waitHistogram[i].load(std::memory_order_relaxed);
+        if (count == 0) continue;
+        boost::json::object bucket;
+        bucket["le_ns"] = std::uint64_t{1} << (i + 1);
+        bucket["count"] = count;
+        histogram.push_back(std::move(bucket));
+    }
+    entry["wait_histogram"] = std::move(histogram);
+    return entry;
+}
+
+// ------------------------------------------------------------------------------------------------
+// LockRegistry
+// ------------------------------------------------------------------------------------------------
+LockRegistry& LockRegistry::instance() {
+    static LockRegistry registry;
+    return registry;
+}
+
+LockRegistry::LockRegistry() {
+    StatsRegistry::instance().registerProvider("locks", [this]() { return boost::json::value(snapshot()); });
+}
+
+LockStatistics& LockRegistry::statisticsFor(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    auto& statistics = locks[name];
+    if (!statistics) {
+        statistics = std::make_unique<LockStatistics>();
+    }
+    return *statistics;
+}
+
+boost::json::object LockRegistry::snapshot() const {
+    boost::json::object result;
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (const auto& [name, statistics] : locks) {
+        result[name] = statistics->toJson();
+    }
+    return result;
+}
+
+void LockRegistry::resetAll() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& [name, statistics] : locks) {
+        statistics->reset();
+    }
+}
+
+// ------------------------------------------------------------------------------------------------
+// InstrumentedMutex
+// ------------------------------------------------------------------------------------------------
+InstrumentedMutex::InstrumentedMutex(const std::string& name) {
+#ifdef AARNN_LOCK_PROFILING
+    statistics = &LockRegistry::instance().statisticsFor(name);
+#else
+    (void)name;
+#endif
+}
@@ -14,7 +14,7 @@ Logger::~Logger() {
 }
 
 Logger& Logger::operator<<(std::ostream& (*pf)(std::ostream&)) {
-    std::lock_guard<std::mutex> lock(log_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(log_mutex_);
     log_file_ << pf;
     log_file_.flush();
     return *this;
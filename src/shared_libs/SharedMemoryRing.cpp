@@ -0,0 +1,89 @@
+// SharedMemoryRing.cpp
+#include "SharedMemoryRing.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <iostream>
+#include <new>
+#include <utility>
+
+SharedMemoryRing::SharedMemoryRing(std::string name) : name(std::move(name)) {}
+
+SharedMemoryRing::~SharedMemoryRing() {
+    if (header && owner) {
+        header->closed.store(1, std::memory_order_release);
+        ::shm_unlink(name.c_str());
+    }
+    if (header) {
+        ::munmap(header, mappedBytes);
+    }
+}
+
+bool SharedMemoryRing::create(std::size_t requestedCapacity) {
+    capacity = 64;
+    while (capacity < requestedCapacity) {
+        capacity <<= 1;
+    }
+
+    int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        std::cerr << "SharedMemoryRing: cannot create " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    const std::size_t bytes = DATA_OFFSET + capacity;
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0 || !map(fd, bytes)) {
+        std::cerr << "SharedMemoryRing: cannot size " << name << ": " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        ::shm_unlink(name.c_str());
+        return false;
+    }
+    ::close(fd);
+
+    owner = true;
+    header = new (header) Header{};
+    header->magic = MAGIC;
+    header->version = VERSION;
+    header->capacity = capacity;
+    return true;
+}
+
+bool SharedMemoryRing::attach() {
+    int fd = ::shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat status{};
+    const bool mapped = ::fstat(fd, &status) == 0 && static_cast<std::size_t>(status.st_size) > DATA_OFFSET
+                        && map(fd, static_cast<std::size_t>(status.st_size));
+    ::close(fd);
+    if (!mapped) {
+        return false;
+    }
+
+    capacity = mappedBytes - DATA_OFFSET;
+    if (header->magic != MAGIC || header->version != VERSION || header->capacity != capacity
+        || (capacity & (capacity - 1)) != 0) {
+        std::cerr << "SharedMemoryRing: " << name << " is not a compatible ring." << std::endl;
+        ::munmap(header, mappedBytes);
+        header = nullptr;
+        return false;
+    }
+    return true;
+}
+
+bool SharedMemoryRing::isClosed() const {
+    return !header || header->closed.load(std::memory_order_acquire) != 0;
+}
+
+bool SharedMemoryRing::map(int fd, std::size_t bytes) {
+    void* address = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+    mappedBytes = bytes;
+    header = static_cast<Header*>(address);
+    data = static_cast<char*>(address) + DATA_OFFSET;
+    return true;
+}
@@ -0,0 +1,37 @@
+// StatsRegistry.cpp
+#include "StatsRegistry.h"
+#include <iostream>
+
+StatsRegistry& StatsRegistry::instance() {
+    static StatsRegistry registry;
+    return registry;
+}
+
+void StatsRegistry::registerProvider(const std::string& name, Provider provider) {
+    std::lock_guard<std::mutex> lock(providerMutex);
+    providers[name] = std::move(provider);
+}
+
+void StatsRegistry::unregisterProvider(const std::string& name) {
+    std::lock_guard<std::mutex> lock(providerMutex);
+    providers.erase(name);
+}
+
+boost::json::object StatsRegistry::snapshot() const {
+    // Copy the providers out so a slow provider never blocks registration
+    std::map<std::string, Provider> current;
+    {
+        std::lock_guard<std::mutex> lock(providerMutex);
+        current = providers;
+    }
+
+    boost::json::object result;
+    for (const auto& [name, provider] : current) {
+        try {
+            result[name] = provider();
+        } catch (const std::exception& e) {
+            std::cerr << "StatsRegistry::snapshot - Provider '" << name << "' failed: " << e.what() << std::endl;
+        }
+    }
+    return result;
+}
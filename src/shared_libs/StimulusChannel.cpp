@@ -0,0 +1,222 @@
+// StimulusChannel.cpp
+#include "StimulusChannel.h"
+#include "DatagramReceiver.h"
+#include <netdb.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <iostream>
+#include <utility>
+
+StimulusChannel::StimulusChannel(AsyncNetworkClient& client, std::string channel, StimulusFormat preferredFormat)
+        : client(client), channel(std::move(channel)), bankId(UNREGISTERED_BANK) {
+    if (const char* requested = std::getenv("STIMULUS_WIRE_FORMAT")) {
+        if (!parseStimulusFormat(requested, preferredFormat)) {
+            std::cerr << "StimulusChannel: unknown STIMULUS_WIRE_FORMAT '" << requested << "'; using "
+                      << stimulusFormatName(preferredFormat) << "." << std::endl;
+        }
+    }
+    if (preferredFormat == StimulusFormat::Json) {
+        refused = true;  // Never registers, so every message stays JSON
+        return;
+    }
+    if (const char* target = std::getenv("STIMULUS_UDP_TARGET")) {
+        openDatagramSocket(target);
+    }
+    if (const char* ringSize = std::getenv("STIMULUS_SHM_RING")) {
+        createRing(ringSize);
+    }
+    offeredFormats.push_back(preferredFormat);
+    for (auto fallback : {StimulusFormat::Float32, StimulusFormat::Float64, StimulusFormat::Float16}) {
+        if (fallback != preferredFormat) {
+            offeredFormats.push_back(fallback);
+        }
+    }
+}
+
+StimulusChannel::~StimulusChannel() {
+    if (datagramSocket >= 0) {
+        ::close(datagramSocket);
+    }
+}
+
+void StimulusChannel::openDatagramSocket(const std::string& target) {
+    const auto colonPos = target.rfind(':');
+    if (colonPos == std::string::npos) {
+        std::cerr << "StimulusChannel: STIMULUS_UDP_TARGET must be <host>:<port>, not '" << target << "'." << std::endl;
+        return;
+    }
+    const std::string host = target.substr(0, colonPos);
+    const std::string port = target.substr(colonPos + 1);
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* resolved = nullptr;
+    if (::getaddrinfo(host.c_str(), port.c_str(), &hints, &resolved) != 0 || !resolved) {
+        std::cerr << "StimulusChannel: cannot resolve UDP target " << target << "; using TCP." << std::endl;
+        return;
+    }
+    int fd = ::socket(resolved->ai_family, resolved->ai_socktype, resolved->ai_protocol);
+    if (fd >= 0 && ::connect(fd, resolved->ai_addr, resolved->ai_addrlen) == 0) {
+        datagramSocket = fd;
+    } else {
+        std::cerr << "StimulusChannel: cannot open UDP socket to " << target << "; using TCP." << std::endl;
+        if (fd >= 0) {
+            ::close(fd);
+        }
+    }
+    ::freeaddrinfo(resolved);
+}
+
+// Ring names are "/aarnn-<pid>-<channel>-<n>", the prefix the server accepts
+void StimulusChannel::createRing(const std::string& size) {
+    char* end = nullptr;
+    const unsigned long long bytes = std::strtoull(size.c_str(), &end, 10);
+    if (end == size.c_str() || *end != '\0') {
+        std::cerr << "StimulusChannel: STIMULUS_SHM_RING must be a size in bytes, not '" << size << "'." << std::endl;
+        return;
+    }
+    if (bytes == 0) {
+        return;
+    }
+
+    static std::atomic<unsigned> ringCounter{0};
+    std::string safeChannel = channel;
+    std::replace_if(safeChannel.begin(), safeChannel.end(),
+                    [](unsigned char c) { return !std::isalnum(c) && c != '-' && c != '_'; }, '_');
+    auto created = std::make_unique<SharedMemoryRing>(
+            "/aarnn-" + std::to_string(::getpid()) + "-" + safeChannel + "-"
+            + std::to_string(ringCounter.fetch_add(1, std::memory_order_relaxed)));
+    if (created->create(static_cast<std::size_t>(bytes))) {
+        ring = std::move(created);
+    } else {
+        std::cerr << "StimulusChannel: cannot create shared-memory ring for " << channel << "; using sockets."
+                  << std::endl;
+    }
+}
+
+// Also forgets the previous registration, so a channel reopened for a new connection
+// registers again rather than reusing an id the server has freed
+void StimulusChannel::open() {
+    bankId.store(UNREGISTERED_BANK, std::memory_order_release);
+    format.store(StimulusFormat::Json, std::memory_order_relaxed);
+    refused.store(offeredFormats.empty(), std::memory_order_relaxed);
+    channelId.store(0, std::memory_order_relaxed);
+    credits.store(0, std::memory_order_relaxed);
+    ringAttached.store(false, std::memory_order_release);
+    client.setOnMessage([this](const std::string& message) { onReply(message); });
+}
+
+bool StimulusChannel::send(const std::vector<double>& values, std::uint64_t captureMicros) {
+    const std::uint64_t timestamp = captureMicros != 0 ? captureMicros : stimulusClockMicros();
+    const std::int64_t id = bankId.load(std::memory_order_acquire);
+    const StimulusFormat wireFormat = format.load(std::memory_order_relaxed);
+    if (id >= 0 && wireFormat != StimulusFormat::Json) {
+        const std::uint32_t channel = channelId.load(std::memory_order_relaxed);
+
+        // Frames too large to ever fit the ring fall through to the sockets
+        const std::size_t batchSize = stimulusBatchSize(wireFormat, values.size());
+        if (ringAttached.load(std::memory_order_acquire) && batchSize <= ring->getCapacity() / 2) {
+            const bool written = ring->tryWrite(batchSize, [&](char* out) {
+                writeStimulusBatch(out, static_cast<std::uint32_t>(id), channel, wireFormat, timestamp, values);
+            });
+            if (written) {
+                bytesSent.fetch_add(batchSize, std::memory_order_relaxed);
+            } else {
+                throttledFrames.fetch_add(1, std::memory_order_relaxed);
+            }
+            return written;
+        }
+
+        const bool viaDatagram = datagramSocket >= 0
+                && batchSize + STIMULUS_DATAGRAM_HEADER_SIZE <= DatagramReceiver::MAX_DATAGRAM_SIZE;
+        if (!viaDatagram && channel != 0 && credits.fetch_sub(1, std::memory_order_acq_rel) <= 0) {
+            credits.fetch_add(1, std::memory_order_relaxed);
+            throttledFrames.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        std::string frame = serializeStimulusBatch(static_cast<std::uint32_t>(id), channel, wireFormat,
+                                                   timestamp, values);
+        if (viaDatagram) {
+            const std::uint32_t sequence = datagramSequence.fetch_add(1, std::memory_order_relaxed);
+            const std::string datagram = serializeStimulusDatagram(sequence, frame);
+            // A datagram the kernel refuses is simply lost, as it could be on the wire
+            ::send(datagramSocket, datagram.data(), datagram.size(), MSG_DONTWAIT);
+            bytesSent.fetch_add(datagram.size(), std::memory_order_relaxed);
+            return true;
+        }
+        const std::size_t frameSize = frame.size();
+        if (!client.send(std::move(frame))) {
+            // The client's queue is full; the frame never reaches the server, so neither does its credit
+            if (channel != 0) {
+                credits.fetch_add(1, std::memory_order_relaxed);
+            }
+            throttledFrames.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        bytesSent.fetch_add(frameSize, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (!refused.load(std::memory_order_relaxed)) {
+        client.send(serializeChannelRegistration(channel, offeredFormats, ring ? ring->getName() : std::string()));
+    }
+    StimuliData data;
+    data.receptorType = channel;
+    data.values = values;
+    data.timestampMicros = timestamp;
+    std::string message = serializeStimuliData(data);
+    const std::size_t messageSize = message.size();
+    if (!client.send(std::move(message))) {
+        return false;
+    }
+    bytesSent.fetch_add(messageSize, std::memory_order_relaxed);
+    return true;
+}
+
+void StimulusChannel::onReply(const std::string& message) {
+    std::uint32_t grantedChannel, granted;
+    if (parseStimulusCredit(message, grantedChannel, granted)) {
+        if (grantedChannel == channelId.load(std::memory_order_relaxed)) {
+            credits.fetch_add(granted, std::memory_order_acq_rel);
+        }
+        return;
+    }
+
+    try {
+        boost::json::value jv = boost::json::parse(message);
+        const auto& obj = jv.as_object();
+        const auto* registered = obj.if_contains("register");
+        const auto* id = obj.if_contains("bank");
+        if (!registered || !id || std::string(registered->as_string()) != channel) {
+            return;
+        }
+
+        StimulusFormat negotiated = StimulusFormat::Json;
+        if (const auto* name = obj.if_contains("format")) {
+            parseStimulusFormat(std::string(name->as_string()), negotiated);
+        }
+        if (id->as_int64() >= 0 && negotiated != StimulusFormat::Json) {
+            const auto* window = obj.if_contains("credits");
+            const auto* assigned = obj.if_contains("channel");
+            if (window && assigned) {
+                credits.store(window->as_int64(), std::memory_order_relaxed);
+                channelId.store(static_cast<std::uint32_t>(assigned->as_int64()), std::memory_order_relaxed);
+            }
+            if (const auto* attached = obj.if_contains("ring")) {
+                ringAttached.store(ring && attached->as_bool(), std::memory_order_release);
+            }
+            format.store(negotiated, std::memory_order_relaxed);
+            bankId.store(id->as_int64(), std::memory_order_release);
+        } else if (!refused.exchange(true, std::memory_order_relaxed)) {
+            std::cerr << "StimulusChannel: server accepted no binary stream for " << channel
+                      << "; sending JSON." << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "StimulusChannel: malformed reply: " << e.what() << std::endl;
+    }
+}
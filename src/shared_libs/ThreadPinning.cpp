@@ -0,0 +1,89 @@
+// ThreadPinning.cpp
+#include "ThreadPinning.h"
+
+#include <pthread.h>
+#include <sched.h>
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+bool parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    std::vector<int> parsed;
+    std::istringstream stream(text);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(),
+                                   [](unsigned char c) { return std::isspace(c) != 0; }),
+                    range.end());
+        if (range.empty()) {
+            continue;
+        }
+        try {
+            std::size_t used = 0;
+            const int first = std::stoi(range, &used);
+            int last = first;
+            if (used < range.size()) {
+                if (range[used] != '-') {
+                    return false;
+                }
+                const std::string upper = range.substr(used + 1);
+                last = std::stoi(upper, &used);
+                if (used != upper.size()) {
+                    return false;
+                }
+            }
+            if (first < 0 || last < first || last >= CPU_SETSIZE) {
+                return false;
+            }
+            for (int cpu = first; cpu <= last; ++cpu) {
+                parsed.push_back(cpu);
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    std::sort(parsed.begin(), parsed.end());
+    parsed.erase(std::unique(parsed.begin(), parsed.end()), parsed.end());
+    cpus = std::move(parsed);
+    return true;
+}
+
+std::string formatCpuList(const std::vector<int>& cpus) {
+    std::string text;
+    for (int cpu : cpus) {
+        text += (text.empty() ? "" : ",") + std::to_string(cpu);
+    }
+    return text;
+}
+
+bool pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool makeCurrentThreadRealtime(int priority) {
+    sched_param parameters{};
+    parameters.sched_priority = priority;
+    return pthread_setschedparam(pthread_self(), SCHED_FIFO, &parameters) == 0;
+}
+
+bool excludeCpusFromCurrentThread(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) {
+        return false;
+    }
+    for (int cpu : cpus) {
+        CPU_CLR(cpu, &set);
+    }
+    if (CPU_COUNT(&set) == 0) {
+        return false;  // Would leave the simulation nowhere to run
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
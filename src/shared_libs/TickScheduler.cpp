@@ -0,0 +1,193 @@
+// TickScheduler.cpp
+#include "TickScheduler.h"
+#include "StatsRegistry.h"
+#include <algorithm>
+#include <iostream>
+#include <thread>
+
+namespace {
+    constexpr double LOAD_SMOOTHING = 0.2;  // Weight of the newest tick in the smoothed load
+
+    double toSeconds(TickScheduler::Clock::duration duration) {
+        return std::chrono::duration<double>(duration).count();
+    }
+}
+
+TickScheduler::TickScheduler(const std::string& name, Clock::duration period)
+    : name(name), statsKey("scheduler." + name), period(period), stats(std::make_shared<Statistics>()) {
+    stats->periodSeconds = toSeconds(period);
+    // The provider keeps the statistics alive after the scheduler is gone, so the
+    // shutdown report still covers it; a new scheduler with the same name replaces it.
+    std::shared_ptr<Statistics> sharedStats = stats;
+    StatsRegistry::instance().registerProvider(statsKey, [sharedStats]() -> boost::json::value {
+        std::lock_guard<std::mutex> lock(sharedStats->mutex);
+        return sharedStats->toJson();
+    });
+}
+
+void TickScheduler::addPhase(Phase phase) {
+    if (phase.everyNTicks == 0) {
+        phase.everyNTicks = 1;
+    }
+    PhaseCounters counters;
+    counters.name = phase.name;
+    {
+        std::lock_guard<std::mutex> lock(stats->mutex);
+        stats->phases.push_back(std::move(counters));
+    }
+    PhaseState state;
+    state.phase = std::move(phase);
+    phases.push_back(std::move(state));
+}
+
+void TickScheduler::run(const std::atomic<bool>& running, std::uint64_t maxTicks) {
+    std::uint64_t ticksRun = 0;
+    while (running && (maxTicks == 0 || ticksRun < maxTicks)) {
+        tick();
+        ++ticksRun;
+    }
+}
+
+// Overloaded, a sheddable phase only runs once the ticks since its last run cover a
+// multiple of everyNTicks * SHED_FACTOR
+bool TickScheduler::isShed(const PhaseState& state) const {
+    if (!state.phase.sheddable || !overloaded) {
+        return false;
+    }
+    return tickIndex < state.nextUnshedTick;
+}
+
+void TickScheduler::tick() {
+    auto now = Clock::now();
+    if (!started) {
+        started = true;
+        nextDeadline = now;
+        for (auto& state : phases) {
+            state.lastRun = now - period * state.phase.everyNTicks;
+        }
+    }
+
+    if (now < nextDeadline) {
+        std::this_thread::sleep_until(nextDeadline);
+    }
+
+    const auto tickStart = Clock::now();
+    const double jitterSeconds = toSeconds(tickStart - nextDeadline);
+
+    for (auto& state : phases) {
+        state.ranThisTick = false;
+        state.shedThisTick = false;
+        state.secondsThisTick = 0.0;
+        // Due once the tick index reaches the next multiple, which skipped ticks may
+        // have stepped over
+        const std::uint64_t every = state.phase.everyNTicks;
+        if (tickIndex < state.nextDueTick) {
+            continue;
+        }
+        state.nextDueTick = (tickIndex / every + 1) * every;
+        if (isShed(state)) {
+            state.shedThisTick = true;
+            continue;
+        }
+
+        const std::uint64_t shedEvery = every * SHED_FACTOR;
+        state.nextUnshedTick = (tickIndex / shedEvery + 1) * shedEvery;
+        const auto phaseStart = Clock::now();
+        const double deltaTime = toSeconds(phaseStart - state.lastRun);
+        state.lastRun = phaseStart;
+        try {
+            state.phase.run(deltaTime);
+        } catch (const std::exception& e) {
+            std::cerr << "TickScheduler[" << name << "] - Phase '" << state.phase.name << "' failed: " << e.what()
+                      << std::endl;
+        }
+        state.ranThisTick = true;
+        state.secondsThisTick = toSeconds(Clock::now() - phaseStart);
+    }
+
+    const auto tickEnd = Clock::now();
+    const double workSeconds = toSeconds(tickEnd - tickStart);
+
+    // Advance the absolute deadline; if we are more than a whole period behind, drop
+    // the missed ticks rather than running them back to back to catch up.
+    nextDeadline += period;
+    const bool overrun = tickEnd > nextDeadline;
+    std::uint64_t skipped = 0;
+    if (overrun && tickEnd - nextDeadline >= period) {
+        skipped = static_cast<std::uint64_t>((tickEnd - nextDeadline) / period);
+        nextDeadline += period * skipped;
+    }
+    tickIndex += 1 + skipped;
+
+    const double load = workSeconds / toSeconds(period);
+    smoothedLoad = (1.0 - LOAD_SMOOTHING) * smoothedLoad + LOAD_SMOOTHING * load;
+    bool enteredOverload = false;
+    if (!overloaded && smoothedLoad > OVERLOAD_ENTER) {
+        overloaded = true;
+        enteredOverload = true;
+    } else if (overloaded && smoothedLoad < OVERLOAD_EXIT) {
+        overloaded = false;
+    }
+
+    publish(jitterSeconds, workSeconds, overrun, skipped, enteredOverload);
+}
+
+void TickScheduler::publish(double jitterSeconds, double workSeconds, bool overrun, std::uint64_t skipped,
+                            bool enteredOverload) {
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    stats->ticks++;
+    stats->overruns += overrun ? 1 : 0;
+    stats->skippedTicks += skipped;
+    stats->overloadEpisodes += enteredOverload ? 1 : 0;
+    stats->totalJitterSeconds += jitterSeconds;
+    stats->maxJitterSeconds = std::max(stats->maxJitterSeconds, jitterSeconds);
+    stats->totalWorkSeconds += workSeconds;
+    stats->maxWorkSeconds = std::max(stats->maxWorkSeconds, workSeconds);
+    stats->smoothedLoad = smoothedLoad;
+    stats->overloaded = overloaded;
+
+    for (std::size_t i = 0; i < phases.size(); ++i) {
+        const auto& state = phases[i];
+        auto& counters = stats->phases[i];
+        if (state.ranThisTick) {
+            counters.runs++;
+            counters.totalSeconds += state.secondsThisTick;
+            counters.maxSeconds = std::max(counters.maxSeconds, state.secondsThisTick);
+        } else if (state.shedThisTick) {
+            counters.shed++;
+        }
+    }
+}
+
+boost::json::object TickScheduler::statistics() const {
+    std::lock_guard<std::mutex> lock(stats->mutex);
+    return stats->toJson();
+}
+
+boost::json::object TickScheduler::Statistics::toJson() const {
+    // Caller holds mutex
+    boost::json::object entry;
+    entry["period_ms"] = periodSeconds * 1000.0;
+    entry["ticks"] = ticks;
+    entry["overruns"] = overruns;
+    entry["skipped_ticks"] = skippedTicks;
+    entry["mean_jitter_ms"] = ticks ? totalJitterSeconds * 1000.0 / static_cast<double>(ticks) : 0.0;
+    entry["max_jitter_ms"] = maxJitterSeconds * 1000.0;
+    entry["mean_work_ms"] = ticks ? totalWorkSeconds * 1000.0 / static_cast<double>(ticks) : 0.0;
+    entry["max_work_ms"] = maxWorkSeconds * 1000.0;
+    entry["load"] = smoothedLoad;
+    entry["overloaded"] = overloaded;
+    entry["overload_episodes"] = overloadEpisodes;
+
+    boost::json::object phaseEntries;
+    for (const auto& counters : phases) {
+        boost::json::object phase;
+        phase["runs"] = counters.runs;
+        phase["shed"] = counters.shed;
+        phase["mean_ms"] = counters.runs ? counters.totalSeconds * 1000.0 / static_cast<double>(counters.runs) : 0.0;
+        phase["max_ms"] = counters.maxSeconds * 1000.0;
+        phaseEntries[counters.name] = std::move(phase);
+    }
+    entry["phases"] = std::move(phaseEntries);
+    return entry;
+}
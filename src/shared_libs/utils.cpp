@@ -2,6 +2,7 @@
 // Created by pbisaacs on 24/06/24.
 //
 #include "utils.h"
+#include "DeterministicRandom.h"
 #include <algorithm>
 #include <iostream>
 #include <sstream>
@@ -53,8 +54,11 @@ std::tuple<double, double, double> generate_point_on_convex_hull(std::vector<std
     // Handle the case where there is only one prior tuple
     if (points.size() == 1) {
         // Place the new point on the unit sphere surface around the origin
-        double theta = 2 * M_PI * (std::rand() / (RAND_MAX + 1.0));  // Random angle theta
-        double phi = acos(1 - 2 * (std::rand() / (RAND_MAX + 1.0))); // Random angle phi
+        const auto& prior = points.front();
+        RandomStream rng(DeterministicRandom::Stream::ConvexHullPoint,
+                         DeterministicRandom::keyOf(std::get<0>(prior), std::get<1>(prior), std::get<2>(prior)));
+        double theta = 2 * M_PI * rng.uniform();  // Random angle theta
+        double phi = acos(1 - 2 * rng.uniform()); // Random angle phi
         double x = sin(phi) * cos(theta);
         double y = sin(phi) * sin(theta);
         double z = cos(phi);
@@ -156,21 +160,21 @@ void addDendriteBranchToRenderer(vtkRenderer *renderer,
                                  const vtkSmartPointer<vtkPoints> &points,
                                  const vtkSmartPointer<vtkIdList> &pointIds)
 {
-    const PositionPtr &dendriteBranchPosition = dendriteBranch->getPosition();
-    const PositionPtr &dendritePosition = dendrite->getPosition();
+    const Position &dendriteBranchPosition = dendriteBranch->getPosition();
+    const Position &dendritePosition = dendrite->getPosition();
 
     double radius1 = 0.5;
     double radius2 = 0.25;
 
-    double vectorX = dendritePosition->x - dendriteBranchPosition->x;
-    double vectorY = dendritePosition->y - dendriteBranchPosition->y;
-    double vectorZ = dendritePosition->z - dendriteBranchPosition->z;
+    double vectorX = dendritePosition.x - dendriteBranchPosition.x;
+    double vectorY = dendritePosition.y - dendriteBranchPosition.y;
+    double vectorZ = dendritePosition.z - dendriteBranchPosition.z;
 
     double length = std::sqrt(vectorX * vectorX + vectorY * vectorY + vectorZ * vectorZ);
 
-    double midpointX = (dendritePosition->x + dendriteBranchPosition->x) / 2.0;
-    double midpointY = (dendritePosition->y + dendriteBranchPosition->y) / 2.0;
-    double midpointZ = (dendritePosition->z + dendriteBranchPosition->z) / 2.0;
+    double midpointX = (dendritePosition.x + dendriteBranchPosition.x) / 2.0;
+    double midpointY = (dendritePosition.y + dendriteBranchPosition.y) / 2.0;
+    double midpointZ = (dendritePosition.z + dendriteBranchPosition.z) / 2.0;
 
     vtkSmartPointer<vtkConeSource> coneSource = vtkSmartPointer<vtkConeSource>::New();
     coneSource->SetRadius(radius1);
@@ -205,21 +209,21 @@ void addAxonBranchToRenderer(vtkRenderer *renderer,
                              const vtkSmartPointer<vtkPoints> &points,
                              const vtkSmartPointer<vtkIdList> &pointIds)
 {
-    const PositionPtr &axonBranchPosition = axonBranch->getPosition();
-    const PositionPtr &axonPosition = axon->getPosition();
+    const Position &axonBranchPosition = axonBranch->getPosition();
+    const Position &axonPosition = axon->getPosition();
 
     double radius1 = 0.5;
     double radius2 = 0.25;
 
-    double vectorX = axonPosition->x - axonBranchPosition->x;
-    double vectorY = axonPosition->y - axonBranchPosition->y;
-    double vectorZ = axonPosition->z - axonBranchPosition->z;
+    double vectorX = axonPosition.x - axonBranchPosition.x;
+    double vectorY = axonPosition.y - axonBranchPosition.y;
+    double vectorZ = axonPosition.z - axonBranchPosition.z;
 
     double length = std::sqrt(vectorX * vectorX + vectorY * vectorY + vectorZ * vectorZ);
 
-    double midpointX = (axonPosition->x + axonBranchPosition->x) / 2.0;
-    double midpointY = (axonPosition->y + axonBranchPosition->y) / 2.0;
-    double midpointZ = (axonPosition->z + axonBranchPosition->z) / 2.0;
+    double midpointX = (axonPosition.x + axonBranchPosition.x) / 2.0;
+    double midpointY = (axonPosition.y + axonBranchPosition.y) / 2.0;
+    double midpointZ = (axonPosition.z + axonBranchPosition.z) / 2.0;
 
     vtkSmartPointer<vtkConeSource> coneSource = vtkSmartPointer<vtkConeSource>::New();
     coneSource->SetRadius(radius1);
@@ -250,22 +254,24 @@ void addAxonBranchToRenderer(vtkRenderer *renderer,
 
 void addSynapticGapToRenderer(vtkRenderer *renderer, const std::shared_ptr<SynapticGap> &synapticGap)
 {
-    const PositionPtr &synapticGapPosition = synapticGap->getPosition();
+    const Position &synapticGapPosition = synapticGap->getPosition();
 
     vtkSmartPointer<vtkSphereSource> sphereSource = vtkSmartPointer<vtkSphereSource>::New();
     sphereSource->SetRadius(0.175);
 
     vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
 
+    RandomStream rng(DeterministicRandom::Stream::SynapticGapGlyph,
+                     DeterministicRandom::keyOf(synapticGapPosition.x, synapticGapPosition.y, synapticGapPosition.z));
     for(int i = 0; i < 8; ++i)
     {
-        double offsetX = distr(gen);
-        double offsetY = distr(gen);
-        double offsetZ = distr(gen);
+        double offsetX = rng.uniform(SYNAPTIC_GAP_GLYPH_OFFSET_MIN, SYNAPTIC_GAP_GLYPH_OFFSET_MAX);
+        double offsetY = rng.uniform(SYNAPTIC_GAP_GLYPH_OFFSET_MIN, SYNAPTIC_GAP_GLYPH_OFFSET_MAX);
+        double offsetZ = rng.uniform(SYNAPTIC_GAP_GLYPH_OFFSET_MIN, SYNAPTIC_GAP_GLYPH_OFFSET_MAX);
 
-        double x = synapticGapPosition->x + offsetX;
-        double y = synapticGapPosition->y + offsetY;
-        double z = synapticGapPosition->z + offsetZ;
+        double x = synapticGapPosition.x + offsetX;
+        double y = synapticGapPosition.y + offsetY;
+        double z = synapticGapPosition.z + offsetZ;
 
         points->InsertNextPoint(x, y, z);
     }
@@ -293,18 +299,18 @@ void addDendriteBranchPositionsToPolyData(vtkRenderer *renderer,
                                           const vtkSmartPointer<vtkPoints> &definePoints,
                                           vtkSmartPointer<vtkIdList> pointIDs)
 {
-    PositionPtr branchPosition = dendriteBranch->getPosition();
-    pointIDs->InsertNextId(definePoints->InsertNextPoint(branchPosition->x, branchPosition->y, branchPosition->z));
+    const Position &branchPosition = dendriteBranch->getPosition();
+    pointIDs->InsertNextId(definePoints->InsertNextPoint(branchPosition.x, branchPosition.y, branchPosition.z));
 
     const std::vector<std::shared_ptr<Dendrite>> &dendrites = dendriteBranch->getDendrites();
     for(const auto &dendrite: dendrites)
     {
-        PositionPtr dendritePosition = dendrite->getPosition();
+        const Position &dendritePosition = dendrite->getPosition();
         addDendriteBranchToRenderer(renderer, dendriteBranch, dendrite, definePoints, pointIDs);
 
         const std::shared_ptr<DendriteBouton> &bouton = dendrite->getDendriteBouton();
-        PositionPtr boutonPosition = bouton->getPosition();
-        pointIDs->InsertNextId(definePoints->InsertNextPoint(boutonPosition->x, boutonPosition->y, boutonPosition->z));
+        const Position &boutonPosition = bouton->getPosition();
+        pointIDs->InsertNextId(definePoints->InsertNextPoint(boutonPosition.x, boutonPosition.y, boutonPosition.z));
 
         const std::vector<std::shared_ptr<DendriteBranch>> &childBranches = dendrite->getDendriteBranches();
         for(const auto &childBranch: childBranches)
@@ -319,18 +325,18 @@ void addAxonBranchPositionsToPolyData(vtkRenderer *renderer,
                                       const vtkSmartPointer<vtkPoints> &definePoints,
                                       vtkSmartPointer<vtkIdList> pointIDs)
 {
-    PositionPtr branchPosition = axonBranch->getPosition();
-    pointIDs->InsertNextId(definePoints->InsertNextPoint(branchPosition->x, branchPosition->y, branchPosition->z));
+    const Position &branchPosition = axonBranch->getPosition();
+    pointIDs->InsertNextId(definePoints->InsertNextPoint(branchPosition.x, branchPosition.y, branchPosition.z));
 
     const std::vector<std::shared_ptr<Axon>> &axons = axonBranch->getAxons();
     for(const auto &axon: axons)
     {
-        PositionPtr axonPosition = axon->getPosition();
+        const Position &axonPosition = axon->getPosition();
         addAxonBranchToRenderer(renderer, axonBranch, axon, definePoints, pointIDs);
 
         const std::shared_ptr<AxonBouton> &axonBouton = axon->getAxonBouton();
-        PositionPtr axonBoutonPosition = axonBouton->getPosition();
-        pointIDs->InsertNextId(definePoints->InsertNextPoint(axonBoutonPosition->x, axonBoutonPosition->y, axonBoutonPosition->z));
+        const Position &axonBoutonPosition = axonBouton->getPosition();
+        pointIDs->InsertNextId(definePoints->InsertNextPoint(axonBoutonPosition.x, axonBoutonPosition.y, axonBoutonPosition.z));
 
         const std::shared_ptr<SynapticGap> &synapticGap = axonBouton->getSynapticGap();
         addSynapticGapToRenderer(renderer, synapticGap);
@@ -434,7 +440,7 @@ void associateSynapticGap(Neuron& neuron1, Neuron& neuron2, double proximityThre
 
         for (auto& dendriteBouton : neuron2.getDendriteBoutons()) {
             if (!dendriteBouton) continue;
-            if (gap->getPosition()->distanceTo(*(dendriteBouton->getPosition())) < proximityThreshold) {
+            if (gap->getPosition().distanceTo(dendriteBouton->getPosition()) < proximityThreshold) {
                 dendriteBouton->connectSynapticGap(gap);
                 gap->setAsAssociated();
                 break;
@@ -443,6 +449,35 @@ void associateSynapticGap(Neuron& neuron1, Neuron& neuron2, double proximityThre
     }
 }
 
+std::vector<SynapseCandidate> findSynapseCandidates(Neuron& neuron1, Neuron& neuron2, double proximityThreshold) {
+    std::vector<SynapseCandidate> candidates;
+    const auto gaps = neuron1.getSynapticGapsAxon();
+    const auto boutons = neuron2.getDendriteBoutons();
+    for (size_t g = 0; g < gaps.size(); ++g) {
+        if (!gaps[g]) continue;
+        for (size_t b = 0; b < boutons.size(); ++b) {
+            if (!boutons[b]) continue;
+            if (gaps[g]->getPosition().distanceTo(boutons[b]->getPosition()) < proximityThreshold) {
+                candidates.push_back({g, b});
+                break;
+            }
+        }
+    }
+    return candidates;
+}
+
+void applySynapseCandidates(Neuron& neuron1, Neuron& neuron2, const std::vector<SynapseCandidate>& candidates) {
+    if (candidates.empty()) return;
+    const auto gaps = neuron1.getSynapticGapsAxon();
+    const auto boutons = neuron2.getDendriteBoutons();
+    for (const auto& candidate : candidates) {
+        auto& gap = gaps[candidate.gap];
+        if (gap->isAssociated()) continue;
+        boutons[candidate.bouton]->connectSynapticGap(gap);
+        gap->setAsAssociated();
+    }
+}
+
 void associateSynapticGap(SensoryReceptor& receptor, Neuron& neuron, double proximityThreshold) {
     // Iterate over all SynapticGaps of receptor
     for (auto& gap : receptor.getSynapticGaps()) {
@@ -450,15 +485,12 @@ void associateSynapticGap(SensoryReceptor& receptor, Neuron& neuron, double prox
         if (gap && !gap->isAssociated()) {
             // Iterate over all DendriteBoutons in neuron
             for (auto& dendriteBouton : neuron.getDendriteBoutons()) {
-                std::cout << "Checking gap " << gap->getPosition() << " with dendrite bouton " << dendriteBouton->getPosition() << std::endl;
-
                 // If the distance between the gap and the dendriteBouton is below the proximity threshold
-                if (gap->getPosition()->distanceTo(*(dendriteBouton->getPosition())) < proximityThreshold) {
+                if (gap->getPosition().distanceTo(dendriteBouton->getPosition()) < proximityThreshold) {
                     // Associate the synaptic gap with the dendriteBouton
                     dendriteBouton->connectSynapticGap(gap);
                     // Set the SynapticGap as associated
                     gap->setAsAssociated();
-                    std::cout << "Associated gap " << gap->getPosition() << " with dendrite bouton " << dendriteBouton->getPosition() << std::endl;
                     // No need to check other DendriteBoutons once the gap is associated
                     break;
                 }
@@ -0,0 +1,240 @@
+// stimulus_load.cpp
+//
+// Load generator for the SensoryReceptorServer. Opens a number of producer
+// connections, each registering its own StimulusChannel, and sends frames at a fixed
+// rate over the normal framed protocol (so STIMULUS_WIRE_FORMAT, STIMULUS_UDP_TARGET
+// and STIMULUS_SHM_RING apply as for the real processors). Values are either
+// synthesised or replayed from a recording: one serialised StimuliData JSON object
+// per line, looped for the length of the run.
+//
+// At the end it reports what the producers achieved and asks the server for its
+// runtime statistics, printing the server-side ingest latency and the per-bank
+// ingest counters.
+//
+//   StimulusLoad [--host 127.0.0.1] [--port $SENSORY_SERVER_PORT] [--connections 4]
+//                [--rate 100] [--values 513] [--seconds 10] [--channel Auditory:load]
+//                [--replay recording.jsonl]
+
+#include "AsyncNetworkClient.h"
+#include "StimuliData.h"
+#include "StimulusChannel.h"
+
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    struct LoadOptions {
+        std::string host = "127.0.0.1";
+        unsigned short port = 0;
+        int connections = 4;
+        double rateHz = 100.0;     // Frames per second per connection
+        std::size_t values = 513;  // Synthesised frame size
+        double seconds = 10.0;
+        std::string channel = "Auditory:load";
+        std::string replayPath;
+    };
+
+    struct ProducerResult {
+        std::uint64_t attempted = 0;
+        std::uint64_t accepted = 0;
+        ClientWriteStatistics writes;
+        std::uint64_t throttled = 0;
+    };
+
+    void usage() {
+        std::cerr << "Usage: StimulusLoad [--host H] [--port P] [--connections N] [--rate HZ] [--values N]\n"
+                     "                    [--seconds S] [--channel Modality:id] [--replay FILE]" << std::endl;
+    }
+
+    bool parseOptions(int argc, char** argv, LoadOptions& options) {
+        if (const char* port = std::getenv("SENSORY_SERVER_PORT")) {
+            options.port = static_cast<unsigned short>(std::atoi(port));
+        }
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (i + 1 >= argc) {
+                return false;
+            }
+            const std::string value = argv[++i];
+            try {
+                if (arg == "--host") options.host = value;
+                else if (arg == "--port") options.port = static_cast<unsigned short>(std::stoi(value));
+                else if (arg == "--connections") options.connections = std::stoi(value);
+                else if (arg == "--rate") options.rateHz = std::stod(value);
+                else if (arg == "--values") options.values = static_cast<std::size_t>(std::stoul(value));
+                else if (arg == "--seconds") options.seconds = std::stod(value);
+                else if (arg == "--channel") options.channel = value;
+                else if (arg == "--replay") options.replayPath = value;
+                else return false;
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+        return options.port != 0 && options.connections > 0 && options.rateHz > 0.0 && options.seconds > 0.0;
+    }
+
+    std::vector<std::vector<double>> loadRecording(const std::string& path) {
+        std::vector<std::vector<double>> frames;
+        std::ifstream in(path);
+        std::string line;
+        while (std::getline(in, line)) {
+            if (line.empty()) {
+                continue;
+            }
+            try {
+                frames.push_back(deserializeStimuliData(line).values);
+            } catch (const std::exception& e) {
+                std::cerr << "Skipping malformed recording line: " << e.what() << std::endl;
+            }
+        }
+        return frames;
+    }
+
+    // A travelling wave, so successive frames differ the way real spectra do
+    std::vector<std::vector<double>> synthesise(std::size_t values, std::size_t frames) {
+        std::vector<std::vector<double>> result(frames, std::vector<double>(values));
+        for (std::size_t f = 0; f < frames; ++f) {
+            for (std::size_t i = 0; i < values; ++i) {
+                result[f][i] = 50.0 + 50.0 * std::sin(0.05 * static_cast<double>(i) + 0.3 * static_cast<double>(f));
+            }
+        }
+        return result;
+    }
+
+    // Paced send loop of one connection; frames that fall behind schedule are sent
+    // back to back rather than skipped, so the offered load is what was asked for
+    ProducerResult runProducer(const LoadOptions& options, int index, const std::vector<std::vector<double>>& frames,
+                               const std::atomic<bool>& stop) {
+        ProducerResult result;
+        AsyncNetworkClient client(options.host, options.port);
+        StimulusChannel channel(client, options.channel + "-" + std::to_string(index));
+        channel.open();
+        if (!client.connect()) {
+            return result;
+        }
+
+        const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double>(1.0 / options.rateHz));
+        auto next = std::chrono::steady_clock::now();
+        std::size_t frame = static_cast<std::size_t>(index) % frames.size();
+        while (!stop.load(std::memory_order_relaxed)) {
+            ++result.attempted;
+            if (channel.send(frames[frame])) {
+                ++result.accepted;
+            }
+            frame = (frame + 1) % frames.size();
+            next += period;
+            std::this_thread::sleep_until(next);
+        }
+        // Let the queued frames drain before the connection goes away
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        result.writes = client.getWriteStatistics();
+        result.throttled = channel.getThrottledFrames();
+        client.disconnect();
+        return result;
+    }
+
+    // Asks the server for its runtime statistics on a separate connection
+    bool fetchServerStatistics(const LoadOptions& options, boost::json::object& stats) {
+        AsyncNetworkClient client(options.host, options.port);
+        std::mutex replyMutex;
+        std::condition_variable replied;
+        std::string reply;
+        client.setOnMessage([&](const std::string& message) {
+            std::lock_guard<std::mutex> lock(replyMutex);
+            reply = message;
+            replied.notify_one();
+        });
+        if (!client.connect()) {
+            return false;
+        }
+        client.send("{\"stats\":true}");
+
+        std::unique_lock<std::mutex> lock(replyMutex);
+        const bool received = replied.wait_for(lock, std::chrono::seconds(5), [&] { return !reply.empty(); });
+        lock.unlock();
+        client.disconnect();
+        if (!received) {
+            return false;
+        }
+        try {
+            boost::json::value jv = boost::json::parse(reply);
+            stats = jv.as_object().at("stats").as_object();
+            return true;
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    LoadOptions options;
+    if (!parseOptions(argc, argv, options)) {
+        usage();
+        return 1;
+    }
+
+    std::vector<std::vector<double>> frames = options.replayPath.empty()
+            ? synthesise(options.values, 64)
+            : loadRecording(options.replayPath);
+    if (frames.empty()) {
+        std::cerr << "No frames to send." << std::endl;
+        return 1;
+    }
+
+    std::cout << "Sending " << options.rateHz << " frames/s on each of " << options.connections << " connections for "
+              << options.seconds << " s (" << frames[0].size() << " values per frame)." << std::endl;
+
+    std::atomic<bool> stop{false};
+    std::vector<ProducerResult> results(options.connections);
+    std::vector<std::thread> producers;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.connections; ++i) {
+        producers.emplace_back([&, i]() { results[i] = runProducer(options, i, frames, stop); });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(options.seconds));
+    stop = true;
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    ProducerResult total;
+    for (const auto& result : results) {
+        total.attempted += result.attempted;
+        total.accepted += result.accepted;
+        total.throttled += result.throttled;
+        total.writes.framesSent += result.writes.framesSent;
+        total.writes.framesDropped += result.writes.framesDropped;
+        total.writes.bytesSent += result.writes.bytesSent;
+        total.writes.writes += result.writes.writes;
+    }
+    const double seconds = elapsed.count();
+    std::cout << "Offered:   " << total.attempted << " frames (" << total.attempted / seconds << " frames/s)\n"
+              << "Accepted:  " << total.accepted << " frames (" << total.accepted / seconds << " frames/s)\n"
+              << "Throttled: " << total.throttled << " frames (credit, ring or queue limits)\n"
+              << "TCP:       " << total.writes.framesSent << " frames, " << total.writes.bytesSent << " bytes in "
+              << total.writes.writes << " writes, " << total.writes.framesDropped << " dropped" << std::endl;
+
+    boost::json::object stats;
+    if (!fetchServerStatistics(options, stats)) {
+        std::cerr << "Server statistics unavailable." << std::endl;
+        return 0;
+    }
+    for (const char* section : {"sensory_latency", "ingest", "sensory_udp", "sensory_shm"}) {
+        if (const auto* value = stats.if_contains(section)) {
+            std::cout << section << ": " << boost::json::serialize(*value) << std::endl;
+        }
+    }
+    return 0;
+}
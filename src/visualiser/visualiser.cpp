@@ -15,11 +15,13 @@
 #include "visualiser.h"
 #include "Logger.h" // Assumed to be a custom logging utility
 #include "wss.h"    // Assumed to be a WebSocket server utility
+#include "TickScheduler.h"
 
 #include <iostream>
 #include <memory>
 #include <thread>
 #include <mutex>
+#include <atomic>
 #include <chrono>
 #include <string>
 #include <stdexcept>
@@ -58,7 +60,7 @@ namespace {
     class VTKErrorObserver : public vtkCommand {
     public:
         static VTKErrorObserver* New() { return new VTKErrorObserver(); }
-        void Execute(vtkObject* caller, unsigned long eventId, void* callData) override {
+        void Execute(vtkObject* /*caller*/, unsigned long eventId, void* callData) override {
             if (eventId == vtkCommand::ErrorEvent || eventId == vtkCommand::WarningEvent) {
                 const char* msg = static_cast<char*>(callData);
                 std::cerr << "[VTK] " << msg << std::endl;
@@ -81,12 +83,10 @@ namespace {
     public:
         static UpdateTimerCallback* New() { return new UpdateTimerCallback; }
         void SetVisualiser(Visualiser* vis) { vis_ = vis; }
-        void Execute(vtkObject* caller, unsigned long eventId, void* /*callData*/) override {
+        void Execute(vtkObject* /*caller*/, unsigned long eventId, void* /*callData*/) override {
             if (eventId != vtkCommand::TimerEvent || !vis_) return;
+            // The timer is already repeating; creating another one here would add a timer per frame
             vis_->buildAndRenderFrame();
-            if (auto* iren = dynamic_cast<vtkRenderWindowInteractor*>(caller)) {
-                iren->CreateRepeatingTimer(vis_->getUpdateInterval());
-            }
         }
     private:
         Visualiser* vis_ = nullptr;
@@ -169,14 +169,16 @@ void Visualiser::visualise() {
     std::thread([this]() {
         logger_ << "Headless loop: entering periodic buildAndRenderFrame every "
                 << update_interval_ms_ << " ms.\n";
-        while (true) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(update_interval_ms_));
+        std::atomic<bool> forever(true);
+        TickScheduler scheduler("visualiser", std::chrono::milliseconds(update_interval_ms_));
+        scheduler.addPhase({"build_frame", [this](double) {
             try {
                 buildAndRenderFrame();
             } catch (const std::exception& e) {
                 logger_ << "Error in periodic buildAndRenderFrame: " << e.what() << "\n";
             }
-        }
+        }});
+        scheduler.run(forever);
     }).detach();
 
     // Keep the main thread alive indefinitely so the process does not exit.
@@ -766,6 +768,17 @@ int main(int argc, char** argv) {
 
         // 5. Create and run the Visualiser instance
         Visualiser vis(conn, logger, ws_server);
+        if (auto it = config.find("update_interval_ms"); it != config.end()) {
+            try {
+                int interval_ms = std::stoi(it->second);
+                if (interval_ms > 0) {
+                    vis.setUpdateInterval(interval_ms);
+                }
+            } catch (const std::exception&) {
+                logger << "Ignoring invalid update_interval_ms: " << it->second << "\n";
+            }
+        }
+        logger << "Update interval: " << vis.getUpdateInterval() << " ms.\n";
         vis.visualise();
 
         // 6. Clean up after visualise() returns (window is closed)
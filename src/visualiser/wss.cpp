@@ -4,12 +4,12 @@
 WebSocketServer::WebSocketServer() {
     ws_server_.init_asio();
     ws_server_.set_open_handler([this](websocketpp::connection_hdl hdl) {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
         connections_.insert(hdl);
         std::cout << "[WS] Client connected\n";
     });
     ws_server_.set_close_handler([this](websocketpp::connection_hdl hdl) {
-        std::lock_guard<std::mutex> lock(conn_mutex_);
+        std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
         connections_.erase(hdl);
         std::cout << "[WS] Client disconnected\n";
     });
@@ -22,7 +22,7 @@ void WebSocketServer::run(uint16_t port) {
 }
 
 void WebSocketServer::broadcast(const std::string& message) {
-    std::lock_guard<std::mutex> lock(conn_mutex_);
+    std::lock_guard<InstrumentedMutex> lock(conn_mutex_);
     for (auto hdl : connections_) {
         ws_server_.send(hdl, message, websocketpp::frame::opcode::text);
     }